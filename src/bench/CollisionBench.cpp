@@ -0,0 +1,109 @@
+// Tile collision query benchmark.
+//
+// Usage: collision_bench [queries] [ticks]
+// Runs `queries` entity-sized rect tests per tick (default 10k) against a
+// 128x128 map, once through rectCollidesSolid() per rect and once through
+// the batch rectsCollideSolid(), checks both agree with a plain layer
+// lookup, and reports time per tick.
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "TileMap.h"
+
+namespace
+{
+    // Independent answer straight from the collision layer.
+    bool referenceHit(const zelda::game::TileMap& map, const SDL_Rect& r)
+    {
+        using zelda::game::TileMap;
+        const int x0 = r.x / TileMap::TILE_SIZE, x1 = (r.x + r.w - 1) / TileMap::TILE_SIZE;
+        const int y0 = r.y / TileMap::TILE_SIZE, y1 = (r.y + r.h - 1) / TileMap::TILE_SIZE;
+        for (int ty = y0; ty <= y1; ++ty)
+            for (int tx = x0; tx <= x1; ++tx)
+                if (tx < 0 || ty < 0 || tx >= map.width() || ty >= map.height() ||
+                    map.getTile(zelda::game::TileLayer::Collision, tx, ty) != 0)
+                    return true;
+        return false;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    using Clock = std::chrono::steady_clock;
+    using zelda::game::TileMap;
+
+    const int queries = (argc > 1) ? std::atoi(argv[1]) : 10000;
+    const int ticks   = (argc > 2) ? std::atoi(argv[2]) : 1000;
+    const int mapW = 128, mapH = 128;
+
+    // ~20% walls, border walls
+    std::mt19937 rng(42);
+    std::vector<int> tiles(mapW * mapH, 0);
+    for (int y = 0; y < mapH; ++y)
+        for (int x = 0; x < mapW; ++x)
+            if (x == 0 || y == 0 || x == mapW - 1 || y == mapH - 1 || rng() % 5 == 0)
+                tiles[y * mapW + x] = 1;
+    TileMap map(mapW, mapH, tiles);
+
+    // entity-sized boxes, a few poking off the map, a few big ones
+    std::uniform_int_distribution<int> posX(-32, mapW * TileMap::TILE_SIZE + 32);
+    std::uniform_int_distribution<int> posY(-32, mapH * TileMap::TILE_SIZE + 32);
+    std::uniform_int_distribution<int> size(4, 16);
+    std::vector<SDL_Rect> rects(queries);
+    for (int i = 0; i < queries; ++i)
+    {
+        rects[i] = SDL_Rect{posX(rng), posY(rng), size(rng), size(rng)};
+        if (i % 64 == 0)
+            rects[i].w = rects[i].h = 48;
+    }
+
+    const std::size_t words = (queries + 63) / 64;
+    std::vector<std::uint64_t> maskBatch(words), maskScalar(words);
+
+    // correctness first
+    map.rectsCollideSolid(rects.data(), rects.size(), maskBatch.data());
+    int hits = 0;
+    for (int i = 0; i < queries; ++i)
+    {
+        const bool ref = referenceHit(map, rects[i]);
+        const bool batch = (maskBatch[i / 64] >> (i % 64)) & 1;
+        if (ref != batch || ref != map.rectCollidesSolid(rects[i]))
+        {
+            std::printf("MISMATCH at query %d\n", i);
+            return 1;
+        }
+        hits += ref;
+    }
+
+    // one query at a time
+    auto start = Clock::now();
+    for (int t = 0; t < ticks; ++t)
+    {
+        std::fill(maskScalar.begin(), maskScalar.end(), 0);
+        for (int i = 0; i < queries; ++i)
+            if (map.rectCollidesSolid(rects[i]))
+                maskScalar[i / 64] |= std::uint64_t{1} << (i % 64);
+    }
+    auto mid = Clock::now();
+
+    // batched
+    for (int t = 0; t < ticks; ++t)
+        map.rectsCollideSolid(rects.data(), rects.size(), maskBatch.data());
+    auto end = Clock::now();
+
+    const double scalarMs = std::chrono::duration<double, std::milli>(mid - start).count() / ticks;
+    const double batchMs  = std::chrono::duration<double, std::milli>(end - mid).count() / ticks;
+
+    std::printf("kernel:            %s\n", TileMap::collisionKernelName());
+    std::printf("queries / tick:    %d (%d hit)\n", queries, hits);
+    std::printf("ticks:             %d\n", ticks);
+    std::printf("per rect:          %.4f ms / tick\n", scalarMs);
+    std::printf("batched:           %.4f ms / tick\n", batchMs);
+    std::printf("speedup:           %.2fx\n", batchMs > 0.0 ? scalarMs / batchMs : 0.0);
+    return maskScalar == maskBatch ? 0 : 1;
+}
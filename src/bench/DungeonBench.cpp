@@ -0,0 +1,211 @@
+// Procedural dungeon generation benchmark.
+//
+// Usage: dungeon_bench [rooms] [threads] [seed]
+// Lays out a square dungeon of at least `rooms` rooms (default 10k),
+// carves every room once on one thread and once on `threads` threads
+// (default: one per core; skipped if that's 1), and reports rooms / sec
+// for each.
+// Also checks that the output is bit-identical across thread counts and
+// generation order, that every room is reachable from the start room and
+// that every door / spawn inside a room is reachable from its other doors.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "DungeonGenerator.h"
+#include "TileMap.h"
+
+namespace
+{
+    using namespace zelda::game;
+
+    std::uint64_t hashAll(const std::vector<RoomData>& rooms)
+    {
+        std::uint64_t h = 0;
+        for (const RoomData& room : rooms)
+            h = h * 0x100000001B3ull ^ DungeonGenerator::hashRoom(room);
+        return h;
+    }
+
+    // every room reachable from the start room, doors match on both sides
+    bool checkGraph(const DungeonGenerator& gen)
+    {
+        const int gw = gen.config().gridW, gh = gen.config().gridH;
+        const auto north = DungeonGenerator::doorBit(RoomDir::North);
+        const auto south = DungeonGenerator::doorBit(RoomDir::South);
+        const auto west  = DungeonGenerator::doorBit(RoomDir::West);
+        const auto east  = DungeonGenerator::doorBit(RoomDir::East);
+
+        for (int y = 0; y < gh; ++y)
+            for (int x = 0; x < gw; ++x)
+            {
+                const std::uint8_t d = gen.doors(x, y);
+                if (((d & north) != 0) != (y > 0 && (gen.doors(x, y - 1) & south)) ||
+                    ((d & west) != 0) != (x > 0 && (gen.doors(x - 1, y) & east)) ||
+                    ((d & south) && y == gh - 1) || ((d & east) && x == gw - 1))
+                {
+                    std::printf("door mismatch at room %d,%d\n", x, y);
+                    return false;
+                }
+            }
+
+        std::vector<std::uint8_t> seen(static_cast<std::size_t>(gw) * gh, 0);
+        std::vector<int> stack{gen.startY() * gw + gen.startX()};
+        seen[stack.back()] = 1;
+        std::size_t reached = 1;
+        while (!stack.empty())
+        {
+            const int i = stack.back();
+            stack.pop_back();
+            const int x = i % gw, y = i / gw;
+            const std::uint8_t d = gen.doors(x, y);
+            const int next[4] = {
+                (d & north) ? i - gw : -1, (d & south) ? i + gw : -1,
+                (d & west) ? i - 1 : -1, (d & east) ? i + 1 : -1};
+            for (int n : next)
+                if (n >= 0 && !seen[n])
+                {
+                    seen[n] = 1;
+                    ++reached;
+                    stack.push_back(n);
+                }
+        }
+        if (reached != seen.size())
+        {
+            std::printf("only %zu of %zu rooms reachable\n", reached, seen.size());
+            return false;
+        }
+        return true;
+    }
+
+    // flood fill from the first door (or spawn) reaches all door gaps and spawns
+    bool checkRoom(const RoomData& room)
+    {
+        const int w = room.width, h = room.height;
+        std::vector<SDL_Point> targets;
+        for (const TriggerDef& def : room.triggers)
+        {
+            const int tx = std::clamp((def.rect.x + def.rect.w / 2) / TileMap::TILE_SIZE, 0, w - 1);
+            const int ty = std::clamp((def.rect.y + def.rect.h / 2) / TileMap::TILE_SIZE, 0, h - 1);
+            targets.push_back(SDL_Point{tx, ty});
+        }
+        for (const SpawnPoint& s : room.spawns)
+            targets.push_back(SDL_Point{s.tx, s.ty});
+        if (targets.empty())
+            return true;
+
+        std::vector<std::uint8_t> seen(room.tiles.size(), 0);
+        std::vector<int> stack{targets[0].y * w + targets[0].x};
+        if (room.tiles[stack.back()] != 0)
+            return false;
+        seen[stack.back()] = 1;
+        while (!stack.empty())
+        {
+            const int i = stack.back();
+            stack.pop_back();
+            const int x = i % w, y = i / w;
+            const int next[4] = {
+                y > 0 ? i - w : -1, y < h - 1 ? i + w : -1,
+                x > 0 ? i - 1 : -1, x < w - 1 ? i + 1 : -1};
+            for (int n : next)
+                if (n >= 0 && !seen[n] && room.tiles[n] == 0)
+                {
+                    seen[n] = 1;
+                    stack.push_back(n);
+                }
+        }
+        for (const SDL_Point& p : targets)
+            if (!seen[p.y * w + p.x])
+                return false;
+        return true;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    using Clock = std::chrono::steady_clock;
+
+    const int rooms = (argc > 1) ? std::max(1, std::atoi(argv[1])) : 10000;
+    unsigned threads = (argc > 2) ? static_cast<unsigned>(std::atoi(argv[2])) : 0;
+    const std::uint64_t seed = (argc > 3) ? std::strtoull(argv[3], nullptr, 10) : 1;
+    if (threads == 0)
+        threads = std::max(1u, std::thread::hardware_concurrency());
+
+    DungeonConfig config;
+    config.seed = seed;
+    config.gridW = static_cast<int>(std::ceil(std::sqrt(static_cast<double>(rooms))));
+    config.gridH = (rooms + config.gridW - 1) / config.gridW;
+
+    auto start = Clock::now();
+    DungeonGenerator gen(config);
+    auto laidOut = Clock::now();
+
+    // one thread, then `threads` (once: they're the same run on a single core)
+    std::vector<unsigned> sweep{1u, threads};
+    std::sort(sweep.begin(), sweep.end());
+    sweep.erase(std::unique(sweep.begin(), sweep.end()), sweep.end());
+
+    std::vector<RoomData> serial, parallel;
+    std::vector<double> carveMs;
+    auto carveStart = Clock::now();
+    for (unsigned n : sweep)
+    {
+        std::vector<RoomData>& out = n == 1 ? serial : parallel;
+        gen.generateRooms(0, gen.roomCount(), out, n);
+        const auto done = Clock::now();
+        carveMs.push_back(std::chrono::duration<double, std::milli>(done - carveStart).count());
+        carveStart = done;
+    }
+
+    // same seed, fresh generator, rooms made lazily back to front
+    DungeonGenerator again(config);
+    std::uint64_t lazyHash = 0;
+    {
+        std::vector<RoomData> lazy(gen.roomCount());
+        for (int i = gen.roomCount() - 1; i >= 0; --i)
+            again.generateRoom(i % config.gridW, i / config.gridW, lazy[i]);
+        lazyHash = hashAll(lazy);
+    }
+
+    const std::uint64_t serialHash = hashAll(serial);
+    const std::uint64_t parallelHash = sweep.size() > 1 ? hashAll(parallel) : serialHash;
+    const bool identical = serialHash == parallelHash && serialHash == lazyHash;
+    bool ok = identical && checkGraph(gen);
+
+    std::size_t doors = 0, spawns = 0, badRooms = 0;
+    for (const RoomData& room : serial)
+    {
+        doors += room.triggers.size();
+        spawns += room.spawns.size();
+        if (!checkRoom(room))
+            ++badRooms;
+    }
+    ok = ok && badRooms == 0;
+
+    const double layoutMs   = std::chrono::duration<double, std::milli>(laidOut - start).count();
+    const int count = gen.roomCount();
+
+    std::printf("seed:              %llu\n", static_cast<unsigned long long>(seed));
+    std::printf("rooms:             %d (%dx%d grid, %dx%d tiles each)\n", count, config.gridW, config.gridH,
+                gen.config().roomTilesW, gen.config().roomTilesH);
+    std::printf("doors / spawns:    %zu / %zu\n", doors, spawns);
+    std::printf("layout:            %.2f ms\n", layoutMs);
+    for (std::size_t i = 0; i < sweep.size(); ++i)
+    {
+        std::printf("carve, %u thread%s %s%.2f ms (%.0f rooms / sec)\n", sweep[i], sweep[i] == 1 ? ": " : "s:",
+                    sweep[i] < 10 ? " " : "", carveMs[i], carveMs[i] > 0.0 ? count * 1000.0 / carveMs[i] : 0.0);
+    }
+    if (sweep.size() > 1)
+        std::printf("speedup:           %.2fx\n", carveMs.back() > 0.0 ? carveMs.front() / carveMs.back() : 0.0);
+    std::printf("output hash:       %016llx (%s)\n", static_cast<unsigned long long>(serialHash),
+                identical ? "identical across threads / order" : "MISMATCH");
+    if (badRooms)
+        std::printf("rooms with unreachable doors / spawns: %zu\n", badRooms);
+    return ok ? 0 : 1;
+}
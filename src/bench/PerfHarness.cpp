@@ -0,0 +1,917 @@
+// Scenario performance harness.
+//
+// Usage: perf_harness [--scenario NAME] [--ticks N] [--repeat N] [--out FILE]
+//                     [--baseline FILE] [--write-baseline FILE]
+//                     [--tolerance GROUP=REL[:ABS]]...
+//
+// Runs scripted scenarios headlessly: the real World, the real
+// WorldRenderer + RenderQueue drawing into a software renderer (320x240,
+// same as the game's scene target). For every scenario it collects
+// update and render time per tick, heap allocations made in update /
+// render, and live heap size, and writes percentiles as JSON. Each
+// scenario runs --repeat times (default 3); timings are the best run's,
+// since noise only ever adds time.
+//
+// With --baseline it compares against a committed results file and exits
+// with 1 when any metric is worse than  baseline * (1 + rel) + abs.
+// For timings abs is at least the measured timer noise, so the gate is
+// relative everywhere the timer can resolve; p95 timings use the wider
+// "tick_us_tail" / "render_us_tail" groups. Tolerances come from the
+// baseline's "tolerances" object and can be overridden per group on the
+// command line (e.g. --tolerance tick_us=0.3:0.1).
+//
+// The workload (rooms entered, kills, draws per frame) has to match the
+// baseline exactly: a change that alters a scenario re-records the
+// baseline in the same commit. render_us is only compared when both runs
+// came from a renderer that really draws (a stub / dummy SDL accepts
+// every call and draws nothing), and an optimized build is never
+// compared against an unoptimized one.
+// --write-baseline writes this run plus the tolerances in use. Given
+// with --baseline (the same file) it keeps the slower timing of the two:
+// this VM-class hardware lands in a fast or a slow state per process, up
+// to 2x apart on the sub-us scenarios, so record a few times on top of
+// each other rather than trusting one lucky run.
+
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "AllocTracker.h"
+#include "Hud.h"
+#include "ParticleSystem.h"
+#include "RenderQueue.h"
+#include "TextureManager.h"
+#include "World.h"
+#include "WorldRenderer.h"
+
+using namespace zelda::game;
+
+namespace
+{
+    constexpr int VIEW_W = 320;
+    constexpr int VIEW_H = 240;
+    constexpr int WARMUP_TICKS = 120; // same warm-up the engine gives itself
+
+    // --- scenarios ---
+
+    struct Pilot
+    {
+        int tick = 0;
+        int roomsEntered = 0;
+    };
+
+    struct Scenario
+    {
+        const char* name;
+        int roomTilesW;
+        int roomTilesH;
+        void (*setup)(World&);
+        WorldInput (*input)(const World&, Pilot&);
+    };
+
+    void noSetup(World&) {}
+
+    WorldInput idleInput(const World&, Pilot&) { return WorldInput{}; }
+
+    // 1000 enemies packed into one room, player runs in circles swinging
+    void brawlSetup(World& world)
+    {
+        const TileMap& map = world.rooms().currentMap();
+        const int spanX = map.width() * TileMap::TILE_SIZE - 2 * TileMap::TILE_SIZE - Enemy::WIDTH;
+        const int spanY = map.height() * TileMap::TILE_SIZE - 2 * TileMap::TILE_SIZE - Enemy::HEIGHT;
+
+        std::uint32_t rng = 12345u;
+        for (int i = 0; i < 1000; ++i)
+        {
+            rng = rng * 1664525u + 1013904223u;
+            const float x = TileMap::TILE_SIZE + static_cast<float>((rng >> 8) % spanX);
+            rng = rng * 1664525u + 1013904223u;
+            const float y = TileMap::TILE_SIZE + static_cast<float>((rng >> 8) % spanY);
+            world.spawnEnemy(x, y);
+        }
+    }
+
+    WorldInput brawlInput(const World&, Pilot& pilot)
+    {
+        WorldInput in;
+        switch ((pilot.tick / 30) % 4)
+        {
+            case 0: in.right = true; break;
+            case 1: in.down  = true; break;
+            case 2: in.left  = true; break;
+            case 3: in.up    = true; break;
+        }
+        in.attack = true; // as often as the cooldown allows
+        return in;
+    }
+
+    // walk to a door, go through, pick another door, repeat
+    WorldInput hopInput(const World& world, Pilot& pilot)
+    {
+        const RoomManager& rooms = world.rooms();
+
+        const TriggerDef* doors[8];
+        int doorCount = 0;
+        for (const TriggerDef& def : rooms.currentTriggers().triggers())
+        {
+            int nx, ny;
+            if (def.type == TriggerType::Door && doorCount < 8 &&
+                rooms.neighbor(static_cast<RoomDir>(def.param), nx, ny))
+                doors[doorCount++] = &def;
+        }
+        if (doorCount == 0)
+            return WorldInput{};
+
+        const TriggerDef& door = *doors[pilot.roomsEntered % doorCount];
+        const Player& p = world.player();
+        const float px = p.x + Player::WIDTH * 0.5f;
+        const float py = p.y + Player::HEIGHT * 0.5f;
+        const float dx = door.rect.x + door.rect.w * 0.5f - px;
+        const float dy = door.rect.y + door.rect.h * 0.5f - py;
+
+        // line up with the gap first, then walk straight through it
+        WorldInput in;
+        const RoomDir dir = static_cast<RoomDir>(door.param);
+        if (dir == RoomDir::North || dir == RoomDir::South)
+        {
+            if (dx < -1.0f)      in.left = true;
+            else if (dx > 1.0f)  in.right = true;
+            else if (dir == RoomDir::North) in.up = true;
+            else                 in.down = true;
+        }
+        else
+        {
+            if (dy < -1.0f)      in.up = true;
+            else if (dy > 1.0f)  in.down = true;
+            else if (dir == RoomDir::West) in.left = true;
+            else                 in.right = true;
+        }
+        return in;
+    }
+
+    // big room, player runs a rectangle so the camera scrolls all the way
+    WorldInput panInput(const World&, Pilot& pilot)
+    {
+        WorldInput in;
+        switch ((pilot.tick / 300) % 4)
+        {
+            case 0: in.right = true; in.down = (pilot.tick % 300) < 150; break;
+            case 1: in.down  = true; break;
+            case 2: in.left  = true; in.up = (pilot.tick % 300) < 150; break;
+            case 3: in.up    = true; break;
+        }
+        return in;
+    }
+
+    const Scenario SCENARIOS[] = {
+        {"idle_room",    10,  8, noSetup,    idleInput},
+        {"brawl_1000",   10,  8, brawlSetup, brawlInput},
+        {"room_hopping", 10,  8, noSetup,    hopInput},
+        {"big_map_pan", 128, 96, noSetup,    panInput},
+    };
+
+    // --- measurements ---
+
+    struct Percentiles
+    {
+        double p50 = 0, p95 = 0, p99 = 0, max = 0;
+    };
+
+    Percentiles percentiles(std::vector<double> samples)
+    {
+        Percentiles out;
+        if (samples.empty())
+            return out;
+        std::sort(samples.begin(), samples.end());
+        auto rank = [&](double q)
+        {
+            std::size_t i = static_cast<std::size_t>(q * (samples.size() - 1) + 0.5);
+            return samples[std::min(i, samples.size() - 1)];
+        };
+        out.p50 = rank(0.50);
+        out.p95 = rank(0.95);
+        out.p99 = rank(0.99);
+        out.max = samples.back();
+        return out;
+    }
+
+    struct Result
+    {
+        std::string name;
+        int ticks = 0;
+        Percentiles tickUs;
+        Percentiles renderUs;
+        Percentiles heapKb;
+        double allocsPerTick = 0;
+        std::uint64_t steadyViolations = 0;
+        int roomsEntered = 0;
+        int kills = 0;
+        std::uint32_t drawsPerFrame = 0; // last frame, for context
+    };
+
+    // Another run of the same scenario: best timings, worst memory. The
+    // workload has to come out the same (false = it didn't).
+    bool mergeRepeat(Result& r, const Result& again)
+    {
+        auto best = [](Percentiles& p, const Percentiles& q)
+        {
+            p.p50 = std::min(p.p50, q.p50);
+            p.p95 = std::min(p.p95, q.p95);
+            p.p99 = std::min(p.p99, q.p99);
+            p.max = std::min(p.max, q.max);
+        };
+        best(r.tickUs, again.tickUs);
+        best(r.renderUs, again.renderUs);
+        r.heapKb.p50 = std::max(r.heapKb.p50, again.heapKb.p50);
+        r.heapKb.p95 = std::max(r.heapKb.p95, again.heapKb.p95);
+        r.heapKb.max = std::max(r.heapKb.max, again.heapKb.max);
+        r.allocsPerTick = std::max(r.allocsPerTick, again.allocsPerTick);
+        r.steadyViolations = std::max(r.steadyViolations, again.steadyViolations);
+        return r.roomsEntered == again.roomsEntered && r.kills == again.kills &&
+               r.drawsPerFrame == again.drawsPerFrame;
+    }
+
+    // p99 of an empty timed region, in us (at least one counter tick):
+    // differences below this are the timer, not the code
+    double timerNoiseUs()
+    {
+        const double toUs = 1000000.0 / SDL_GetPerformanceFrequency();
+        std::vector<double> samples(10000);
+        for (double& d : samples)
+        {
+            const Uint64 t0 = SDL_GetPerformanceCounter();
+            d = (SDL_GetPerformanceCounter() - t0) * toUs;
+        }
+        return std::max(percentiles(samples).p99, toUs);
+    }
+
+    // Does the renderer really draw? A stub / dummy SDL takes every call
+    // and draws nothing, which makes render times meaningless.
+    bool rendererDraws(SDL_Renderer* renderer)
+    {
+        SDL_SetRenderDrawColor(renderer, 1, 2, 3, 255);
+        SDL_RenderClear(renderer);
+        Uint32 pixel = 0;
+        const SDL_Rect one{0, 0, 1, 1};
+        return SDL_RenderReadPixels(renderer, &one, SDL_PIXELFORMAT_RGBA8888, &pixel, sizeof(pixel)) == 0 &&
+               pixel == 0x010203FFu;
+    }
+
+    // what the numbers were measured with
+    struct RunInfo
+    {
+        bool rendererDraws = false;
+        bool optimized = false;
+        int repeats = 1;
+        double timerNoiseUs = 0;
+    };
+
+    constexpr bool OPTIMIZED_BUILD =
+#if defined(__OPTIMIZE__) || (defined(_MSC_VER) && !defined(_DEBUG))
+        true;
+#else
+        false;
+#endif
+
+    std::uint64_t hotAllocs()
+    {
+        return AllocTracker::stats(AllocStage::Update).allocs + AllocTracker::stats(AllocStage::Render).allocs;
+    }
+
+    Result runScenario(const Scenario& sc, int ticks, SDL_Renderer* renderer, TextureManager& textures)
+    {
+        Result r;
+        r.name = sc.name;
+        r.ticks = ticks;
+
+        World world;
+        WorldConfig config;
+        config.roomTilesW = sc.roomTilesW;
+        config.roomTilesH = sc.roomTilesH;
+        config.viewWidth = VIEW_W;
+        config.viewHeight = VIEW_H;
+        config.ai.budgetUs = 0; // think count budget only: the same workload on every machine
+        world.init(config);
+        world.rooms().ensureCurrentTextures(textures, renderer);
+        sc.setup(world);
+
+        ParticleSystem particles;
+        RenderQueue queue;
+        SpriteBatch sprites;
+        TextRenderer text;
+        text.createAtlas(renderer);
+        Hud hud;
+        Pilot pilot;
+
+        std::vector<double> tickUs, renderUs, heapKb;
+        tickUs.reserve(ticks);
+        renderUs.reserve(ticks);
+        heapKb.reserve(ticks);
+
+        const double toUs = 1000000.0 / SDL_GetPerformanceFrequency();
+        std::uint64_t allocsAtStart = 0;
+        std::uint64_t violationsAtStart = 0;
+
+        for (int t = 0; t < WARMUP_TICKS + ticks; ++t)
+        {
+            const bool measuring = t >= WARMUP_TICKS;
+            if (t == WARMUP_TICKS)
+            {
+                AllocTracker::setSteadyState(true);
+                AllocTracker::resetPeak();
+                allocsAtStart = hotAllocs();
+                violationsAtStart = AllocTracker::violationCount();
+            }
+
+            const WorldInput in = sc.input(world, pilot);
+
+            const Uint64 t0 = SDL_GetPerformanceCounter();
+            {
+                AllocStageScope stage(AllocStage::Update);
+                world.step(in);
+
+                // presentation reactions, same numbers as Engine
+                for (const WorldEvent& ev : world.events())
+                {
+                    switch (ev.type)
+                    {
+                        case WorldEvent::Type::EnemyHit:
+                            particles.emitBurst(ev.x, ev.y, 48, SDL_Color{255, 240, 160, 255}, 90.0f, 0.35f);
+                            break;
+                        case WorldEvent::Type::EnemyKilled:
+                            particles.emitBurst(ev.x, ev.y, 400, SDL_Color{200, 40, 40, 255}, 140.0f, 0.8f);
+                            if (measuring)
+                                ++r.kills;
+                            break;
+                        case WorldEvent::Type::RoomEntered:
+                            world.rooms().ensureCurrentTextures(textures, renderer);
+                            particles.clear();
+                            ++pilot.roomsEntered;
+                            if (measuring)
+                                ++r.roomsEntered;
+                            break;
+                        default:
+                            break;
+                    }
+                }
+                world.rooms().uploadPendingTilesets(textures, renderer);
+                particles.update(World::TICK_SEC);
+            }
+            const Uint64 t1 = SDL_GetPerformanceCounter();
+            {
+                AllocStageScope stage(AllocStage::Render);
+                SDL_SetRenderDrawColor(renderer, 8, 8, 12, 255);
+                SDL_RenderClear(renderer);
+                queue.begin(renderer);
+                recordWorld(queue, sprites, world, &particles, textures.get(world.rooms().currentTilesetKey()),
+                            textures.get("sprites"));
+                hud.update(world);
+                hud.record(queue, text, VIEW_W);
+                queue.flush();
+            }
+            const Uint64 t2 = SDL_GetPerformanceCounter();
+            AllocTracker::endFrame();
+
+            ++pilot.tick;
+            if (!measuring)
+                continue;
+
+            tickUs.push_back((t1 - t0) * toUs);
+            renderUs.push_back((t2 - t1) * toUs);
+            heapKb.push_back(AllocTracker::liveBytes() / 1024.0);
+        }
+
+        AllocTracker::setSteadyState(false);
+        text.releaseAtlas();
+
+        r.tickUs = percentiles(tickUs);
+        r.renderUs = percentiles(renderUs);
+        r.heapKb = percentiles(heapKb);
+        r.heapKb.max = std::max(r.heapKb.max, AllocTracker::peakLiveBytes() / 1024.0);
+        r.allocsPerTick = ticks > 0 ? static_cast<double>(hotAllocs() - allocsAtStart) / ticks : 0.0;
+        r.steadyViolations = AllocTracker::violationCount() - violationsAtStart;
+        r.drawsPerFrame = queue.lastStats().draws;
+        return r;
+    }
+
+    // --- tolerances ---
+
+    struct Tolerance
+    {
+        double rel = 0;
+        double abs = 0;
+    };
+
+    // Timings are mostly relative; their abs only has to cover timer
+    // noise (and is raised to the measured noise, see timerNoiseUs()).
+    // p95 is checked against its own "_tail" group: a tail that sits at
+    // twice the median (brawl_1000) moves more than 25% between runs.
+    std::map<std::string, Tolerance> defaultTolerances()
+    {
+        return {
+            {"tick_us",           {0.25, 0.10}},
+            {"tick_us_tail",      {0.60, 0.10}},
+            {"render_us",         {0.25, 0.10}},
+            {"render_us_tail",    {0.60, 0.10}},
+            {"allocs_per_tick",   {0.10, 0.01}},
+            {"steady_violations", {0.00, 0.0}},
+            {"heap_kb",           {0.10, 64.0}},
+        };
+    }
+
+    // metrics the check looks at (timing max / p99 are too noisy to gate on)
+    const char* const CHECKED[] = {
+        "tick_us.p50", "tick_us.p95",
+        "render_us.p50", "render_us.p95",
+        "allocs_per_tick", "steady_violations",
+        "heap_kb.p95", "heap_kb.max",
+    };
+
+    // what a scenario did; has to match the baseline exactly
+    const char* const WORKLOAD[] = {"rooms_entered", "kills", "draws_per_frame"};
+
+    // --- JSON ---
+
+    void writePercentiles(std::FILE* f, const char* key, const Percentiles& p, bool withP99)
+    {
+        if (withP99)
+            std::fprintf(f, "      \"%s\": {\"p50\": %.3f, \"p95\": %.3f, \"p99\": %.3f, \"max\": %.3f},\n",
+                         key, p.p50, p.p95, p.p99, p.max);
+        else
+            std::fprintf(f, "      \"%s\": {\"p50\": %.3f, \"p95\": %.3f, \"max\": %.3f},\n",
+                         key, p.p50, p.p95, p.max);
+    }
+
+    bool writeJson(const std::string& path, const std::vector<Result>& results, int ticks, const RunInfo& info,
+                   const std::map<std::string, Tolerance>* tolerances)
+    {
+        std::FILE* f = std::fopen(path.c_str(), "w");
+        if (!f)
+            return false;
+
+        std::fprintf(f, "{\n  \"harness\": 2,\n  \"ticks\": %d,\n  \"repeat\": %d,\n", ticks, info.repeats);
+        std::fprintf(f, "  \"optimized\": %d,\n  \"renderer_draws\": %d,\n  \"timer_noise_us\": %.3f,\n",
+                     info.optimized ? 1 : 0, info.rendererDraws ? 1 : 0, info.timerNoiseUs);
+        if (tolerances)
+        {
+            std::fprintf(f, "  \"tolerances\": {\n");
+            std::size_t i = 0;
+            for (const auto& [group, tol] : *tolerances)
+            {
+                std::fprintf(f, "    \"%s\": {\"rel\": %.3f, \"abs\": %.3f}%s\n",
+                             group.c_str(), tol.rel, tol.abs, ++i < tolerances->size() ? "," : "");
+            }
+            std::fprintf(f, "  },\n");
+        }
+        std::fprintf(f, "  \"scenarios\": {\n");
+        for (std::size_t i = 0; i < results.size(); ++i)
+        {
+            const Result& r = results[i];
+            std::fprintf(f, "    \"%s\": {\n", r.name.c_str());
+            writePercentiles(f, "tick_us", r.tickUs, true);
+            writePercentiles(f, "render_us", r.renderUs, true);
+            writePercentiles(f, "heap_kb", r.heapKb, false);
+            std::fprintf(f, "      \"allocs_per_tick\": %.4f,\n", r.allocsPerTick);
+            std::fprintf(f, "      \"steady_violations\": %llu,\n", static_cast<unsigned long long>(r.steadyViolations));
+            std::fprintf(f, "      \"rooms_entered\": %d,\n", r.roomsEntered);
+            std::fprintf(f, "      \"kills\": %d,\n", r.kills);
+            std::fprintf(f, "      \"draws_per_frame\": %u\n", r.drawsPerFrame);
+            std::fprintf(f, "    }%s\n", i + 1 < results.size() ? "," : "");
+        }
+        std::fprintf(f, "  }\n}\n");
+        std::fclose(f);
+        return true;
+    }
+
+    // Just enough JSON to read our own files back: every number ends up in
+    // `out` under its dotted path ("scenarios.idle_room.tick_us.p50").
+    // Strings, bools and nulls are skipped.
+    class FlatJson
+    {
+    public:
+        explicit FlatJson(const std::string& text) : m_s(text) {}
+
+        bool parse(std::map<std::string, double>& out)
+        {
+            m_out = &out;
+            skipWs();
+            if (!value(""))
+                return false;
+            skipWs();
+            return m_i == m_s.size();
+        }
+
+    private:
+        void skipWs()
+        {
+            while (m_i < m_s.size() && std::isspace(static_cast<unsigned char>(m_s[m_i])))
+                ++m_i;
+        }
+
+        bool string(std::string& out)
+        {
+            if (m_i >= m_s.size() || m_s[m_i] != '"')
+                return false;
+            ++m_i;
+            out.clear();
+            while (m_i < m_s.size() && m_s[m_i] != '"')
+            {
+                if (m_s[m_i] == '\\' && m_i + 1 < m_s.size())
+                    ++m_i;
+                out += m_s[m_i++];
+            }
+            if (m_i >= m_s.size())
+                return false;
+            ++m_i;
+            return true;
+        }
+
+        bool value(const std::string& path)
+        {
+            skipWs();
+            if (m_i >= m_s.size())
+                return false;
+
+            const char c = m_s[m_i];
+            if (c == '{' || c == '[')
+            {
+                const char close = (c == '{') ? '}' : ']';
+                ++m_i;
+                skipWs();
+                if (m_i < m_s.size() && m_s[m_i] == close)
+                {
+                    ++m_i;
+                    return true;
+                }
+                for (int index = 0;; ++index)
+                {
+                    std::string key = std::to_string(index);
+                    if (c == '{')
+                    {
+                        skipWs();
+                        if (!string(key))
+                            return false;
+                        skipWs();
+                        if (m_i >= m_s.size() || m_s[m_i++] != ':')
+                            return false;
+                    }
+                    if (!value(path.empty() ? key : path + "." + key))
+                        return false;
+                    skipWs();
+                    if (m_i < m_s.size() && m_s[m_i] == ',')
+                    {
+                        ++m_i;
+                        continue;
+                    }
+                    if (m_i < m_s.size() && m_s[m_i] == close)
+                    {
+                        ++m_i;
+                        return true;
+                    }
+                    return false;
+                }
+            }
+            if (c == '"')
+            {
+                std::string ignored;
+                return string(ignored);
+            }
+            if (std::isalpha(static_cast<unsigned char>(c)))
+            {
+                while (m_i < m_s.size() && std::isalpha(static_cast<unsigned char>(m_s[m_i])))
+                    ++m_i;
+                return true;
+            }
+
+            char* end = nullptr;
+            const double v = std::strtod(m_s.c_str() + m_i, &end);
+            if (end == m_s.c_str() + m_i)
+                return false;
+            m_i = static_cast<std::size_t>(end - m_s.c_str());
+            (*m_out)[path] = v;
+            return true;
+        }
+
+        const std::string& m_s;
+        std::size_t m_i = 0;
+        std::map<std::string, double>* m_out = nullptr;
+    };
+
+    bool readJson(const std::string& path, std::map<std::string, double>& out)
+    {
+        std::ifstream in(path);
+        if (!in)
+            return false;
+        std::stringstream ss;
+        ss << in.rdbuf();
+        const std::string text = ss.str();
+        return FlatJson(text).parse(out);
+    }
+
+    // Re-recording on top of a baseline: timings keep the slower of the
+    // two, as long as the workload is the same one.
+    void keepSlower(Result& r, const std::map<std::string, double>& baseline)
+    {
+        const std::string prefix = "scenarios." + r.name + ".";
+        auto value = [&](const char* key, double fallback)
+        {
+            auto it = baseline.find(prefix + key);
+            return it != baseline.end() ? it->second : fallback;
+        };
+        if (value("rooms_entered", -1) != r.roomsEntered || value("kills", -1) != r.kills ||
+            value("draws_per_frame", -1) != r.drawsPerFrame)
+            return;
+
+        auto slower = [&](Percentiles& p, const std::string& group)
+        {
+            p.p50 = std::max(p.p50, value((group + ".p50").c_str(), 0));
+            p.p95 = std::max(p.p95, value((group + ".p95").c_str(), 0));
+            p.p99 = std::max(p.p99, value((group + ".p99").c_str(), 0));
+            p.max = std::max(p.max, value((group + ".max").c_str(), 0));
+        };
+        slower(r.tickUs, "tick_us");
+        slower(r.renderUs, "render_us");
+    }
+
+    double metric(const Result& r, const std::string& name)
+    {
+        if (name == "tick_us.p50")       return r.tickUs.p50;
+        if (name == "tick_us.p95")       return r.tickUs.p95;
+        if (name == "render_us.p50")     return r.renderUs.p50;
+        if (name == "render_us.p95")     return r.renderUs.p95;
+        if (name == "heap_kb.p95")       return r.heapKb.p95;
+        if (name == "heap_kb.max")       return r.heapKb.max;
+        if (name == "allocs_per_tick")   return r.allocsPerTick;
+        if (name == "steady_violations") return static_cast<double>(r.steadyViolations);
+        if (name == "rooms_entered")     return r.roomsEntered;
+        if (name == "kills")             return r.kills;
+        if (name == "draws_per_frame")   return r.drawsPerFrame;
+        return 0.0;
+    }
+
+    // false = at least one regression or a changed workload
+    bool compare(const std::vector<Result>& results,
+                 const std::map<std::string, double>& baseline,
+                 const std::map<std::string, Tolerance>& tolerances,
+                 const RunInfo& info)
+    {
+        auto drawn = baseline.find("renderer_draws");
+        const bool checkRender = info.rendererDraws && drawn != baseline.end() && drawn->second != 0.0;
+
+        bool slower = false;
+        bool changed = false;
+        std::printf("\ntimer noise %.3f us%s\n", info.timerNoiseUs,
+                    checkRender ? "" : "; render_us not checked (renderer draws nothing here or in the baseline)");
+        std::printf("%-14s %-18s %12s %12s %12s\n", "scenario", "metric", "baseline", "current", "limit");
+        for (const Result& r : results)
+        {
+            for (const char* name : WORKLOAD)
+            {
+                const double cur = metric(r, name);
+                auto it = baseline.find("scenarios." + r.name + "." + name);
+                if (it == baseline.end())
+                {
+                    std::printf("%-14s %-18s %12s %12.0f %12s  new\n", r.name.c_str(), name, "-", cur, "-");
+                    continue;
+                }
+                const bool same = cur == it->second;
+                changed = changed || !same;
+                std::printf("%-14s %-18s %12.0f %12.0f %12s  %s\n",
+                            r.name.c_str(), name, it->second, cur, "same", same ? "ok" : "WORKLOAD CHANGED");
+            }
+
+            for (const char* name : CHECKED)
+            {
+                const std::string m = name;
+                const double cur = metric(r, m);
+                auto it = baseline.find("scenarios." + r.name + "." + m);
+                if (it == baseline.end())
+                {
+                    std::printf("%-14s %-18s %12s %12.3f %12s  new\n", r.name.c_str(), name, "-", cur, "-");
+                    continue;
+                }
+
+                const std::string group = m.substr(0, m.find('.'));
+                const bool timing = group == "tick_us" || group == "render_us";
+                if (group == "render_us" && !checkRender)
+                {
+                    std::printf("%-14s %-18s %12.3f %12.3f %12s  not checked\n",
+                                r.name.c_str(), name, it->second, cur, "-");
+                    continue;
+                }
+
+                const bool tail = m.size() > 4 && m.compare(m.size() - 4, 4, ".p95") == 0;
+                auto tolIt = tolerances.find(timing && tail ? group + "_tail" : group);
+                const Tolerance tol = tolIt != tolerances.end() ? tolIt->second : Tolerance{};
+                const double abs = timing ? std::max(tol.abs, info.timerNoiseUs) : tol.abs;
+                const double limit = it->second * (1.0 + tol.rel) + abs;
+                const bool pass = cur <= limit;
+                slower = slower || !pass;
+                std::printf("%-14s %-18s %12.3f %12.3f %12.3f  %s\n",
+                            r.name.c_str(), name, it->second, cur, limit, pass ? "ok" : "REGRESSION");
+            }
+        }
+
+        if (changed)
+            std::printf("\na scenario's workload changed: re-record the baseline (--write-baseline) in the same change\n");
+        return !slower && !changed;
+    }
+
+    void usage()
+    {
+        std::fprintf(stderr,
+                     "usage: perf_harness [--scenario NAME] [--ticks N] [--repeat N] [--out FILE]\n"
+                     "                    [--baseline FILE] [--write-baseline FILE]\n"
+                     "                    [--tolerance GROUP=REL[:ABS]]...\n"
+                     "scenarios:");
+        for (const Scenario& sc : SCENARIOS)
+            std::fprintf(stderr, " %s", sc.name);
+        std::fprintf(stderr, "\n");
+    }
+}
+
+int main(int argc, char** argv)
+{
+    std::string only;
+    std::string outPath = "perf_results.json";
+    std::string baselinePath;
+    std::string writeBaselinePath;
+    int ticks = 1200; // 20 s of game time per scenario
+    int repeats = 3;
+    std::map<std::string, Tolerance> cliTolerances;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (arg == "--scenario" && hasValue)            only = argv[++i];
+        else if (arg == "--ticks" && hasValue)          ticks = std::atoi(argv[++i]);
+        else if (arg == "--repeat" && hasValue)         repeats = std::atoi(argv[++i]);
+        else if (arg == "--out" && hasValue)            outPath = argv[++i];
+        else if (arg == "--baseline" && hasValue)       baselinePath = argv[++i];
+        else if (arg == "--write-baseline" && hasValue) writeBaselinePath = argv[++i];
+        else if (arg == "--tolerance" && hasValue)
+        {
+            const std::string spec = argv[++i];
+            const std::size_t eq = spec.find('=');
+            if (eq == std::string::npos)
+            {
+                usage();
+                return 2;
+            }
+            Tolerance tol;
+            tol.rel = std::atof(spec.c_str() + eq + 1);
+            const std::size_t colon = spec.find(':', eq);
+            if (colon != std::string::npos)
+                tol.abs = std::atof(spec.c_str() + colon + 1);
+            cliTolerances[spec.substr(0, eq)] = tol;
+        }
+        else
+        {
+            usage();
+            return 2;
+        }
+    }
+    if (ticks <= 0 || repeats <= 0)
+    {
+        usage();
+        return 2;
+    }
+
+    if (!AllocTracker::enabled())
+        std::fprintf(stderr, "note: built without allocation tracking, heap / alloc metrics read 0\n");
+
+    IMG_Init(IMG_INIT_PNG);
+
+    // headless: software renderer into a surface the size of the game's scene target
+    SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormat(0, VIEW_W, VIEW_H, 32, SDL_PIXELFORMAT_RGBA8888);
+    SDL_Renderer* renderer = surface ? SDL_CreateSoftwareRenderer(surface) : nullptr;
+    if (!renderer)
+    {
+        std::fprintf(stderr, "software renderer failed: %s\n", SDL_GetError());
+        return 2;
+    }
+
+    RunInfo info;
+    info.rendererDraws = rendererDraws(renderer);
+    info.optimized = OPTIMIZED_BUILD;
+    info.repeats = repeats;
+    info.timerNoiseUs = timerNoiseUs();
+    if (!info.rendererDraws)
+        std::fprintf(stderr, "note: the renderer draws nothing (stub / dummy SDL?), render_us means nothing\n");
+    if (!info.optimized)
+        std::fprintf(stderr, "note: unoptimized build, only comparable with an unoptimized baseline\n");
+
+    std::vector<Result> results;
+    bool deterministic = true;
+    {
+        TextureManager textures;
+        if (!textures.loadTexture("tiles", "assets/tiles.png", renderer))
+            std::fprintf(stderr, "note: assets/tiles.png not found, tiles draw as flat fills\n");
+        if (!textures.loadTexture("sprites", "assets/sprites.png", renderer))
+            std::fprintf(stderr, "note: assets/sprites.png not found, sprites draw as flat quads\n");
+
+        for (const Scenario& sc : SCENARIOS)
+        {
+            if (!only.empty() && only != sc.name)
+                continue;
+
+            Result r = runScenario(sc, ticks, renderer, textures);
+            for (int i = 1; i < repeats; ++i)
+            {
+                if (!mergeRepeat(r, runScenario(sc, ticks, renderer, textures)))
+                {
+                    std::fprintf(stderr, "%s: workload differs between runs\n", sc.name);
+                    deterministic = false;
+                }
+            }
+            std::printf("%-14s tick p50 %7.1f us  p95 %7.1f us | render p50 %7.1f us  p95 %7.1f us | "
+                        "%.3f allocs/tick, heap p95 %.0f KB | rooms %d, kills %d\n",
+                        r.name.c_str(), r.tickUs.p50, r.tickUs.p95, r.renderUs.p50, r.renderUs.p95,
+                        r.allocsPerTick, r.heapKb.p95, r.roomsEntered, r.kills);
+            results.push_back(std::move(r));
+        }
+        textures.clear();
+    }
+
+    SDL_DestroyRenderer(renderer);
+    SDL_FreeSurface(surface);
+    IMG_Quit();
+
+    if (results.empty())
+    {
+        usage();
+        return 2;
+    }
+
+    if (!writeJson(outPath, results, ticks, info, nullptr))
+        std::fprintf(stderr, "could not write %s\n", outPath.c_str());
+
+    // tolerances: defaults < baseline file < command line
+    std::map<std::string, Tolerance> tolerances = defaultTolerances();
+    std::map<std::string, double> baseline;
+    if (!baselinePath.empty())
+    {
+        if (!readJson(baselinePath, baseline))
+        {
+            std::fprintf(stderr, "could not read baseline %s\n", baselinePath.c_str());
+            return 2;
+        }
+        auto optimized = baseline.find("optimized");
+        if (optimized != baseline.end() && (optimized->second != 0.0) != info.optimized)
+        {
+            std::fprintf(stderr, "baseline %s comes from an %s build, this one is %s: configure with "
+                                 "-DCMAKE_BUILD_TYPE=%s to compare\n",
+                         baselinePath.c_str(), info.optimized ? "unoptimized" : "optimized",
+                         info.optimized ? "optimized" : "not", info.optimized ? "Debug" : "Release");
+            return 2;
+        }
+        for (auto& [group, tol] : tolerances)
+        {
+            auto rel = baseline.find("tolerances." + group + ".rel");
+            auto abs = baseline.find("tolerances." + group + ".abs");
+            if (rel != baseline.end()) tol.rel = rel->second;
+            if (abs != baseline.end()) tol.abs = abs->second;
+        }
+    }
+    for (const auto& [group, tol] : cliTolerances)
+        tolerances[group] = tol;
+
+    if (!writeBaselinePath.empty())
+    {
+        std::vector<Result> recorded = results;
+        for (Result& r : recorded)
+            keepSlower(r, baseline);
+        if (!writeJson(writeBaselinePath, recorded, ticks, info, &tolerances))
+        {
+            std::fprintf(stderr, "could not write %s\n", writeBaselinePath.c_str());
+            return 2;
+        }
+        std::printf("baseline written to %s\n", writeBaselinePath.c_str());
+        if (!info.rendererDraws)
+            std::printf("render_us in it won't be checked until it's recorded with a renderer that draws\n");
+    }
+
+    // (recording on top of a baseline still prints the comparison, but isn't a gate)
+    if (!baselinePath.empty() && !compare(results, baseline, tolerances, info) && writeBaselinePath.empty())
+    {
+        std::printf("\nperformance regression against %s\n", baselinePath.c_str());
+        return 1;
+    }
+    if (!deterministic)
+    {
+        std::printf("\nscenario workload isn't deterministic, results can't be compared\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,141 @@
+// Shared tile block benchmark.
+//
+// Usage: tile_share_bench [rooms] [templates] [edit%]
+// Stamps `rooms` 64x48 rooms (default 4096) out of `templates` layouts
+// (default 8) into one TileBlockPool, then edits a few tiles in `edit%`
+// of them (default 10) the way cracked walls / opened doors would.
+// Checks every room still reads back its own layout (edits must not leak
+// into rooms sharing the block) and reports tile memory with and without
+// sharing.
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "TileMap.h"
+
+namespace
+{
+    constexpr int ROOM_W = 64;
+    constexpr int ROOM_H = 48;
+
+    // bordered room, door gaps, a few pillars placed from the template seed
+    std::vector<int> makeTemplate(int seed)
+    {
+        std::mt19937 rng(static_cast<std::uint32_t>(seed) * 7919u + 1u);
+        std::vector<int> tiles(ROOM_W * ROOM_H, 0);
+        for (int y = 0; y < ROOM_H; ++y)
+            for (int x = 0; x < ROOM_W; ++x)
+                if (x == 0 || y == 0 || x == ROOM_W - 1 || y == ROOM_H - 1)
+                    tiles[y * ROOM_W + x] = 1;
+
+        for (int d = -1; d <= 1; ++d)
+        {
+            tiles[ROOM_W / 2 + d] = 0;
+            tiles[(ROOM_H - 1) * ROOM_W + ROOM_W / 2 + d] = 0;
+            tiles[(ROOM_H / 2 + d) * ROOM_W] = 0;
+            tiles[(ROOM_H / 2 + d) * ROOM_W + ROOM_W - 1] = 0;
+        }
+
+        const int pillars = 4 + seed % 5;
+        for (int p = 0; p < pillars; ++p)
+        {
+            const int px = 4 + static_cast<int>(rng() % (ROOM_W - 10));
+            const int py = 4 + static_cast<int>(rng() % (ROOM_H - 10));
+            for (int y = py; y < py + 2; ++y)
+                for (int x = px; x < px + 2; ++x)
+                    tiles[y * ROOM_W + x] = 1;
+        }
+        return tiles;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    using Clock = std::chrono::steady_clock;
+    using zelda::game::TileMap;
+    using zelda::game::TileLayer;
+    using zelda::game::TileBlock;
+    using zelda::game::TileBlockPool;
+
+    const int rooms     = (argc > 1) ? std::atoi(argv[1]) : 4096;
+    const int templates = (argc > 2) ? std::max(1, std::atoi(argv[2])) : 8;
+    const int editPct   = (argc > 3) ? std::atoi(argv[3]) : 10;
+
+    std::vector<std::vector<int>> layouts;
+    for (int t = 0; t < templates; ++t)
+        layouts.push_back(makeTemplate(t));
+
+    TileBlockPool pool;
+    std::vector<std::unique_ptr<TileMap>> maps;
+    maps.reserve(rooms);
+
+    auto start = Clock::now();
+    for (int r = 0; r < rooms; ++r)
+    {
+        auto map = std::make_unique<TileMap>();
+        map->setBlockPool(&pool);
+        map->load(ROOM_W, ROOM_H, layouts[r % templates]);
+        maps.push_back(std::move(map));
+    }
+    auto loaded = Clock::now();
+
+    // knock a hole in one wall of the edited rooms
+    std::mt19937 rng(1234);
+    std::vector<char> edited(rooms, 0);
+    for (int r = 0; r < rooms; ++r)
+    {
+        if (static_cast<int>(rng() % 100) >= editPct)
+            continue;
+        edited[r] = 1;
+        const int ty = 1 + static_cast<int>(rng() % (ROOM_H - 2));
+        maps[r]->setTile(TileLayer::Floor, 0, ty, 2);
+        maps[r]->setTile(TileLayer::Collision, 0, ty, 0);
+    }
+    auto end = Clock::now();
+
+    // every room matches its template, except for its own edit
+    std::size_t chunks = 0;
+    for (int r = 0; r < rooms; ++r)
+    {
+        const std::vector<int>& layout = layouts[r % templates];
+        for (int y = 0; y < ROOM_H; ++y)
+            for (int x = 0; x < ROOM_W; ++x)
+            {
+                const int got = maps[r]->getTile(TileLayer::Floor, x, y);
+                const int want = layout[y * ROOM_W + x];
+                if (got != want && !(edited[r] && x == 0 && got == 2))
+                {
+                    std::printf("MISMATCH room %d at %d,%d: %d != %d\n", r, x, y, got, want);
+                    return 1;
+                }
+            }
+        chunks += maps[r]->allocatedChunkCount();
+    }
+
+    const double loadMs = std::chrono::duration<double, std::milli>(loaded - start).count();
+    const double editMs = std::chrono::duration<double, std::milli>(end - loaded).count();
+    const std::size_t unsharedBytes = chunks * sizeof(TileBlock);
+
+    std::printf("rooms:             %d (%d templates, %d%% edited)\n", rooms, templates, editPct);
+    std::printf("chunks:            %zu\n", chunks);
+    std::printf("shared blocks:     %zu (%llu chunk refs)\n", pool.sharedBlocks(),
+                static_cast<unsigned long long>(pool.sharedRefs()));
+    std::printf("private blocks:    %zu\n", pool.privateBlocks());
+    std::printf("copies on write:   %llu\n", static_cast<unsigned long long>(pool.copiesOnWrite()));
+    std::printf("tile data:         %.1f KB (unshared %.1f KB, saved %.1f KB)\n",
+                pool.bytes() / 1024.0, unsharedBytes / 1024.0, pool.bytesSaved() / 1024.0);
+    std::printf("load:              %.2f ms (%.2f us / room)\n", loadMs, rooms ? loadMs * 1000.0 / rooms : 0.0);
+    std::printf("edits:             %.2f ms\n", editMs);
+
+    maps.clear();
+    if (pool.sharedBlocks() != 0 || pool.privateBlocks() != 0)
+    {
+        std::printf("LEAK: %zu shared / %zu private blocks left\n", pool.sharedBlocks(), pool.privateBlocks());
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,306 @@
+#include "AiScheduler.h"
+
+#include <SDL2/SDL.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+#include "Log.h"
+#include "World.h"
+
+namespace zelda::game
+{
+    namespace
+    {
+        // deterministic per (enemy, tick) choice for idle / patrol legs
+        std::uint32_t hashPick(std::size_t index, std::uint64_t tick)
+        {
+            std::uint64_t x = (static_cast<std::uint64_t>(index) << 32) ^ tick;
+            x = (x ^ (x >> 33)) * 0xFF51AFD7ED558CCDull;
+            x = (x ^ (x >> 33)) * 0xC4CEB9FE1A85EC53ull;
+            return static_cast<std::uint32_t>(x ^ (x >> 33));
+        }
+
+        // 8 compass headings for patrol legs
+        constexpr float DIAG = 0.70710678f;
+        constexpr float HEADINGS[8][2] = {
+            {1.f, 0.f}, {DIAG, DIAG}, {0.f, 1.f}, {-DIAG, DIAG},
+            {-1.f, 0.f}, {-DIAG, -DIAG}, {0.f, -1.f}, {DIAG, -DIAG}};
+
+        // credit is capped so a long-deferred enemy doesn't think twice in a row
+        constexpr float MAX_CREDIT = 2.0f;
+    }
+
+    void AiScheduler::reset()
+    {
+        m_cursor = 0;
+        m_stats = AiStats{};
+        m_lastTick = AiStats{};
+    }
+
+    float AiScheduler::thinkWeight(const Enemy& enemy, float playerX, float playerY) const
+    {
+        const float dx = playerX - enemy.x;
+        const float dy = playerY - enemy.y;
+        const float dist = SDL_sqrtf(dx * dx + dy * dy);
+
+        float weight = 1.0f;
+        if (dist > m_config.nearRadiusPx)
+        {
+            const float span = std::max(1.0f, m_config.farRadiusPx - m_config.nearRadiusPx);
+            const float t = std::min(1.0f, (dist - m_config.nearRadiusPx) / span);
+            weight = 1.0f + t * (m_config.minWeight - 1.0f);
+        }
+
+        // urgency: anyone hunting the player keeps a closer eye on them
+        switch (enemy.brain.mode)
+        {
+            case EnemyMode::Chase:  weight *= 4.0f; break;
+            case EnemyMode::Search: weight *= 2.0f; break;
+            default: break;
+        }
+        return std::min(1.0f, weight);
+    }
+
+    void AiScheduler::update(std::vector<Enemy>& enemies, const TileMap& map, Visibility& sight,
+                             Visibility::ViewerId playerViewer, float playerX, float playerY, std::uint64_t tick,
+                             float dtSec, Arena& scratch)
+    {
+        using Clock = std::chrono::steady_clock;
+
+        AiStats now;
+        now.ticks = 1;
+
+        const std::size_t n = enemies.size();
+        if (n > 0)
+        {
+            const bool timed = m_config.budgetUs > 0;
+            const auto start = timed ? Clock::now() : Clock::time_point{};
+            const auto deadline = start + std::chrono::microseconds(m_config.budgetUs);
+
+            if (m_cursor >= n)
+                m_cursor = 0;
+
+            std::size_t firstDeferred = n;
+            bool outOfBudget = false;
+            for (std::size_t k = 0; k < n; ++k)
+            {
+                const std::size_t i = (m_cursor + k) % n;
+                Enemy& enemy = enemies[i];
+                if (enemy.hp <= 0 || enemy.dormant)
+                    continue;
+
+                EnemyBrain& brain = enemy.brain;
+                brain.credit = std::min(MAX_CREDIT, brain.credit + thinkWeight(enemy, playerX, playerY));
+                if (brain.credit < 1.0f)
+                {
+                    ++now.skipped;
+                    continue;
+                }
+
+                if (!outOfBudget)
+                {
+                    outOfBudget = now.thinks >= static_cast<std::uint64_t>(m_config.maxThinksPerTick) ||
+                                  (timed && Clock::now() >= deadline);
+                }
+                if (outOfBudget)
+                {
+                    if (firstDeferred == n)
+                        firstDeferred = i;
+                    ++now.deferred;
+                    continue;
+                }
+
+                think(enemy, i, sight, playerViewer, playerX, playerY, tick);
+                brain.credit = 0.0f;
+                ++now.thinks;
+            }
+
+            // next tick starts with whoever we had to leave out
+            if (firstDeferred != n)
+            {
+                m_cursor = firstDeferred;
+                ++now.overBudgetTicks;
+            }
+
+            if (timed)
+                now.thinkUs = std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+
+            now.pixelSteps = steer(enemies, map, playerX, playerY, dtSec, scratch);
+            for (const Enemy& enemy : enemies)
+                now.steered += enemy.hp > 0 && !enemy.dormant;
+        }
+
+        m_lastTick = now;
+        m_stats.ticks += now.ticks;
+        m_stats.thinks += now.thinks;
+        m_stats.deferred += now.deferred;
+        m_stats.skipped += now.skipped;
+        m_stats.steered += now.steered;
+        m_stats.pixelSteps += now.pixelSteps;
+        m_stats.overBudgetTicks += now.overBudgetTicks;
+        m_stats.thinkUs += now.thinkUs;
+    }
+
+    void AiScheduler::think(Enemy& enemy, std::size_t index, Visibility& sight, Visibility::ViewerId playerViewer,
+                            float playerX, float playerY, std::uint64_t tick) const
+    {
+        EnemyBrain& brain = enemy.brain;
+
+        const float ex = enemy.x + Enemy::WIDTH * 0.5f;
+        const float ey = enemy.y + Enemy::HEIGHT * 0.5f;
+        const float px = playerX + Player::WIDTH * 0.5f;
+        const float py = playerY + Player::HEIGHT * 0.5f;
+        const float dx = px - ex, dy = py - ey;
+
+        // sees the player: chase (the player sees our tile = we see theirs)
+        if (dx * dx + dy * dy < m_config.sightRadiusPx * m_config.sightRadiusPx &&
+            sight.canSeePoint(playerViewer, ex, ey))
+        {
+            brain.mode = EnemyMode::Chase;
+            brain.targetX = playerX;
+            brain.targetY = playerY;
+            return;
+        }
+
+        // lost them: go to where they were last seen
+        if (brain.mode == EnemyMode::Chase)
+        {
+            brain.mode = EnemyMode::Search;
+            return;
+        }
+        if (brain.mode == EnemyMode::Search)
+        {
+            const float tx = brain.targetX - enemy.x, ty = brain.targetY - enemy.y;
+            if (tx * tx + ty * ty > 4.0f * 4.0f)
+                return; // not there yet
+        }
+
+        // otherwise alternate short patrol legs and pauses
+        if (brain.modeTicks > 0 && brain.mode != EnemyMode::Search)
+            return;
+
+        const std::uint32_t pick = hashPick(index, tick);
+        if (brain.mode == EnemyMode::Patrol)
+        {
+            brain.mode = EnemyMode::Idle;
+            brain.modeTicks = 30 + static_cast<std::int32_t>(pick % 60);
+        }
+        else
+        {
+            brain.mode = EnemyMode::Patrol;
+            brain.dirX = HEADINGS[pick % 8][0];
+            brain.dirY = HEADINGS[pick % 8][1];
+            brain.modeTicks = 40 + static_cast<std::int32_t>((pick >> 8) % 80);
+        }
+    }
+
+    std::uint64_t AiScheduler::steer(std::vector<Enemy>& enemies, const TileMap& map, float playerX, float playerY,
+                                     float dtSec, Arena& scratch)
+    {
+        // desired move per enemy, then one batched wall test per axis
+        ArenaVector<std::uint32_t> movers{ArenaAllocator<std::uint32_t>(&scratch)};
+        ArenaVector<SDL_FPoint> deltas{ArenaAllocator<SDL_FPoint>(&scratch)};
+        ArenaVector<SDL_Rect> rects{ArenaAllocator<SDL_Rect>(&scratch)};
+        ArenaVector<std::uint64_t> hits{ArenaAllocator<std::uint64_t>(&scratch)};
+        movers.reserve(enemies.size());
+        deltas.reserve(enemies.size());
+        rects.reserve(enemies.size());
+        hits.resize((enemies.size() + 63) / 64);
+
+        for (std::size_t i = 0; i < enemies.size(); ++i)
+        {
+            Enemy& enemy = enemies[i];
+            if (enemy.hp <= 0 || enemy.dormant)
+                continue;
+
+            EnemyBrain& brain = enemy.brain;
+            float dirX = 0.0f, dirY = 0.0f, speed = 0.0f;
+            switch (brain.mode)
+            {
+                case EnemyMode::Chase:
+                case EnemyMode::Search:
+                {
+                    // chasers track the player's current position between thinks
+                    const float tx = (brain.mode == EnemyMode::Chase ? playerX : brain.targetX) - enemy.x;
+                    const float ty = (brain.mode == EnemyMode::Chase ? playerY : brain.targetY) - enemy.y;
+                    const float len = SDL_sqrtf(tx * tx + ty * ty);
+                    if (len > 1.0f)
+                    {
+                        dirX = tx / len;
+                        dirY = ty / len;
+                    }
+                    else if (brain.mode == EnemyMode::Search)
+                    {
+                        brain.credit = 1.0f; // arrived, decide what's next
+                    }
+                    speed = brain.mode == EnemyMode::Chase ? Enemy::CHASE_SPEED : Enemy::WALK_SPEED;
+                    break;
+                }
+                case EnemyMode::Patrol:
+                    dirX = brain.dirX;
+                    dirY = brain.dirY;
+                    speed = Enemy::WALK_SPEED * 0.6f;
+                    [[fallthrough]];
+                case EnemyMode::Idle:
+                    if (brain.modeTicks > 0 && --brain.modeTicks == 0)
+                        brain.credit = 1.0f;
+                    break;
+            }
+
+            if (speed > 0.0f)
+            {
+                movers.push_back(static_cast<std::uint32_t>(i));
+                deltas.push_back(SDL_FPoint{dirX * speed * dtSec, dirY * speed * dtSec});
+            }
+        }
+
+        // x then y, like the player: slide along walls
+        std::uint64_t pixelSteps = 0;
+        for (int axis = 0; axis < 2; ++axis)
+        {
+            rects.clear();
+            for (std::size_t m = 0; m < movers.size(); ++m)
+            {
+                const Enemy& enemy = enemies[movers[m]];
+                const float nx = enemy.x + (axis == 0 ? deltas[m].x : 0.0f);
+                const float ny = enemy.y + (axis == 1 ? deltas[m].y : 0.0f);
+                rects.push_back(SDL_Rect{static_cast<int>(nx), static_cast<int>(ny), Enemy::WIDTH, Enemy::HEIGHT});
+            }
+            hits.assign((movers.size() + 63) / 64, 0);
+            map.rectsCollideSolid(rects.data(), rects.size(), hits.data());
+
+            for (std::size_t m = 0; m < movers.size(); ++m)
+            {
+                Enemy& enemy = enemies[movers[m]];
+                const float d = axis == 0 ? deltas[m].x : deltas[m].y;
+                if (d == 0.0f)
+                    continue;
+                if ((hits[m / 64] >> (m % 64)) & 1)
+                {
+                    // bumped into a wall: rethink next tick
+                    enemy.brain.credit = 1.0f;
+                    continue;
+                }
+                float& pos = axis == 0 ? enemy.x : enemy.y;
+                const float before = std::floor(pos);
+                pos += d;
+                pixelSteps += std::floor(pos) != before; // sprites are drawn at floor(x), floor(y)
+            }
+        }
+        return pixelSteps;
+    }
+
+    void AiScheduler::logSummary() const
+    {
+        if (m_stats.ticks == 0)
+            return;
+
+        const double ticks = static_cast<double>(m_stats.ticks);
+        ZLOG_INFO("AI: %.1f thinks / tick, %.1f deferred, %.1f skipped, %.1f steered, %llu ticks over budget",
+                  m_stats.thinks / ticks, m_stats.deferred / ticks, m_stats.skipped / ticks,
+                  m_stats.steered / ticks, static_cast<unsigned long long>(m_stats.overBudgetTicks));
+        if (m_config.budgetUs > 0)
+            ZLOG_INFO("  think time %.1f us / tick (budget %d us)", m_stats.thinkUs / ticks, m_config.budgetUs);
+    }
+}
@@ -0,0 +1,92 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+#include "Arena.h"
+#include "Visibility.h"
+
+namespace zelda::game
+{
+    struct Enemy;
+    class TileMap;
+
+    struct AiConfig
+    {
+        // Wall-clock time think() may use per tick. 0 = don't look at the
+        // clock, only maxThinksPerTick: runs are then deterministic (batch
+        // runs / replays), the time budget depends on the machine.
+        int budgetUs = 400;
+        int maxThinksPerTick = 64;
+
+        // How often an enemy thinks, by distance to the player: every tick
+        // inside nearRadius, falling off linearly to minWeight at farRadius.
+        float nearRadiusPx = 4.0f * 16.0f;
+        float farRadiusPx  = 16.0f * 16.0f;
+        float minWeight    = 1.0f / 30.0f; // far away: about twice a second
+
+        // enemies only notice the player this close (and in view, Visibility)
+        float sightRadiusPx = 8.0f * 16.0f;
+    };
+
+    struct AiStats
+    {
+        std::uint64_t ticks    = 0;
+        std::uint64_t thinks   = 0; // brains that ran
+        std::uint64_t deferred = 0; // were due, pushed to a later tick by the budget
+        std::uint64_t skipped  = 0; // not due yet (distance / urgency weighting)
+        std::uint64_t steered  = 0; // cheap per-tick moves
+        std::uint64_t pixelSteps = 0; // moves that changed a drawn (whole pixel) position
+        std::uint64_t overBudgetTicks = 0; // ticks that deferred anything
+        double thinkUs = 0.0;       // time spent thinking (only with a time budget)
+    };
+
+    // Spreads enemy "thinking" over ticks.
+    //
+    // think() is the expensive part (picking a mode / target, line of
+    // sight from the player's cached Visibility field); steering towards
+    // the current target is cheap and runs for every enemy every tick.
+    // Each tick every enemy earns think credit by distance to the player,
+    // times an urgency factor (chasing / searching enemies, or ones that
+    // just bumped into a wall, think sooner). Enemies with a full credit
+    // are due. Due enemies think round-robin from where the last tick
+    // left off until the budget runs out; the rest are deferred and go
+    // first next tick.
+    class AiScheduler
+    {
+    public:
+        void configure(const AiConfig& config) { m_config = config; }
+        const AiConfig& config() const { return m_config; }
+
+        // Forget the round-robin position and counters (new world).
+        void reset();
+
+        // One tick: think what fits in the budget, then steer everyone.
+        // `playerViewer` in `sight` stands where the player does: an enemy
+        // sees the player when its tile is in that field (shadowcasting is
+        // symmetric), and it's only cast if an enemy in range asks.
+        // `scratch` is the per-tick arena for the batched collision test.
+        void update(std::vector<Enemy>& enemies, const TileMap& map, Visibility& sight,
+                    Visibility::ViewerId playerViewer, float playerX, float playerY, std::uint64_t tick,
+                    float dtSec, Arena& scratch);
+
+        const AiStats& stats() const    { return m_stats; }
+        const AiStats& lastTick() const { return m_lastTick; }
+
+        // Totals to the log.
+        void logSummary() const;
+
+    private:
+        float thinkWeight(const Enemy& enemy, float playerX, float playerY) const;
+        void think(Enemy& enemy, std::size_t index, Visibility& sight, Visibility::ViewerId playerViewer,
+                   float playerX, float playerY, std::uint64_t tick) const;
+        // returns pixel steps (see AiStats)
+        std::uint64_t steer(std::vector<Enemy>& enemies, const TileMap& map, float playerX, float playerY,
+                            float dtSec, Arena& scratch);
+
+        AiConfig m_config;
+        std::size_t m_cursor = 0; // first enemy looked at next tick
+        AiStats m_stats;
+        AiStats m_lastTick;
+    };
+}
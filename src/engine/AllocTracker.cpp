@@ -0,0 +1,375 @@
+#include "AllocTracker.h"
+
+// Only the tracking build replaces operator new / delete.
+#ifdef ZELDA_TRACK_ALLOCS
+
+#include <SDL2/SDL.h>
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+#if defined(_MSC_VER)
+    #include <malloc.h>
+    #include <intrin.h>
+    #define ZELDA_CALL_SITE() reinterpret_cast<std::uintptr_t>(_ReturnAddress())
+#else
+    #define ZELDA_CALL_SITE() reinterpret_cast<std::uintptr_t>(__builtin_return_address(0))
+#endif
+
+#if defined(__APPLE__)
+    #include <malloc/malloc.h>
+#elif defined(__GLIBC__) || defined(__linux__)
+    #include <malloc.h>
+#endif
+
+namespace zelda::game
+{
+    namespace
+    {
+        // Nothing in here may allocate: it runs inside operator new.
+        // Everything is fixed-size and zero-initialised before main().
+
+        constexpr int STAGE_COUNT = static_cast<int>(AllocStage::Count);
+        constexpr int SITE_SLOTS  = 256; // per stage, open addressing
+        constexpr int VIOLATION_RING = 32;
+
+        const char* const STAGE_NAMES[STAGE_COUNT] = {"other", "init", "input", "update", "render"};
+
+        struct Site
+        {
+            std::atomic<std::uintptr_t> addr;  // 0 = free slot
+            std::atomic<std::uint64_t>  count;
+            std::atomic<std::uint64_t>  bytes;
+        };
+
+        struct StageCounters
+        {
+            std::atomic<std::uint64_t> allocs;
+            std::atomic<std::uint64_t> frees;
+            std::atomic<std::uint64_t> bytes;
+            std::atomic<std::uint64_t> frameAllocs;
+            std::uint64_t maxAllocsPerFrame; // main thread only (endFrame)
+
+            Site sites[SITE_SLOTS];
+            std::atomic<std::uint64_t> droppedSites; // table full
+        };
+
+        struct Violation
+        {
+            AllocStage stage;
+            std::uintptr_t site;
+            std::size_t bytes;
+        };
+
+        StageCounters g_stages[STAGE_COUNT];
+
+        std::atomic<bool> g_steady;
+        std::atomic<std::uint64_t> g_violations;
+        Violation g_violationRing[VIOLATION_RING];
+        std::uint64_t g_violationsReported; // main thread only
+
+        std::atomic<std::size_t> g_liveBytes;
+        std::atomic<std::size_t> g_peakBytes;
+
+        thread_local AllocStage t_stage = AllocStage::Other;
+        thread_local int t_allow = 0;
+
+        void recordSite(StageCounters& s, std::uintptr_t site, std::size_t bytes)
+        {
+            std::size_t h = (site >> 4) * 0x9E3779B97F4A7C15ull;
+            for (int probe = 0; probe < SITE_SLOTS; ++probe)
+            {
+                Site& slot = s.sites[(h + probe) % SITE_SLOTS];
+                std::uintptr_t cur = slot.addr.load(std::memory_order_relaxed);
+                if (cur == 0)
+                {
+                    std::uintptr_t expected = 0;
+                    if (slot.addr.compare_exchange_strong(expected, site, std::memory_order_relaxed))
+                        cur = site;
+                    else
+                        cur = expected; // someone else took it
+                }
+                if (cur == site)
+                {
+                    slot.count.fetch_add(1, std::memory_order_relaxed);
+                    slot.bytes.fetch_add(bytes, std::memory_order_relaxed);
+                    return;
+                }
+            }
+            s.droppedSites.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        // What the allocator really handed out, so frees can be subtracted
+        // without a size header. 0 where the platform can't tell us.
+        std::size_t usableSize(void* p, bool aligned)
+        {
+#if defined(_MSC_VER)
+            return aligned ? _aligned_msize(p, 1, 0) : _msize(p);
+#elif defined(__APPLE__)
+            (void)aligned;
+            return malloc_size(p);
+#elif defined(__GLIBC__) || defined(__linux__)
+            (void)aligned;
+            return malloc_usable_size(p);
+#else
+            (void)p;
+            (void)aligned;
+            return 0;
+#endif
+        }
+
+        void addLive(std::size_t bytes)
+        {
+            const std::size_t live = g_liveBytes.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+            std::size_t peak = g_peakBytes.load(std::memory_order_relaxed);
+            while (live > peak && !g_peakBytes.compare_exchange_weak(peak, live, std::memory_order_relaxed))
+            {
+            }
+        }
+
+        void onAlloc(std::size_t bytes, std::uintptr_t site)
+        {
+            const AllocStage stage = t_stage;
+            StageCounters& s = g_stages[static_cast<int>(stage)];
+            s.allocs.fetch_add(1, std::memory_order_relaxed);
+            s.bytes.fetch_add(bytes, std::memory_order_relaxed);
+            s.frameAllocs.fetch_add(1, std::memory_order_relaxed);
+            recordSite(s, site, bytes);
+
+            if (t_allow == 0 &&
+                (stage == AllocStage::Update || stage == AllocStage::Render) &&
+                g_steady.load(std::memory_order_relaxed))
+            {
+                std::uint64_t n = g_violations.fetch_add(1, std::memory_order_relaxed);
+                g_violationRing[n % VIOLATION_RING] = Violation{stage, site, bytes};
+
+#ifdef ZELDA_ALLOC_ASSERT
+                std::fprintf(stderr, "AllocTracker: %zu byte allocation in steady-state %s stage (site %p)\n",
+                             bytes, STAGE_NAMES[static_cast<int>(stage)], reinterpret_cast<void*>(site));
+                std::abort();
+#endif
+            }
+        }
+
+        void onFree(void* p, bool aligned = false)
+        {
+            if (!p)
+                return;
+            g_stages[static_cast<int>(t_stage)].frees.fetch_add(1, std::memory_order_relaxed);
+            g_liveBytes.fetch_sub(usableSize(p, aligned), std::memory_order_relaxed);
+        }
+
+        void* allocOrThrow(std::size_t bytes, std::uintptr_t site)
+        {
+            void* p = std::malloc(bytes ? bytes : 1);
+            if (!p)
+                throw std::bad_alloc();
+            onAlloc(bytes, site);
+            addLive(usableSize(p, false));
+            return p;
+        }
+
+        void* allocNoThrow(std::size_t bytes, std::uintptr_t site) noexcept
+        {
+            void* p = std::malloc(bytes ? bytes : 1);
+            if (p)
+            {
+                onAlloc(bytes, site);
+                addLive(usableSize(p, false));
+            }
+            return p;
+        }
+
+        void* alignedAlloc(std::size_t bytes, std::size_t align, std::uintptr_t site) noexcept
+        {
+            if (bytes == 0)
+                bytes = 1;
+#if defined(_MSC_VER)
+            void* p = _aligned_malloc(bytes, align);
+#else
+            // aligned_alloc wants a multiple of the alignment
+            void* p = std::aligned_alloc(align, (bytes + align - 1) / align * align);
+#endif
+            if (p)
+            {
+                onAlloc(bytes, site);
+                addLive(usableSize(p, true));
+            }
+            return p;
+        }
+
+        void alignedFree(void* p) noexcept
+        {
+            onFree(p, true);
+#if defined(_MSC_VER)
+            _aligned_free(p);
+#else
+            std::free(p);
+#endif
+        }
+    }
+
+    void AllocTracker::setStage(AllocStage stage) { t_stage = stage; }
+    AllocStage AllocTracker::stage() { return t_stage; }
+
+    void AllocTracker::pushAllow() { ++t_allow; }
+    void AllocTracker::popAllow()  { --t_allow; }
+
+    void AllocTracker::setSteadyState(bool on) { g_steady.store(on, std::memory_order_relaxed); }
+    bool AllocTracker::steadyState() { return g_steady.load(std::memory_order_relaxed); }
+
+    void AllocTracker::endFrame()
+    {
+        for (auto& s : g_stages)
+        {
+            std::uint64_t n = s.frameAllocs.exchange(0, std::memory_order_relaxed);
+            if (n > s.maxAllocsPerFrame)
+                s.maxAllocsPerFrame = n;
+        }
+
+        // report what happened this frame (outside operator new, logging is fine here)
+        const std::uint64_t total = g_violations.load(std::memory_order_relaxed);
+        if (total == g_violationsReported)
+            return;
+
+        std::uint64_t first = g_violationsReported;
+        if (total - first > VIOLATION_RING)
+            first = total - VIOLATION_RING; // older ones were overwritten
+        for (std::uint64_t i = first; i < total; ++i)
+        {
+            const Violation& v = g_violationRing[i % VIOLATION_RING];
+            SDL_Log("AllocTracker: %zu byte allocation in steady-state %s stage (site %p)",
+                    v.bytes, STAGE_NAMES[static_cast<int>(v.stage)], reinterpret_cast<void*>(v.site));
+        }
+        g_violationsReported = total;
+    }
+
+    AllocStageStats AllocTracker::stats(AllocStage stage)
+    {
+        const StageCounters& s = g_stages[static_cast<int>(stage)];
+        AllocStageStats out;
+        out.allocs = s.allocs.load(std::memory_order_relaxed);
+        out.frees  = s.frees.load(std::memory_order_relaxed);
+        out.bytes  = s.bytes.load(std::memory_order_relaxed);
+        out.maxAllocsPerFrame = s.maxAllocsPerFrame;
+        return out;
+    }
+
+    std::uint64_t AllocTracker::violationCount()
+    {
+        return g_violations.load(std::memory_order_relaxed);
+    }
+
+    std::size_t AllocTracker::liveBytes()     { return g_liveBytes.load(std::memory_order_relaxed); }
+    std::size_t AllocTracker::peakLiveBytes() { return g_peakBytes.load(std::memory_order_relaxed); }
+    void AllocTracker::resetPeak()            { g_peakBytes.store(liveBytes(), std::memory_order_relaxed); }
+
+    void AllocTracker::logSummary()
+    {
+        constexpr int TOP_SITES = 5;
+
+        SDL_Log("AllocTracker summary (addresses resolve with addr2line -e <binary>):");
+        for (int i = 0; i < STAGE_COUNT; ++i)
+        {
+            const StageCounters& s = g_stages[i];
+            AllocStageStats st = stats(static_cast<AllocStage>(i));
+            SDL_Log("  %-6s %8llu allocs %8llu frees %10llu bytes, max %llu allocs / frame",
+                    STAGE_NAMES[i],
+                    static_cast<unsigned long long>(st.allocs),
+                    static_cast<unsigned long long>(st.frees),
+                    static_cast<unsigned long long>(st.bytes),
+                    static_cast<unsigned long long>(st.maxAllocsPerFrame));
+
+            // top call sites by count (small fixed insertion sort)
+            const Site* top[TOP_SITES] = {};
+            for (const Site& site : s.sites)
+            {
+                if (site.addr.load(std::memory_order_relaxed) == 0)
+                    continue;
+                const std::uint64_t c = site.count.load(std::memory_order_relaxed);
+                for (int k = 0; k < TOP_SITES; ++k)
+                {
+                    if (!top[k] || c > top[k]->count.load(std::memory_order_relaxed))
+                    {
+                        for (int m = TOP_SITES - 1; m > k; --m)
+                            top[m] = top[m - 1];
+                        top[k] = &site;
+                        break;
+                    }
+                }
+            }
+            for (const Site* site : top)
+            {
+                if (!site)
+                    break;
+                SDL_Log("         %p: %llu allocs, %llu bytes",
+                        reinterpret_cast<void*>(site->addr.load(std::memory_order_relaxed)),
+                        static_cast<unsigned long long>(site->count.load(std::memory_order_relaxed)),
+                        static_cast<unsigned long long>(site->bytes.load(std::memory_order_relaxed)));
+            }
+            if (std::uint64_t dropped = s.droppedSites.load(std::memory_order_relaxed))
+                SDL_Log("         (%llu allocs from untracked sites)", static_cast<unsigned long long>(dropped));
+        }
+
+        const std::uint64_t violations = violationCount();
+        if (violations == 0)
+            SDL_Log("  steady state: no allocations in update / render");
+        else
+            SDL_Log("  steady state: %llu allocation(s) in update / render!",
+                    static_cast<unsigned long long>(violations));
+    }
+}
+
+// --- global replacements ---
+
+using zelda::game::allocOrThrow;
+using zelda::game::allocNoThrow;
+using zelda::game::alignedAlloc;
+using zelda::game::alignedFree;
+using zelda::game::onFree;
+
+void* operator new(std::size_t size)   { return allocOrThrow(size, ZELDA_CALL_SITE()); }
+void* operator new[](std::size_t size) { return allocOrThrow(size, ZELDA_CALL_SITE()); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept   { return allocNoThrow(size, ZELDA_CALL_SITE()); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return allocNoThrow(size, ZELDA_CALL_SITE()); }
+
+void operator delete(void* p) noexcept   { onFree(p); std::free(p); }
+void operator delete[](void* p) noexcept { onFree(p); std::free(p); }
+void operator delete(void* p, std::size_t) noexcept   { onFree(p); std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { onFree(p); std::free(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept   { onFree(p); std::free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { onFree(p); std::free(p); }
+
+void* operator new(std::size_t size, std::align_val_t align)
+{
+    void* p = alignedAlloc(size, static_cast<std::size_t>(align), ZELDA_CALL_SITE());
+    if (!p)
+        throw std::bad_alloc();
+    return p;
+}
+void* operator new[](std::size_t size, std::align_val_t align)
+{
+    void* p = alignedAlloc(size, static_cast<std::size_t>(align), ZELDA_CALL_SITE());
+    if (!p)
+        throw std::bad_alloc();
+    return p;
+}
+void* operator new(std::size_t size, std::align_val_t align, const std::nothrow_t&) noexcept
+{
+    return alignedAlloc(size, static_cast<std::size_t>(align), ZELDA_CALL_SITE());
+}
+void* operator new[](std::size_t size, std::align_val_t align, const std::nothrow_t&) noexcept
+{
+    return alignedAlloc(size, static_cast<std::size_t>(align), ZELDA_CALL_SITE());
+}
+
+void operator delete(void* p, std::align_val_t) noexcept   { alignedFree(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { alignedFree(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept   { alignedFree(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { alignedFree(p); }
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept   { alignedFree(p); }
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept { alignedFree(p); }
+
+#endif // ZELDA_TRACK_ALLOCS
@@ -0,0 +1,123 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+
+namespace zelda::game
+{
+    // Heap allocation tracking (build with -DZELDA_TRACK_ALLOCS=ON).
+    //
+    // The tracking build replaces global operator new / delete and counts
+    // allocations, bytes and call sites per frame stage. The stage is set
+    // per thread with AllocStageScope; anything outside a scope (or on
+    // another thread, e.g. the room prefetcher) lands in Other.
+    //
+    // Steady state: once the game has warmed up the engine calls
+    // setSteadyState(true). From then on any allocation made while in the
+    // Update or Render stage is a violation, unless it is inside an
+    // AllocAllowScope (room / texture loading is allowed to allocate).
+    // Violations are logged at the end of the frame and in the shutdown
+    // summary; with -DZELDA_ALLOC_ASSERT=ON the first one asserts instead.
+    //
+    // In normal builds every call here is an empty inline function.
+
+    enum class AllocStage : int
+    {
+        Other = 0,
+        Init,
+        Input,
+        Update,
+        Render,
+        Count
+    };
+
+    struct AllocStageStats
+    {
+        std::uint64_t allocs = 0;
+        std::uint64_t frees  = 0;
+        std::uint64_t bytes  = 0;
+        std::uint64_t maxAllocsPerFrame = 0;
+    };
+
+    class AllocTracker
+    {
+    public:
+#ifdef ZELDA_TRACK_ALLOCS
+        static constexpr bool enabled() { return true; }
+
+        static void setStage(AllocStage stage);
+        static AllocStage stage();
+
+        static void pushAllow();
+        static void popAllow();
+
+        static void setSteadyState(bool on);
+        static bool steadyState();
+
+        // Close the current frame: per-frame maxima, log new violations.
+        static void endFrame();
+
+        static AllocStageStats stats(AllocStage stage);
+        static std::uint64_t violationCount();
+
+        // Heap bytes currently allocated (usable size, all threads) and the
+        // high-water mark since the last resetPeak().
+        static std::size_t liveBytes();
+        static std::size_t peakLiveBytes();
+        static void resetPeak();
+
+        // Per stage totals + top call sites, through SDL_Log.
+        static void logSummary();
+#else
+        static constexpr bool enabled() { return false; }
+
+        static void setStage(AllocStage) {}
+        static AllocStage stage() { return AllocStage::Other; }
+
+        static void pushAllow() {}
+        static void popAllow() {}
+
+        static void setSteadyState(bool) {}
+        static bool steadyState() { return false; }
+
+        static void endFrame() {}
+
+        static AllocStageStats stats(AllocStage) { return AllocStageStats{}; }
+        static std::uint64_t violationCount() { return 0; }
+
+        static std::size_t liveBytes() { return 0; }
+        static std::size_t peakLiveBytes() { return 0; }
+        static void resetPeak() {}
+
+        static void logSummary() {}
+#endif
+    };
+
+    // Marks the current thread as being in `stage` until the scope ends.
+    class AllocStageScope
+    {
+    public:
+        explicit AllocStageScope(AllocStage stage)
+        : m_prev(AllocTracker::stage())
+        {
+            AllocTracker::setStage(stage);
+        }
+        ~AllocStageScope() { AllocTracker::setStage(m_prev); }
+
+        AllocStageScope(const AllocStageScope&) = delete;
+        AllocStageScope& operator=(const AllocStageScope&) = delete;
+
+    private:
+        AllocStage m_prev;
+    };
+
+    // Allocations in here are expected (loading) and never count as violations.
+    class AllocAllowScope
+    {
+    public:
+        AllocAllowScope()  { AllocTracker::pushAllow(); }
+        ~AllocAllowScope() { AllocTracker::popAllow(); }
+
+        AllocAllowScope(const AllocAllowScope&) = delete;
+        AllocAllowScope& operator=(const AllocAllowScope&) = delete;
+    };
+}
@@ -0,0 +1,186 @@
+#pragma once
+#include <vector>
+#include <memory>
+#include <new>
+#include <cstdint>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+namespace zelda::game
+{
+    // Linear (bump) allocator.
+    //
+    // allocate() just moves a cursor forward; nothing is freed on its own.
+    // reset() drops everything at once. Two uses in the engine:
+    //
+    //   frame arena - scratch for one tick, reset at the start of every step
+    //   level arena - room / tile data, reset when the level (world) unloads
+    //
+    // Memory comes in blocks. If a block runs out another one is chained on;
+    // reset() then merges them into one block big enough for the peak, so
+    // after a warm-up tick or two a frame arena never touches the heap again.
+    //
+    // Destructors are NOT run on reset(). Only put trivially destructible
+    // things in here directly (make<T>() checks), or containers that use
+    // ArenaAllocator and don't outlive the arena.
+    class Arena
+    {
+    public:
+        explicit Arena(const char* name, std::size_t blockBytes = 64 * 1024)
+        : m_name(name)
+        , m_blockBytes(blockBytes)
+        {
+        }
+
+        Arena(const Arena&) = delete;
+        Arena& operator=(const Arena&) = delete;
+
+        void* allocate(std::size_t bytes, std::size_t align = alignof(std::max_align_t))
+        {
+            if (bytes == 0)
+                bytes = 1;
+
+            void* p = m_blocks.empty() ? nullptr : bump(m_blocks.back(), bytes, align);
+            if (!p)
+            {
+                addBlock(std::max(m_blockBytes, bytes + align));
+                p = bump(m_blocks.back(), bytes, align);
+            }
+
+            m_used += bytes;
+            if (m_used > m_peak)
+                m_peak = m_used;
+            return p;
+        }
+
+        template <typename T, typename... Args>
+        T* make(Args&&... args)
+        {
+            static_assert(std::is_trivially_destructible<T>::value,
+                          "arena objects are never destroyed");
+            return new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+        }
+
+        // Free everything. Pointers handed out before are dead after this.
+        void reset()
+        {
+            if (m_blocks.size() > 1)
+            {
+                std::size_t total = capacity();
+                m_blocks.clear();
+                addBlock(total);
+            }
+            if (!m_blocks.empty())
+                m_blocks.front().used = 0;
+            m_used = 0;
+            ++m_resets;
+        }
+
+        // Return every block to the heap (stats are kept).
+        void release()
+        {
+            m_blocks.clear();
+            m_used = 0;
+        }
+
+        // --- stats ---
+        const char* name() const     { return m_name; }
+        std::size_t used() const     { return m_used; }  // requested bytes since reset
+        std::size_t peak() const     { return m_peak; }  // max used() ever seen
+        std::size_t blockCount() const { return m_blocks.size(); }
+        std::uint64_t resetCount() const { return m_resets; }
+        std::size_t capacity() const
+        {
+            std::size_t total = 0;
+            for (const auto& b : m_blocks)
+                total += b.size;
+            return total;
+        }
+
+    private:
+        struct Block
+        {
+            std::unique_ptr<std::max_align_t[]> mem;
+            std::size_t size = 0; // bytes
+            std::size_t used = 0;
+        };
+
+        void addBlock(std::size_t bytes)
+        {
+            Block b;
+            std::size_t words = (bytes + sizeof(std::max_align_t) - 1) / sizeof(std::max_align_t);
+            b.mem.reset(new std::max_align_t[words]);
+            b.size = words * sizeof(std::max_align_t);
+            m_blocks.push_back(std::move(b));
+        }
+
+        static void* bump(Block& b, std::size_t bytes, std::size_t align)
+        {
+            std::uintptr_t base = reinterpret_cast<std::uintptr_t>(b.mem.get());
+            std::uintptr_t p = (base + b.used + (align - 1)) & ~static_cast<std::uintptr_t>(align - 1);
+            if (p + bytes > base + b.size)
+                return nullptr;
+            b.used = (p + bytes) - base;
+            return reinterpret_cast<void*>(p);
+        }
+
+        const char* m_name;
+        std::size_t m_blockBytes;
+        std::vector<Block> m_blocks;
+
+        std::size_t m_used = 0;
+        std::size_t m_peak = 0;
+        std::uint64_t m_resets = 0;
+    };
+
+    // STL allocator on top of an Arena, so containers can opt in:
+    //
+    //   ArenaVector<int> ids{ArenaAllocator<int>(&frameArena)};
+    //
+    // deallocate() is a no-op (the arena frees in bulk), so reserve() up
+    // front when you can: every regrow leaves the old buffer behind until
+    // reset. A null arena falls back to the normal heap, which makes
+    // ArenaVector a drop-in default for members that may or may not get one.
+    template <typename T>
+    class ArenaAllocator
+    {
+    public:
+        using value_type = T;
+        using propagate_on_container_copy_assignment = std::true_type;
+        using propagate_on_container_move_assignment = std::true_type;
+        using propagate_on_container_swap            = std::true_type;
+
+        ArenaAllocator() noexcept = default;
+        explicit ArenaAllocator(Arena* arena) noexcept : m_arena(arena) {}
+
+        template <typename U>
+        ArenaAllocator(const ArenaAllocator<U>& other) noexcept : m_arena(other.arena()) {}
+
+        T* allocate(std::size_t n)
+        {
+            if (!m_arena)
+                return static_cast<T*>(::operator new(n * sizeof(T)));
+            return static_cast<T*>(m_arena->allocate(n * sizeof(T), alignof(T)));
+        }
+
+        void deallocate(T* p, std::size_t) noexcept
+        {
+            if (!m_arena)
+                ::operator delete(p);
+        }
+
+        Arena* arena() const noexcept { return m_arena; }
+
+    private:
+        Arena* m_arena = nullptr;
+    };
+
+    template <typename T, typename U>
+    bool operator==(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) { return a.arena() == b.arena(); }
+    template <typename T, typename U>
+    bool operator!=(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) { return a.arena() != b.arena(); }
+
+    template <typename T>
+    using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+}
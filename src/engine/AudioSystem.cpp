@@ -0,0 +1,390 @@
+#include "AudioSystem.h"
+#include "Log.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__AVX__)
+    #include <immintrin.h>
+    #define ZELDA_AUDIO_AVX 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define ZELDA_AUDIO_SSE2 1
+#endif
+
+namespace zelda::game
+{
+    namespace
+    {
+        // out[i] += src[i] * gain, for `frames` interleaved stereo frames
+        void mixSpan(float* out, const float* src, std::size_t frames, float gainL, float gainR)
+        {
+            std::size_t i = 0;
+            const std::size_t n = frames * 2;
+#if defined(ZELDA_AUDIO_AVX)
+            const __m256 g = _mm256_setr_ps(gainL, gainR, gainL, gainR, gainL, gainR, gainL, gainR);
+            for (; i + 8 <= n; i += 8)
+            {
+                __m256 o = _mm256_loadu_ps(out + i);
+                __m256 s = _mm256_loadu_ps(src + i);
+                _mm256_storeu_ps(out + i, _mm256_add_ps(o, _mm256_mul_ps(s, g)));
+            }
+#elif defined(ZELDA_AUDIO_SSE2)
+            const __m128 g = _mm_setr_ps(gainL, gainR, gainL, gainR);
+            for (; i + 4 <= n; i += 4)
+            {
+                __m128 o = _mm_loadu_ps(out + i);
+                __m128 s = _mm_loadu_ps(src + i);
+                _mm_storeu_ps(out + i, _mm_add_ps(o, _mm_mul_ps(s, g)));
+            }
+#endif
+            for (; i < n; i += 2)
+            {
+                out[i]     += src[i] * gainL;
+                out[i + 1] += src[i + 1] * gainR;
+            }
+        }
+
+        // hard clip to [-1, 1]
+        void clipSpan(float* out, std::size_t n)
+        {
+            std::size_t i = 0;
+#if defined(ZELDA_AUDIO_AVX)
+            const __m256 lo = _mm256_set1_ps(-1.0f);
+            const __m256 hi = _mm256_set1_ps(1.0f);
+            for (; i + 8 <= n; i += 8)
+                _mm256_storeu_ps(out + i, _mm256_min_ps(hi, _mm256_max_ps(lo, _mm256_loadu_ps(out + i))));
+#elif defined(ZELDA_AUDIO_SSE2)
+            const __m128 lo = _mm_set1_ps(-1.0f);
+            const __m128 hi = _mm_set1_ps(1.0f);
+            for (; i + 4 <= n; i += 4)
+                _mm_storeu_ps(out + i, _mm_min_ps(hi, _mm_max_ps(lo, _mm_loadu_ps(out + i))));
+#endif
+            for (; i < n; ++i)
+                out[i] = std::clamp(out[i], -1.0f, 1.0f);
+        }
+    }
+
+    const char* AudioSystem::kernelName()
+    {
+#if defined(ZELDA_AUDIO_AVX)
+        return "AVX";
+#elif defined(ZELDA_AUDIO_SSE2)
+        return "SSE2";
+#else
+        return "scalar";
+#endif
+    }
+
+    bool AudioSystem::init()
+    {
+        shutdown();
+
+        SDL_AudioSpec want{};
+        want.freq = FREQUENCY;
+        want.format = AUDIO_F32SYS;
+        want.channels = CHANNELS;
+        want.samples = BUFFER_FRAMES;
+        want.callback = &AudioSystem::audioCallback;
+        want.userdata = this;
+
+        // No allowed changes: SDL converts to the hardware format behind the
+        // callback, so our buffer is always float stereo at FREQUENCY.
+        SDL_AudioSpec have;
+        m_device = SDL_OpenAudioDevice(nullptr, 0, &want, &have, 0);
+        if (m_device == 0)
+        {
+            ZLOG_WARN("AudioSystem: no audio device (%s), running silent", SDL_GetError());
+            return false;
+        }
+        m_deviceFrequency = have.freq;
+
+        SDL_PauseAudioDevice(m_device, 0);
+        return true;
+    }
+
+    void AudioSystem::shutdown()
+    {
+        if (m_device != 0)
+        {
+            // waits for a running callback to return
+            SDL_CloseAudioDevice(m_device);
+            m_device = 0;
+        }
+
+        // nobody else reads these now
+        Command cmd;
+        while (m_commands.pop(cmd)) {}
+        for (auto& v : m_voices)
+            v = Voice{};
+        m_activeVoices.store(0, std::memory_order_relaxed);
+
+        const int count = m_sampleCount.load(std::memory_order_relaxed);
+        for (int i = 0; i < count; ++i)
+            m_samples[i] = Sample{};
+        m_sampleCount.store(0, std::memory_order_relaxed);
+    }
+
+    SoundId AudioSystem::publish(std::vector<float>&& stereo, std::size_t frames)
+    {
+        const int index = m_sampleCount.load(std::memory_order_relaxed);
+        if (index >= MAX_SAMPLES || frames == 0)
+            return -1;
+
+        m_samples[index].frames = std::move(stereo);
+        m_samples[index].frameCount = frames;
+
+        // the mixer may look at it from now on
+        m_sampleCount.store(index + 1, std::memory_order_release);
+        return index;
+    }
+
+    SoundId AudioSystem::addSamples(const float* stereo, std::size_t frames)
+    {
+        return publish(std::vector<float>(stereo, stereo + frames * CHANNELS), frames);
+    }
+
+    SoundId AudioSystem::loadWav(const char* path)
+    {
+        SDL_AudioSpec spec;
+        Uint8* wavBuf = nullptr;
+        Uint32 wavLen = 0;
+        if (!SDL_LoadWAV(path, &spec, &wavBuf, &wavLen))
+            return -1;
+
+        // convert once, here, to exactly what the mixer wants
+        SDL_AudioCVT cvt;
+        if (SDL_BuildAudioCVT(&cvt, spec.format, spec.channels, spec.freq,
+                              AUDIO_F32SYS, CHANNELS, m_deviceFrequency) < 0)
+        {
+            ZLOG_WARN("AudioSystem: can't convert %s: %s", path, SDL_GetError());
+            SDL_FreeWAV(wavBuf);
+            return -1;
+        }
+
+        std::vector<Uint8> bytes(static_cast<std::size_t>(wavLen) * std::max(1, cvt.len_mult));
+        std::memcpy(bytes.data(), wavBuf, wavLen);
+        SDL_FreeWAV(wavBuf);
+
+        std::size_t outBytes = wavLen;
+        if (cvt.needed)
+        {
+            cvt.buf = bytes.data();
+            cvt.len = static_cast<int>(wavLen);
+            if (SDL_ConvertAudio(&cvt) < 0)
+            {
+                ZLOG_WARN("AudioSystem: can't convert %s: %s", path, SDL_GetError());
+                return -1;
+            }
+            outBytes = static_cast<std::size_t>(cvt.len_cvt);
+        }
+
+        const std::size_t frames = outBytes / (sizeof(float) * CHANNELS);
+        std::vector<float> stereo(frames * CHANNELS);
+        std::memcpy(stereo.data(), bytes.data(), stereo.size() * sizeof(float));
+        return publish(std::move(stereo), frames);
+    }
+
+    SoundId AudioSystem::synthBlip(float startHz, float endHz, float seconds, float noise)
+    {
+        const std::size_t frames = static_cast<std::size_t>(seconds * m_deviceFrequency);
+        std::vector<float> stereo(frames * CHANNELS);
+
+        const float twoPi = 6.2831853f;
+        float phase = 0.0f;
+        std::uint32_t rng = 0x9E3779B9u;
+        for (std::size_t i = 0; i < frames; ++i)
+        {
+            const float t = static_cast<float>(i) / static_cast<float>(frames);
+            const float hz = startHz + (endHz - startHz) * t;
+            phase += twoPi * hz / m_deviceFrequency;
+            if (phase > twoPi)
+                phase -= twoPi;
+
+            rng ^= rng << 13;
+            rng ^= rng >> 17;
+            rng ^= rng << 5;
+            const float white = static_cast<float>(rng >> 8) * (2.0f / 16777216.0f) - 1.0f;
+
+            const float envelope = (1.0f - t) * (1.0f - t);
+            const float s = ((1.0f - noise) * std::sin(phase) + noise * white) * envelope * 0.5f;
+            stereo[i * 2] = s;
+            stereo[i * 2 + 1] = s;
+        }
+        return publish(std::move(stereo), frames);
+    }
+
+    void AudioSystem::panGains(float gain, float pan, float& outL, float& outR)
+    {
+        // equal power: centre is -3dB per side, hard left / right is full
+        const float angle = (std::clamp(pan, -1.0f, 1.0f) + 1.0f) * 0.25f * 3.14159265f;
+        outL = gain * std::cos(angle);
+        outR = gain * std::sin(angle);
+    }
+
+    bool AudioSystem::send(const Command& cmd)
+    {
+        if (m_device == 0)
+            return false;
+        if (!m_commands.push(cmd))
+        {
+            ++m_droppedCommands; // mixer is behind; a lost blip beats a stalled frame
+            return false;
+        }
+        return true;
+    }
+
+    VoiceHandle AudioSystem::play(SoundId sound, float gain, float pan, bool loop)
+    {
+        if (sound < 0)
+            return 0;
+
+        Command cmd{Command::Type::Play, m_nextHandle, sound, 0.0f, 0.0f, loop};
+        panGains(gain, pan, cmd.gainL, cmd.gainR);
+        if (!send(cmd))
+            return 0;
+
+        VoiceHandle handle = m_nextHandle++;
+        if (m_nextHandle == 0)
+            m_nextHandle = 1;
+        return handle;
+    }
+
+    void AudioSystem::stop(VoiceHandle voice)
+    {
+        if (voice != 0)
+            send(Command{Command::Type::Stop, voice, -1, 0.0f, 0.0f, false});
+    }
+
+    void AudioSystem::setGain(VoiceHandle voice, float gain, float pan)
+    {
+        if (voice == 0)
+            return;
+        Command cmd{Command::Type::SetGain, voice, -1, 0.0f, 0.0f, false};
+        panGains(gain, pan, cmd.gainL, cmd.gainR);
+        send(cmd);
+    }
+
+    void AudioSystem::stopAll()
+    {
+        send(Command{Command::Type::StopAll, 0, -1, 0.0f, 0.0f, false});
+    }
+
+    // ---- audio thread from here on: no locks, no allocation ----
+
+    void SDLCALL AudioSystem::audioCallback(void* userdata, Uint8* stream, int len)
+    {
+        auto* self = static_cast<AudioSystem*>(userdata);
+        self->mix(reinterpret_cast<float*>(stream), len / static_cast<int>(sizeof(float) * CHANNELS));
+    }
+
+    void AudioSystem::startVoice(const Command& cmd)
+    {
+        if (cmd.sound < 0 || cmd.sound >= m_sampleCount.load(std::memory_order_acquire))
+            return;
+
+        // free voice, else steal the oldest one-shot, else the oldest loop
+        Voice* target = nullptr;
+        for (auto& v : m_voices)
+        {
+            if (v.handle == 0)
+            {
+                target = &v;
+                break;
+            }
+        }
+        if (!target)
+        {
+            for (auto& v : m_voices)
+            {
+                if (!target ||
+                    (target->loop && !v.loop) ||
+                    (target->loop == v.loop && v.started < target->started))
+                    target = &v;
+            }
+            m_stolenVoices.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        const Sample& sample = m_samples[cmd.sound];
+        target->handle = cmd.voice;
+        target->data = sample.frames.data();
+        target->frameCount = sample.frameCount;
+        target->pos = 0;
+        target->gainL = cmd.gainL;
+        target->gainR = cmd.gainR;
+        target->loop = cmd.loop;
+        target->started = ++m_voiceClock;
+    }
+
+    void AudioSystem::runCommands()
+    {
+        Command cmd;
+        while (m_commands.pop(cmd))
+        {
+            switch (cmd.type)
+            {
+                case Command::Type::Play:
+                    startVoice(cmd);
+                    break;
+                case Command::Type::Stop:
+                    for (auto& v : m_voices)
+                        if (v.handle == cmd.voice)
+                            v.handle = 0;
+                    break;
+                case Command::Type::SetGain:
+                    for (auto& v : m_voices)
+                    {
+                        if (v.handle == cmd.voice)
+                        {
+                            v.gainL = cmd.gainL;
+                            v.gainR = cmd.gainR;
+                        }
+                    }
+                    break;
+                case Command::Type::StopAll:
+                    for (auto& v : m_voices)
+                        v.handle = 0;
+                    break;
+            }
+        }
+    }
+
+    void AudioSystem::mix(float* out, int frames)
+    {
+        runCommands();
+
+        std::memset(out, 0, static_cast<std::size_t>(frames) * CHANNELS * sizeof(float));
+
+        int active = 0;
+        for (auto& v : m_voices)
+        {
+            if (v.handle == 0)
+                continue;
+
+            std::size_t done = 0;
+            while (done < static_cast<std::size_t>(frames))
+            {
+                const std::size_t chunk = std::min(static_cast<std::size_t>(frames) - done, v.frameCount - v.pos);
+                mixSpan(out + done * CHANNELS, v.data + v.pos * CHANNELS, chunk, v.gainL, v.gainR);
+                done += chunk;
+                v.pos += chunk;
+
+                if (v.pos == v.frameCount)
+                {
+                    if (!v.loop)
+                    {
+                        v.handle = 0;
+                        break;
+                    }
+                    v.pos = 0;
+                }
+            }
+            if (v.handle != 0)
+                ++active;
+        }
+
+        clipSpan(out, static_cast<std::size_t>(frames) * CHANNELS);
+        m_activeVoices.store(active, std::memory_order_relaxed);
+    }
+}
@@ -0,0 +1,133 @@
+#pragma once
+#include <SDL2/SDL.h>
+#include <array>
+#include <atomic>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+#include "SpscRing.h"
+
+namespace zelda::game
+{
+    using SoundId = int;        // index into the sample bank, -1 = none
+    using VoiceHandle = std::uint32_t; // 0 = none
+
+    // Sample bank + software mixer running in the SDL audio callback.
+    //
+    // Samples are decoded and converted to the device format (float stereo
+    // at the device rate) when they are loaded, so the callback only ever
+    // multiplies and adds. Load everything at init; the bank is append-only
+    // and each sample is published to the audio thread with an atomic count.
+    //
+    // The game thread talks to the mixer through a lock-free SPSC command
+    // ring (play / stop / set gain). The callback drains it, mixes every
+    // active voice with per-voice left/right gain (SSE2 / AVX, scalar
+    // fallback) and never locks or allocates.
+    //
+    // Without an audio device everything still works, it's just silent.
+    class AudioSystem
+    {
+    public:
+        static constexpr int FREQUENCY   = 48000;
+        static constexpr int CHANNELS    = 2;    // interleaved L R
+        static constexpr int BUFFER_FRAMES = 512; // ~10ms per callback
+
+        static constexpr int MAX_SAMPLES = 64;
+        static constexpr int MAX_VOICES  = 32;
+
+        AudioSystem() = default;
+        ~AudioSystem() { shutdown(); }
+
+        AudioSystem(const AudioSystem&) = delete;
+        AudioSystem& operator=(const AudioSystem&) = delete;
+
+        // Open the device (SDL_INIT_AUDIO must be up). False = no sound, not fatal.
+        bool init();
+        void shutdown();
+
+        bool isOpen() const { return m_device != 0; }
+
+        // --- sample bank (game thread, before or while playing) ---
+
+        // Decode a WAV and convert it to the device format. -1 on failure.
+        SoundId loadWav(const char* path);
+
+        // Add already converted interleaved stereo frames.
+        SoundId addSamples(const float* stereo, std::size_t frames);
+
+        // Small procedural blip (pitch sweep + optional noise) for placeholder sfx.
+        SoundId synthBlip(float startHz, float endHz, float seconds, float noise);
+
+        // --- playback (game thread) ---
+
+        // pan: -1 left .. 0 centre .. 1 right (equal power)
+        VoiceHandle play(SoundId sound, float gain = 1.0f, float pan = 0.0f, bool loop = false);
+        void stop(VoiceHandle voice);
+        void setGain(VoiceHandle voice, float gain, float pan = 0.0f);
+        void stopAll();
+
+        // --- stats ---
+        std::uint64_t droppedCommands() const { return m_droppedCommands; }
+        std::uint64_t stolenVoices() const    { return m_stolenVoices.load(std::memory_order_relaxed); }
+        int activeVoices() const              { return m_activeVoices.load(std::memory_order_relaxed); }
+        static const char* kernelName();
+
+    private:
+        struct Sample
+        {
+            std::vector<float> frames; // interleaved stereo, device rate
+            std::size_t frameCount = 0;
+        };
+
+        struct Command
+        {
+            enum class Type : int { Play = 0, Stop, SetGain, StopAll };
+
+            Type type;
+            VoiceHandle voice;
+            SoundId sound;
+            float gainL;
+            float gainR;
+            bool loop;
+        };
+
+        // audio-thread only
+        struct Voice
+        {
+            VoiceHandle handle = 0; // 0 = free
+            const float* data = nullptr;
+            std::size_t frameCount = 0;
+            std::size_t pos = 0;
+            float gainL = 0.0f;
+            float gainR = 0.0f;
+            bool loop = false;
+            std::uint64_t started = 0; // for stealing the oldest
+        };
+
+        static void SDLCALL audioCallback(void* userdata, Uint8* stream, int len);
+        void mix(float* out, int frames);
+        void runCommands();
+        void startVoice(const Command& cmd);
+
+        SoundId publish(std::vector<float>&& stereo, std::size_t frames);
+        bool send(const Command& cmd);
+        static void panGains(float gain, float pan, float& outL, float& outR);
+
+        SDL_AudioDeviceID m_device = 0;
+        int m_deviceFrequency = FREQUENCY;
+
+        // bank: written by the game thread, read by the mixer below m_sampleCount
+        std::array<Sample, MAX_SAMPLES> m_samples;
+        std::atomic<int> m_sampleCount{0};
+
+        SpscRing<Command, 256> m_commands;
+        VoiceHandle m_nextHandle = 1;
+        std::uint64_t m_droppedCommands = 0;
+
+        std::array<Voice, MAX_VOICES> m_voices;
+        std::uint64_t m_voiceClock = 0;
+        std::atomic<std::uint64_t> m_stolenVoices{0};
+        std::atomic<int> m_activeVoices{0};
+    };
+}
@@ -0,0 +1,80 @@
+#include "BatchRunner.h"
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+namespace zelda::engine
+{
+    BatchRunner::BatchRunner(std::size_t worldCount, const zelda::game::WorldConfig &config, unsigned threads)
+    {
+        m_worlds.reserve(worldCount);
+        for (std::size_t i = 0; i < worldCount; ++i)
+        {
+            m_worlds.push_back(std::make_unique<zelda::game::World>());
+            m_worlds.back()->init(config);
+        }
+
+        if (threads == 0)
+            threads = std::max(1u, std::thread::hardware_concurrency());
+        // no point in more threads than worlds
+        m_threads = static_cast<unsigned>(std::max<std::size_t>(1, std::min<std::size_t>(threads, worldCount)));
+    }
+
+    BatchStats BatchRunner::run(int steps, const std::vector<std::vector<zelda::game::WorldInput>> &inputs)
+    {
+        using Clock = std::chrono::steady_clock;
+
+        BatchStats stats;
+        stats.worlds = m_worlds.size();
+        stats.threads = m_threads;
+        if (steps <= 0 || m_worlds.empty())
+            return stats;
+
+        auto start = Clock::now();
+
+        // contiguous slices, the first `extra` slices get one more world
+        const std::size_t perThread = m_worlds.size() / m_threads;
+        const std::size_t extra = m_worlds.size() % m_threads;
+
+        std::vector<std::thread> workers;
+        workers.reserve(m_threads - 1);
+
+        std::size_t begin = 0;
+        for (unsigned t = 0; t < m_threads; ++t)
+        {
+            std::size_t end = begin + perThread + (t < extra ? 1 : 0);
+            if (t + 1 == m_threads)
+                stepRange(begin, end, steps, inputs); // calling thread takes the last slice
+            else
+                workers.emplace_back(&BatchRunner::stepRange, this, begin, end, steps, std::cref(inputs));
+            begin = end;
+        }
+        for (auto &w : workers)
+            w.join();
+
+        auto end = Clock::now();
+
+        stats.steps = static_cast<std::uint64_t>(steps) * m_worlds.size();
+        stats.seconds = std::chrono::duration<double>(end - start).count();
+        stats.stepsPerSec = stats.seconds > 0.0 ? stats.steps / stats.seconds : 0.0;
+        return stats;
+    }
+
+    void BatchRunner::stepRange(std::size_t begin, std::size_t end, int steps,
+                                const std::vector<std::vector<zelda::game::WorldInput>> &inputs)
+    {
+        static const std::vector<zelda::game::WorldInput> idle(1);
+
+        // world-major: one world's state stays hot in cache for the whole run
+        for (std::size_t w = begin; w < end; ++w)
+        {
+            const std::vector<zelda::game::WorldInput> &script =
+                (w < inputs.size() && !inputs[w].empty()) ? inputs[w] : idle;
+
+            zelda::game::World &world = *m_worlds[w];
+            for (int s = 0; s < steps; ++s)
+                world.step(script[static_cast<std::size_t>(s) % script.size()]);
+        }
+    }
+}
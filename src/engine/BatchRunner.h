@@ -0,0 +1,62 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+
+#include "World.h"
+
+namespace zelda::engine
+{
+    struct BatchStats
+    {
+        std::size_t   worlds  = 0;
+        unsigned      threads = 0;
+        std::uint64_t steps   = 0;   // world-steps, summed over all worlds
+        double        seconds = 0.0; // wall clock
+        double        stepsPerSec = 0.0;
+    };
+
+    // Steps many independent Worlds at once, for agents / fuzzing / balance
+    // sweeps. No window, no SDL_Init.
+    //
+    // Worlds are split into one contiguous range per thread. Each world is
+    // only ever touched by its own thread and worlds share nothing, so no
+    // locking is needed and results don't depend on the thread count.
+    class BatchRunner
+    {
+    public:
+        // threads == 0 -> one per hardware core
+        explicit BatchRunner(std::size_t worldCount,
+                             const zelda::game::WorldConfig &config = headlessConfig(),
+                             unsigned threads = 0);
+
+        std::size_t worldCount() const { return m_worlds.size(); }
+        unsigned threadCount() const   { return m_threads; }
+
+        zelda::game::World &world(std::size_t i)             { return *m_worlds[i]; }
+        const zelda::game::World &world(std::size_t i) const { return *m_worlds[i]; }
+
+        // Advance every world `steps` ticks. inputs[w][s] is world w's input
+        // on step s; shorter scripts loop, missing / empty ones mean idle.
+        BatchStats run(int steps, const std::vector<std::vector<zelda::game::WorldInput>> &inputs);
+
+        // Default config for batch runs: no prefetch threads per world, and
+        // an AI budget in thinks rather than microseconds (same result on any machine).
+        static zelda::game::WorldConfig headlessConfig()
+        {
+            zelda::game::WorldConfig config;
+            config.backgroundLoading = false;
+            config.ai.budgetUs = 0;
+            return config;
+        }
+
+    private:
+        void stepRange(std::size_t begin, std::size_t end, int steps,
+                       const std::vector<std::vector<zelda::game::WorldInput>> &inputs);
+
+        std::vector<std::unique_ptr<zelda::game::World>> m_worlds;
+        unsigned m_threads = 1;
+    };
+}
@@ -0,0 +1,277 @@
+#include "BehaviorScheduler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <new>
+
+namespace zelda::game
+{
+    namespace
+    {
+        // Frame pool: one free list per 64-byte size class. Frames are
+        // created and destroyed on the thread that owns their World, so a
+        // thread_local pool needs no locking. Big frames skip the pool.
+        constexpr std::size_t FRAME_CLASS = 64;
+        constexpr std::size_t FRAME_CLASSES = 16;
+
+        struct FreeFrame
+        {
+            FreeFrame* next;
+        };
+
+        struct FramePool
+        {
+            std::array<FreeFrame*, FRAME_CLASSES> free{};
+
+            ~FramePool()
+            {
+                for (FreeFrame* head : free)
+                {
+                    while (head)
+                    {
+                        FreeFrame* next = head->next;
+                        ::operator delete(head);
+                        head = next;
+                    }
+                }
+            }
+        };
+
+        thread_local FramePool t_framePool;
+
+        std::size_t frameClass(std::size_t size) { return (size + FRAME_CLASS - 1) / FRAME_CLASS - 1; }
+    }
+
+    void* Behavior::promise_type::operator new(std::size_t size)
+    {
+        const std::size_t c = frameClass(size);
+        if (c >= FRAME_CLASSES)
+            return ::operator new(size);
+
+        if (FreeFrame* frame = t_framePool.free[c])
+        {
+            t_framePool.free[c] = frame->next;
+            return frame;
+        }
+        return ::operator new((c + 1) * FRAME_CLASS);
+    }
+
+    void Behavior::promise_type::operator delete(void* frame, std::size_t size) noexcept
+    {
+        const std::size_t c = frameClass(size);
+        if (c >= FRAME_CLASSES)
+        {
+            ::operator delete(frame);
+            return;
+        }
+        t_framePool.free[c] = new (frame) FreeFrame{t_framePool.free[c]};
+    }
+
+    void WaitNode::unlink()
+    {
+        if (!list)
+            return;
+
+        if (prev)
+            prev->next = next;
+        else
+            list->head = next;
+        if (next)
+            next->prev = prev;
+        else
+            list->tail = prev;
+
+        prev = next = nullptr;
+        list = nullptr;
+    }
+
+    void WaitList::push(WaitNode* node)
+    {
+        node->unlink();
+        node->list = this;
+        node->prev = tail;
+        node->next = nullptr;
+        if (tail)
+            tail->next = node;
+        else
+            head = node;
+        tail = node;
+    }
+
+    WaitNode* WaitList::pop()
+    {
+        WaitNode* node = head;
+        if (node)
+            node->unlink();
+        return node;
+    }
+
+    BehaviorId BehaviorScheduler::start(Behavior behavior)
+    {
+        auto handle = behavior.release();
+        if (!handle)
+            return 0;
+
+        std::uint32_t slot;
+        if (!m_freeSlots.empty())
+        {
+            slot = m_freeSlots.back();
+            m_freeSlots.pop_back();
+        }
+        else
+        {
+            slot = static_cast<std::uint32_t>(m_slots.size());
+            m_slots.push_back(Slot{});
+        }
+
+        Slot& s = m_slots[slot];
+        s.handle = handle;
+        ++s.generation;
+        handle.promise().scheduler = this;
+        handle.promise().slot = slot;
+        ++m_stats.started;
+
+        const BehaviorId id = (static_cast<BehaviorId>(s.generation) << 32) | slot;
+        resume(handle);
+        return id;
+    }
+
+    void BehaviorScheduler::stop(BehaviorId id)
+    {
+        const std::uint32_t slot = static_cast<std::uint32_t>(id);
+        const std::uint32_t generation = static_cast<std::uint32_t>(id >> 32);
+        if (slot >= m_slots.size() || m_slots[slot].generation != generation || !m_slots[slot].handle)
+            return;
+
+        // destroying the frame destroys the awaitable, whose node unlinks itself
+        m_slots[slot].handle.destroy();
+        m_slots[slot].handle = nullptr;
+        m_freeSlots.push_back(slot);
+    }
+
+    void BehaviorScheduler::stopAll()
+    {
+        for (std::uint32_t slot = 0; slot < m_slots.size(); ++slot)
+        {
+            if (m_slots[slot].handle)
+            {
+                m_slots[slot].handle.destroy();
+                m_slots[slot].handle = nullptr;
+                m_freeSlots.push_back(slot);
+            }
+        }
+    }
+
+    bool BehaviorScheduler::inRange(const WaitNode& node)
+    {
+        const float dx = *node.ax - *node.bx;
+        const float dy = *node.ay - *node.by;
+        return dx * dx + dy * dy <= node.range * node.range;
+    }
+
+    void BehaviorScheduler::addTimer(WaitNode* node)
+    {
+        const std::uint64_t delta = node->due > m_now ? node->due - m_now : 0;
+        if (delta == 0)
+            m_ready.push(node);
+        else if (delta < WHEEL0_SIZE)
+            m_wheel0[node->due & (WHEEL0_SIZE - 1)].push(node);
+        else if (delta < WHEEL0_SIZE * WHEEL1_SIZE)
+            m_wheel1[(node->due >> WHEEL0_BITS) & (WHEEL1_SIZE - 1)].push(node);
+        else
+            m_overflow.push(node);
+    }
+
+    void BehaviorScheduler::armRange(WaitNode* node)
+    {
+        // can't be in range before the gap could have closed
+        const float dx = *node->ax - *node->bx;
+        const float dy = *node->ay - *node->by;
+        const float gap = std::sqrt(dx * dx + dy * dy) - node->range;
+        // a tiny closing speed makes this huge / inf: cap it (past the wheels
+        // it's only a re-check in the overflow list anyway) before the cast
+        constexpr float MAX_WAIT = static_cast<float>(WHEEL0_SIZE * WHEEL1_SIZE * 4);
+        const float ticks = std::min(std::floor(gap / node->closingPerTick), MAX_WAIT);
+        node->due = m_now + (ticks > 1.0f ? static_cast<std::uint64_t>(ticks) : 1u);
+        addTimer(node);
+    }
+
+    void BehaviorScheduler::tick()
+    {
+        ++m_now;
+
+        // every 256 ticks the next wheel-1 slot comes due: spread it over wheel 0
+        if ((m_now & (WHEEL0_SIZE - 1)) == 0)
+        {
+            WaitList& slot = m_wheel1[(m_now >> WHEEL0_BITS) & (WHEEL1_SIZE - 1)];
+            while (WaitNode* node = slot.pop())
+            {
+                addTimer(node);
+                ++m_stats.cascaded;
+            }
+
+            // and once per full turn of wheel 1, the far future gets re-sorted
+            if ((m_now & (WHEEL0_SIZE * WHEEL1_SIZE - 1)) == 0)
+            {
+                // (still-far ones go back on the tail; only look at each once)
+                std::size_t count = 0;
+                for (WaitNode* n = m_overflow.head; n; n = n->next)
+                    ++count;
+                while (count-- > 0)
+                    addTimer(m_overflow.pop());
+            }
+        }
+
+        // timers due now
+        WaitList& due = m_wheel0[m_now & (WHEEL0_SIZE - 1)];
+        while (WaitNode* node = due.pop())
+        {
+            ++m_stats.timersFired;
+            if (node->ax)
+            {
+                ++m_stats.rangeChecks;
+                if (!inRange(*node))
+                {
+                    armRange(node);
+                    continue;
+                }
+            }
+            m_ready.push(node);
+        }
+
+        // Resume in order. A behaviour that waits again lands in a future
+        // slot (waitTicks(0) doesn't suspend), so this always drains.
+        while (WaitNode* node = m_ready.pop())
+            resume(node->handle);
+    }
+
+    void BehaviorScheduler::signal(std::uint64_t id)
+    {
+        for (WaitNode* node = m_signalWaiters.head; node;)
+        {
+            WaitNode* next = node->next;
+            if (node->signal == id)
+                m_ready.push(node);
+            node = next;
+        }
+    }
+
+    void BehaviorScheduler::resume(std::coroutine_handle<> handle)
+    {
+        ++m_stats.resumes;
+        handle.resume();
+        if (handle.done())
+        {
+            auto typed = std::coroutine_handle<Behavior::promise_type>::from_address(handle.address());
+            finish(typed.promise().slot);
+        }
+    }
+
+    void BehaviorScheduler::finish(std::uint32_t slot)
+    {
+        ++m_stats.finished;
+        m_slots[slot].handle.destroy();
+        m_slots[slot].handle = nullptr;
+        m_freeSlots.push_back(slot);
+    }
+}
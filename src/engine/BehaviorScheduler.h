@@ -0,0 +1,291 @@
+#pragma once
+#include <array>
+#include <coroutine>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <exception>
+
+namespace zelda::game
+{
+    class BehaviorScheduler;
+    struct WaitList;
+
+    // A behaviour: a coroutine that runs on BehaviorScheduler ticks.
+    //
+    //   Behavior guard(BehaviorScheduler& s, ...)
+    //   {
+    //       co_await s.waitInRange(...);
+    //       co_await s.waitTicks(30);
+    //   }
+    //
+    // Created suspended; BehaviorScheduler::start() takes it over and runs
+    // it to its first co_await. Stackless: locals live in the coroutine frame
+    // (pooled per thread, see promise_type::operator new).
+    class Behavior
+    {
+    public:
+        struct promise_type
+        {
+            BehaviorScheduler* scheduler = nullptr;
+            std::uint32_t slot = 0;
+
+            Behavior get_return_object()
+            {
+                return Behavior(std::coroutine_handle<promise_type>::from_promise(*this));
+            }
+            std::suspend_always initial_suspend() noexcept { return {}; }
+            std::suspend_always final_suspend() noexcept { return {}; } // the scheduler destroys it
+            void return_void() {}
+            void unhandled_exception() { std::terminate(); }
+
+            // Frames come from a per-thread free list, so restarting
+            // behaviours (snapshot loads, room re-entry) stops allocating
+            // once the list has warmed up.
+            static void* operator new(std::size_t size);
+            static void operator delete(void* frame, std::size_t size) noexcept;
+        };
+
+        Behavior() = default;
+        explicit Behavior(std::coroutine_handle<promise_type> handle) : m_handle(handle) {}
+        ~Behavior()
+        {
+            if (m_handle)
+                m_handle.destroy();
+        }
+
+        Behavior(Behavior&& other) noexcept : m_handle(other.m_handle) { other.m_handle = nullptr; }
+        Behavior& operator=(Behavior&& other) noexcept
+        {
+            if (this != &other)
+            {
+                if (m_handle)
+                    m_handle.destroy();
+                m_handle = other.m_handle;
+                other.m_handle = nullptr;
+            }
+            return *this;
+        }
+        Behavior(const Behavior&) = delete;
+        Behavior& operator=(const Behavior&) = delete;
+
+        std::coroutine_handle<promise_type> release()
+        {
+            auto h = m_handle;
+            m_handle = nullptr;
+            return h;
+        }
+
+    private:
+        std::coroutine_handle<promise_type> m_handle;
+    };
+
+    // Handle to a running behaviour (slot + generation, 0 = none).
+    using BehaviorId = std::uint64_t;
+
+    // Where a suspended behaviour is parked. Lives inside the awaitable,
+    // i.e. inside the coroutine frame, so waiting never allocates, and a
+    // behaviour that is stopped while waiting unlinks itself on destruction.
+    struct WaitNode
+    {
+        WaitNode* prev = nullptr;
+        WaitNode* next = nullptr;
+        WaitList* list = nullptr;
+
+        std::coroutine_handle<> handle;
+        std::uint64_t due = 0;    // timers: tick to wake on
+        std::uint64_t signal = 0; // signals: id waited for
+
+        // range waits: wake once |a - b| <= range (map pixels)
+        const float* ax = nullptr;
+        const float* ay = nullptr;
+        const float* bx = nullptr;
+        const float* by = nullptr;
+        float range = 0.0f;
+        float closingPerTick = 1.0f; // fastest the two can approach each other
+
+        WaitNode() = default;
+        WaitNode(const WaitNode&) = delete;
+        WaitNode& operator=(const WaitNode&) = delete;
+        ~WaitNode() { unlink(); }
+
+        void unlink();
+    };
+
+    // FIFO of wait nodes (intrusive, doubly linked).
+    struct WaitList
+    {
+        WaitNode* head = nullptr;
+        WaitNode* tail = nullptr;
+
+        bool empty() const { return head == nullptr; }
+        void push(WaitNode* node);
+        WaitNode* pop();
+    };
+
+    struct BehaviorStats
+    {
+        std::uint64_t started = 0;
+        std::uint64_t finished = 0;
+        std::uint64_t resumes = 0;
+        std::uint64_t timersFired = 0;
+        std::uint64_t rangeChecks = 0;
+        std::uint64_t cascaded = 0; // timers moved down a wheel level
+    };
+
+    // Runs behaviours, resuming only the ones whose wait is over.
+    //
+    // Timed waits sit in a two-level timer wheel: 256 one-tick slots, then
+    // 64 slots of 256 ticks (~4.5 minutes at 60 Hz), then an overflow list.
+    // A tick looks at one slot (plus a cascade every 256 ticks), so parked
+    // behaviours cost nothing until they're due.
+    //
+    // "In range" waits don't poll: they sleep as long as the two points
+    // can't possibly have closed the gap (distance / closing speed), then
+    // check again. Signal waits (animation ends, ...) wake on signal().
+    //
+    // Single-threaded and deterministic: wakeups resume in the order they
+    // became ready.
+    class BehaviorScheduler
+    {
+    public:
+        static constexpr int WHEEL0_BITS = 8;
+        static constexpr int WHEEL1_BITS = 6;
+        static constexpr std::uint64_t WHEEL0_SIZE = 1u << WHEEL0_BITS;
+        static constexpr std::uint64_t WHEEL1_SIZE = 1u << WHEEL1_BITS;
+
+        BehaviorScheduler() = default;
+        ~BehaviorScheduler() { stopAll(); }
+
+        BehaviorScheduler(const BehaviorScheduler&) = delete;
+        BehaviorScheduler& operator=(const BehaviorScheduler&) = delete;
+
+        // Take over `behavior` and run it up to its first wait.
+        BehaviorId start(Behavior behavior);
+
+        // Destroy a behaviour wherever it's waiting (no-op if finished).
+        void stop(BehaviorId id);
+        void stopAll();
+
+        // Advance one tick: expire timers, re-check range waits, resume
+        // everything that's ready (including signal()s since the last tick).
+        void tick();
+
+        // Wake every behaviour waiting on `id` (resumed on the next tick()).
+        void signal(std::uint64_t id);
+
+        std::uint64_t now() const { return m_now; }
+        std::size_t running() const { return m_slots.size() - m_freeSlots.size(); }
+        const BehaviorStats& stats() const { return m_stats; }
+
+        // --- awaitables ---
+
+        struct WaitTicks
+        {
+            BehaviorScheduler* scheduler;
+            std::uint64_t ticks;
+            WaitNode node;
+
+            WaitTicks(BehaviorScheduler* s, std::uint64_t n) : scheduler(s), ticks(n) {}
+
+            bool await_ready() const noexcept { return ticks == 0; }
+            void await_suspend(std::coroutine_handle<> h)
+            {
+                node.handle = h;
+                node.due = scheduler->m_now + ticks;
+                scheduler->addTimer(&node);
+            }
+            void await_resume() const noexcept {}
+        };
+
+        struct WaitInRange
+        {
+            BehaviorScheduler* scheduler;
+            WaitNode node;
+
+            WaitInRange(BehaviorScheduler* s, const float& ax, const float& ay, const float& bx, const float& by,
+                        float range, float closingPerTick)
+            : scheduler(s)
+            {
+                node.ax = &ax;
+                node.ay = &ay;
+                node.bx = &bx;
+                node.by = &by;
+                node.range = range;
+                node.closingPerTick = closingPerTick > 0.0f ? closingPerTick : 1.0f;
+            }
+
+            bool await_ready() const noexcept { return inRange(node); }
+            void await_suspend(std::coroutine_handle<> h)
+            {
+                node.handle = h;
+                scheduler->armRange(&node);
+            }
+            void await_resume() const noexcept {}
+        };
+
+        struct WaitSignal
+        {
+            BehaviorScheduler* scheduler;
+            WaitNode node;
+
+            WaitSignal(BehaviorScheduler* s, std::uint64_t id) : scheduler(s) { node.signal = id; }
+
+            bool await_ready() const noexcept { return false; }
+            void await_suspend(std::coroutine_handle<> h)
+            {
+                node.handle = h;
+                scheduler->m_signalWaiters.push(&node);
+            }
+            void await_resume() const noexcept {}
+        };
+
+        // co_await waitTicks(n): resume n ticks from now (0 = don't wait).
+        WaitTicks waitTicks(int ticks)
+        {
+            return WaitTicks(this, static_cast<std::uint64_t>(ticks > 0 ? ticks : 0));
+        }
+
+        // co_await waitInRange(...): resume once (ax, ay) is within `range`
+        // of (bx, by). The floats are read in place and must outlive the wait.
+        // closingPerTick = how fast the gap can shrink at most (px per tick).
+        WaitInRange waitInRange(const float& ax, const float& ay, const float& bx, const float& by,
+                                float range, float closingPerTick)
+        {
+            return WaitInRange(this, ax, ay, bx, by, range, closingPerTick);
+        }
+
+        // co_await waitSignal(id): resume after signal(id).
+        WaitSignal waitSignal(std::uint64_t id)
+        {
+            return WaitSignal(this, id);
+        }
+
+    private:
+        struct Slot
+        {
+            std::coroutine_handle<Behavior::promise_type> handle;
+            std::uint32_t generation = 0;
+        };
+
+        static bool inRange(const WaitNode& node);
+
+        void addTimer(WaitNode* node);
+        void armRange(WaitNode* node);
+        void resume(std::coroutine_handle<> handle);
+        void finish(std::uint32_t slot);
+
+        std::uint64_t m_now = 0;
+
+        std::array<WaitList, WHEEL0_SIZE> m_wheel0;
+        std::array<WaitList, WHEEL1_SIZE> m_wheel1;
+        WaitList m_overflow;
+        WaitList m_signalWaiters;
+        WaitList m_ready;
+
+        std::vector<Slot> m_slots;
+        std::vector<std::uint32_t> m_freeSlots;
+
+        BehaviorStats m_stats;
+    };
+}
@@ -0,0 +1,115 @@
+#pragma once
+#include <cstdint>
+
+namespace zelda::game
+{
+    // Built-in 5x7 pixel font for HUD / debug text, no font file needed.
+    //
+    // Covers ASCII 32..95 (space, digits, punctuation, upper case); lower
+    // case is drawn as upper case and anything else as '?'. TextRenderer
+    // rasterises it once into a FONT_ATLAS_W x FONT_ATLAS_H glyph atlas,
+    // 16 glyphs per row in FONT_CELL square cells.
+    namespace font
+    {
+        constexpr int GLYPH_W     = 5;
+        constexpr int GLYPH_H     = 7;
+        constexpr int ADVANCE     = GLYPH_W + 1; // pen step per character
+        constexpr int LINE_HEIGHT = GLYPH_H + 2;
+
+        constexpr int FIRST = 32;
+        constexpr int COUNT = 64;
+
+        // one pixel of padding right / below every glyph, so a scaled
+        // atlas never samples the neighbouring cell
+        constexpr int CELL          = 8;
+        constexpr int ATLAS_COLUMNS = 16;
+        constexpr int ATLAS_W       = ATLAS_COLUMNS * CELL;
+        constexpr int ATLAS_H       = (COUNT + ATLAS_COLUMNS - 1) / ATLAS_COLUMNS * CELL;
+
+        // one byte per row, top row first, bit 4 = leftmost pixel
+        inline constexpr std::uint8_t GLYPHS[COUNT][GLYPH_H] = {
+            {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // ' '
+            {0x04, 0x04, 0x04, 0x04, 0x04, 0x00, 0x04}, // '!'
+            {0x0A, 0x0A, 0x00, 0x00, 0x00, 0x00, 0x00}, // '"'
+            {0x0A, 0x0A, 0x1F, 0x0A, 0x1F, 0x0A, 0x0A}, // '#'
+            {0x04, 0x0F, 0x14, 0x0E, 0x05, 0x1E, 0x04}, // '$'
+            {0x18, 0x19, 0x02, 0x04, 0x08, 0x13, 0x03}, // '%'
+            {0x0C, 0x12, 0x14, 0x08, 0x15, 0x12, 0x0D}, // '&'
+            {0x04, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00}, // '\''
+            {0x02, 0x04, 0x08, 0x08, 0x08, 0x04, 0x02}, // '('
+            {0x08, 0x04, 0x02, 0x02, 0x02, 0x04, 0x08}, // ')'
+            {0x00, 0x04, 0x15, 0x0E, 0x15, 0x04, 0x00}, // '*'
+            {0x00, 0x04, 0x04, 0x1F, 0x04, 0x04, 0x00}, // '+'
+            {0x00, 0x00, 0x00, 0x00, 0x0C, 0x04, 0x08}, // ','
+            {0x00, 0x00, 0x00, 0x1F, 0x00, 0x00, 0x00}, // '-'
+            {0x00, 0x00, 0x00, 0x00, 0x00, 0x0C, 0x0C}, // '.'
+            {0x00, 0x01, 0x02, 0x04, 0x08, 0x10, 0x00}, // '/'
+            {0x0E, 0x11, 0x13, 0x15, 0x19, 0x11, 0x0E}, // '0'
+            {0x04, 0x0C, 0x04, 0x04, 0x04, 0x04, 0x0E}, // '1'
+            {0x0E, 0x11, 0x01, 0x02, 0x04, 0x08, 0x1F}, // '2'
+            {0x1F, 0x02, 0x04, 0x02, 0x01, 0x11, 0x0E}, // '3'
+            {0x02, 0x06, 0x0A, 0x12, 0x1F, 0x02, 0x02}, // '4'
+            {0x1F, 0x10, 0x1E, 0x01, 0x01, 0x11, 0x0E}, // '5'
+            {0x06, 0x08, 0x10, 0x1E, 0x11, 0x11, 0x0E}, // '6'
+            {0x1F, 0x01, 0x02, 0x04, 0x08, 0x08, 0x08}, // '7'
+            {0x0E, 0x11, 0x11, 0x0E, 0x11, 0x11, 0x0E}, // '8'
+            {0x0E, 0x11, 0x11, 0x0F, 0x01, 0x02, 0x0C}, // '9'
+            {0x00, 0x0C, 0x0C, 0x00, 0x0C, 0x0C, 0x00}, // ':'
+            {0x00, 0x0C, 0x0C, 0x00, 0x0C, 0x04, 0x08}, // ';'
+            {0x02, 0x04, 0x08, 0x10, 0x08, 0x04, 0x02}, // '<'
+            {0x00, 0x00, 0x1F, 0x00, 0x1F, 0x00, 0x00}, // '='
+            {0x08, 0x04, 0x02, 0x01, 0x02, 0x04, 0x08}, // '>'
+            {0x0E, 0x11, 0x01, 0x02, 0x04, 0x00, 0x04}, // '?'
+            {0x0E, 0x11, 0x01, 0x0D, 0x15, 0x15, 0x0E}, // '@'
+            {0x0E, 0x11, 0x11, 0x1F, 0x11, 0x11, 0x11}, // 'A'
+            {0x1E, 0x11, 0x11, 0x1E, 0x11, 0x11, 0x1E}, // 'B'
+            {0x0E, 0x11, 0x10, 0x10, 0x10, 0x11, 0x0E}, // 'C'
+            {0x1C, 0x12, 0x11, 0x11, 0x11, 0x12, 0x1C}, // 'D'
+            {0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x1F}, // 'E'
+            {0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x10}, // 'F'
+            {0x0E, 0x11, 0x10, 0x17, 0x11, 0x11, 0x0F}, // 'G'
+            {0x11, 0x11, 0x11, 0x1F, 0x11, 0x11, 0x11}, // 'H'
+            {0x0E, 0x04, 0x04, 0x04, 0x04, 0x04, 0x0E}, // 'I'
+            {0x07, 0x02, 0x02, 0x02, 0x02, 0x12, 0x0C}, // 'J'
+            {0x11, 0x12, 0x14, 0x18, 0x14, 0x12, 0x11}, // 'K'
+            {0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x1F}, // 'L'
+            {0x11, 0x1B, 0x15, 0x15, 0x11, 0x11, 0x11}, // 'M'
+            {0x11, 0x11, 0x19, 0x15, 0x13, 0x11, 0x11}, // 'N'
+            {0x0E, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E}, // 'O'
+            {0x1E, 0x11, 0x11, 0x1E, 0x10, 0x10, 0x10}, // 'P'
+            {0x0E, 0x11, 0x11, 0x11, 0x15, 0x12, 0x0D}, // 'Q'
+            {0x1E, 0x11, 0x11, 0x1E, 0x14, 0x12, 0x11}, // 'R'
+            {0x0F, 0x10, 0x10, 0x0E, 0x01, 0x01, 0x1E}, // 'S'
+            {0x1F, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04}, // 'T'
+            {0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E}, // 'U'
+            {0x11, 0x11, 0x11, 0x11, 0x11, 0x0A, 0x04}, // 'V'
+            {0x11, 0x11, 0x11, 0x15, 0x15, 0x15, 0x0A}, // 'W'
+            {0x11, 0x11, 0x0A, 0x04, 0x0A, 0x11, 0x11}, // 'X'
+            {0x11, 0x11, 0x0A, 0x04, 0x04, 0x04, 0x04}, // 'Y'
+            {0x1F, 0x01, 0x02, 0x04, 0x08, 0x10, 0x1F}, // 'Z'
+            {0x0E, 0x08, 0x08, 0x08, 0x08, 0x08, 0x0E}, // '['
+            {0x00, 0x10, 0x08, 0x04, 0x02, 0x01, 0x00}, // '\\'
+            {0x0E, 0x02, 0x02, 0x02, 0x02, 0x02, 0x0E}, // ']'
+            {0x04, 0x0A, 0x11, 0x00, 0x00, 0x00, 0x00}, // '^'
+            {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1F}, // '_'
+
+        };
+
+        // Glyph slot for a character (after case folding / fallback).
+        constexpr int glyphIndex(char c)
+        {
+            int code = static_cast<unsigned char>(c);
+            if (code >= 'a' && code <= 'z')
+                code -= 'a' - 'A';
+            if (code < FIRST || code >= FIRST + COUNT)
+                code = '?';
+            return code - FIRST;
+        }
+
+        constexpr int glyphAtlasX(int index) { return index % ATLAS_COLUMNS * CELL; }
+        constexpr int glyphAtlasY(int index) { return index / ATLAS_COLUMNS * CELL; }
+
+        static_assert(glyphIndex('A') == glyphIndex('a'), "case folding");
+        static_assert(glyphIndex('~') == glyphIndex('?'), "fallback glyph");
+    }
+}
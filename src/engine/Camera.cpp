@@ -1,5 +1,5 @@
 #include "Camera.h"
-#include "Engine.h" // only if you still reference Player::WIDTH/HEIGHT here
+#include "World.h" // only if you still reference Player::WIDTH/HEIGHT here
 #include <algorithm>
 
 using namespace zelda::game;
@@ -0,0 +1,434 @@
+#include "DungeonGenerator.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <numeric>
+#include <thread>
+
+#include "TileMap.h"
+
+namespace zelda::game
+{
+    namespace
+    {
+        // splitmix64 finaliser
+        std::uint64_t mix(std::uint64_t x)
+        {
+            x += 0x9E3779B97F4A7C15ull;
+            x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+            x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+            return x ^ (x >> 31);
+        }
+
+        // what a hash is for, so edge weights / door offsets / rooms don't correlate
+        enum Salt : std::uint64_t
+        {
+            SALT_EDGE_WEIGHT = 1,
+            SALT_LOOP,
+            SALT_DOOR_OFFSET,
+            SALT_ROOM
+        };
+
+        std::uint64_t hashOf(std::uint64_t seed, Salt salt, std::uint64_t id)
+        {
+            return mix(mix(seed ^ (static_cast<std::uint64_t>(salt) << 56)) ^ id);
+        }
+
+        // Per-room stream. range() is a plain multiply-shift, identical on
+        // every platform (unlike std::uniform_int_distribution).
+        struct Rng
+        {
+            std::uint64_t state;
+
+            std::uint64_t next()
+            {
+                state += 0x9E3779B97F4A7C15ull;
+                return mix(state);
+            }
+
+            // [0, n)
+            int range(int n)
+            {
+                return n <= 1 ? 0 : static_cast<int>(((next() >> 32) * static_cast<std::uint64_t>(n)) >> 32);
+            }
+        };
+
+        struct RoomCarver
+        {
+            std::vector<int>& tiles;
+            int w;
+            int h;
+
+            void fill(int x, int y, int cw, int ch, int id)
+            {
+                for (int ty = y; ty < y + ch; ++ty)
+                    for (int tx = x; tx < x + cw; ++tx)
+                        tiles[ty * w + tx] = id;
+            }
+            bool floor(int x, int y) const { return tiles[y * w + x] == TILE_FLOOR; }
+        };
+
+        // Wall up floor that can't be reached from (sx, sy), so pillars never
+        // leave a sealed pocket for something to spawn in.
+        void sealPockets(std::vector<int>& tiles, int w, int h, int sx, int sy)
+        {
+            std::vector<std::uint8_t> seen(tiles.size(), 0);
+            std::vector<int> stack;
+            stack.reserve(tiles.size());
+            stack.push_back(sy * w + sx);
+            seen[sy * w + sx] = 1;
+
+            while (!stack.empty())
+            {
+                const int i = stack.back();
+                stack.pop_back();
+                const int x = i % w, y = i / w;
+                const int next[4] = {
+                    y > 0 ? i - w : -1, y < h - 1 ? i + w : -1,
+                    x > 0 ? i - 1 : -1, x < w - 1 ? i + 1 : -1};
+                for (int n : next)
+                {
+                    if (n >= 0 && !seen[n] && tiles[n] == TILE_FLOOR)
+                    {
+                        seen[n] = 1;
+                        stack.push_back(n);
+                    }
+                }
+            }
+
+            for (std::size_t i = 0; i < tiles.size(); ++i)
+                if (tiles[i] == TILE_FLOOR && !seen[i])
+                    tiles[i] = TILE_WALL;
+        }
+    }
+
+    DungeonGenerator::DungeonGenerator(const DungeonConfig& config)
+    : m_config(config)
+    {
+        DungeonConfig& c = m_config;
+        c.gridW = std::max(1, c.gridW);
+        c.gridH = std::max(1, c.gridH);
+        c.doorWidth = std::max(1, c.doorWidth);
+        c.doorHeight = std::max(1, c.doorHeight);
+        // room for a door gap between the corners and a 3x2 chamber
+        c.roomTilesW = std::max({c.roomTilesW, c.doorWidth + 2, 5});
+        c.roomTilesH = std::max({c.roomTilesH, c.doorHeight + 2, 4});
+        c.maxEnemies = std::max(0, c.maxEnemies);
+
+        const int gw = c.gridW, gh = c.gridH;
+        m_doors.assign(static_cast<std::size_t>(gw) * gh, 0);
+        m_startX = gw / 2;
+        m_startY = gh / 2;
+
+        // Edges: first the horizontal ones, (x, y)-(x+1, y) at y * (gw-1) + x,
+        // then the vertical ones, (x, y)-(x, y+1) at hCount + y * gw + x.
+        const std::size_t hCount = static_cast<std::size_t>(gw - 1) * gh;
+        const std::size_t vCount = static_cast<std::size_t>(gw) * (gh - 1);
+
+        struct Edge
+        {
+            std::uint64_t weight;
+            std::uint32_t id;
+        };
+        std::vector<Edge> edges(hCount + vCount);
+        for (std::size_t i = 0; i < edges.size(); ++i)
+            edges[i] = Edge{hashOf(c.seed, SALT_EDGE_WEIGHT, i), static_cast<std::uint32_t>(i)};
+        // id breaks ties, so the order is total and the tree is the same everywhere
+        std::sort(edges.begin(), edges.end(), [](const Edge& a, const Edge& b) {
+            return a.weight != b.weight ? a.weight < b.weight : a.id < b.id;
+        });
+
+        // Kruskal: union-find with path halving
+        std::vector<int> parent(m_doors.size());
+        std::iota(parent.begin(), parent.end(), 0);
+        auto find = [&parent](int i) {
+            while (parent[i] != i)
+            {
+                parent[i] = parent[parent[i]];
+                i = parent[i];
+            }
+            return i;
+        };
+
+        auto connect = [&](std::size_t id) {
+            int a, b;
+            RoomDir fromA, fromB;
+            if (id < hCount)
+            {
+                const int x = static_cast<int>(id % (gw - 1)), y = static_cast<int>(id / (gw - 1));
+                a = y * gw + x;
+                b = a + 1;
+                fromA = RoomDir::East;
+                fromB = RoomDir::West;
+            }
+            else
+            {
+                a = static_cast<int>(id - hCount);
+                b = a + gw;
+                fromA = RoomDir::South;
+                fromB = RoomDir::North;
+            }
+            return std::make_pair(std::make_pair(a, b), std::make_pair(fromA, fromB));
+        };
+
+        for (const Edge& e : edges)
+        {
+            const auto [rooms, dirs] = connect(e.id);
+            const int ra = find(rooms.first), rb = find(rooms.second);
+            const bool treeEdge = ra != rb;
+            if (treeEdge)
+                parent[ra] = rb;
+            else if (static_cast<int>(hashOf(c.seed, SALT_LOOP, e.id) & 255) >= c.loopChance)
+                continue;
+
+            m_doors[rooms.first]  |= doorBit(dirs.first);
+            m_doors[rooms.second] |= doorBit(dirs.second);
+        }
+    }
+
+    int DungeonGenerator::doorOffset(int rx, int ry, RoomDir dir) const
+    {
+        const int gw = m_config.gridW, gh = m_config.gridH;
+        const std::size_t hCount = static_cast<std::size_t>(gw - 1) * gh;
+
+        // the edge behind this wall, same id from either side
+        std::size_t id = 0;
+        switch (dir)
+        {
+            case RoomDir::North: id = hCount + static_cast<std::size_t>(ry - 1) * gw + rx; break;
+            case RoomDir::South: id = hCount + static_cast<std::size_t>(ry) * gw + rx; break;
+            case RoomDir::West:  id = static_cast<std::size_t>(ry) * (gw - 1) + rx - 1; break;
+            case RoomDir::East:  id = static_cast<std::size_t>(ry) * (gw - 1) + rx; break;
+        }
+
+        // keep the gap off the corners: [1, wall - 1 - span]
+        const bool horizontalWall = dir == RoomDir::North || dir == RoomDir::South;
+        const int wall = horizontalWall ? m_config.roomTilesW : m_config.roomTilesH;
+        const int span = horizontalWall ? m_config.doorWidth : m_config.doorHeight;
+        const int choices = wall - 1 - span;
+        return 1 + static_cast<int>(hashOf(m_config.seed, SALT_DOOR_OFFSET, id) % static_cast<std::uint64_t>(choices));
+    }
+
+    bool DungeonGenerator::generateRoom(int rx, int ry, RoomData& out) const
+    {
+        if (rx < 0 || ry < 0 || rx >= m_config.gridW || ry >= m_config.gridH)
+            return false;
+
+        const int index = ry * m_config.gridW + rx;
+        if (!m_rooms.empty())
+        {
+            out = m_rooms[index];
+            return true;
+        }
+
+        const DungeonConfig& c = m_config;
+        const int w = c.roomTilesW, h = c.roomTilesH;
+        const bool startRoom = rx == m_startX && ry == m_startY;
+        Rng rng{hashOf(c.seed, SALT_ROOM, static_cast<std::uint64_t>(index))};
+
+        RoomData room;
+        room.width = w;
+        room.height = h;
+        room.tiles.assign(static_cast<std::size_t>(w) * h, TILE_WALL);
+        RoomCarver carve{room.tiles, w, h};
+
+        // chamber: at least half the inside, at least 3x2
+        const int minCw = std::max(3, (w - 2) / 2);
+        const int minCh = std::max(2, (h - 2) / 2);
+        const int cw = minCw + rng.range(w - 2 - minCw + 1);
+        const int ch = minCh + rng.range(h - 2 - minCh + 1);
+        const int x0 = 1 + rng.range(w - 2 - cw + 1);
+        const int y0 = 1 + rng.range(h - 2 - ch + 1);
+        carve.fill(x0, y0, cw, ch, TILE_FLOOR);
+
+        // Door gap + corridor: straight in from the wall to the chamber's
+        // near edge, then two tiles wide along that edge until it meets the chamber.
+        const std::uint8_t doorMask = doors(rx, ry);
+        SDL_Point doorTiles[4];
+        int doorCount = 0;
+        for (int d = 0; d < 4; ++d)
+        {
+            const RoomDir dir = static_cast<RoomDir>(d);
+            if (!(doorMask & doorBit(dir)))
+                continue;
+
+            const int off = doorOffset(rx, ry, dir);
+            const int dw = c.doorWidth, dh = c.doorHeight;
+            switch (dir)
+            {
+                case RoomDir::North:
+                {
+                    carve.fill(off, 0, dw, y0 + 1, TILE_FLOOR);
+                    const int xa = std::min(off, x0), xb = std::max(off + dw - 1, x0 + cw - 1);
+                    carve.fill(xa, y0, xb - xa + 1, 2, TILE_FLOOR);
+                    doorTiles[doorCount++] = SDL_Point{off + dw / 2, 0};
+                    room.triggers.push_back(makeDoorTrigger(dir, off, dw, w, h));
+                    break;
+                }
+                case RoomDir::South:
+                {
+                    const int yb = y0 + ch - 1;
+                    carve.fill(off, yb, dw, h - yb, TILE_FLOOR);
+                    const int xa = std::min(off, x0), xb = std::max(off + dw - 1, x0 + cw - 1);
+                    carve.fill(xa, yb - 1, xb - xa + 1, 2, TILE_FLOOR);
+                    doorTiles[doorCount++] = SDL_Point{off + dw / 2, h - 1};
+                    room.triggers.push_back(makeDoorTrigger(dir, off, dw, w, h));
+                    break;
+                }
+                case RoomDir::West:
+                {
+                    carve.fill(0, off, x0 + 1, dh, TILE_FLOOR);
+                    const int ya = std::min(off, y0), yb = std::max(off + dh - 1, y0 + ch - 1);
+                    carve.fill(x0, ya, 2, yb - ya + 1, TILE_FLOOR);
+                    doorTiles[doorCount++] = SDL_Point{0, off + dh / 2};
+                    room.triggers.push_back(makeDoorTrigger(dir, off, dh, w, h));
+                    break;
+                }
+                case RoomDir::East:
+                {
+                    const int xb = x0 + cw - 1;
+                    carve.fill(xb, off, w - xb, dh, TILE_FLOOR);
+                    const int ya = std::min(off, y0), yb = std::max(off + dh - 1, y0 + ch - 1);
+                    carve.fill(xb - 1, ya, 2, yb - ya + 1, TILE_FLOOR);
+                    doorTiles[doorCount++] = SDL_Point{w - 1, off + dh / 2};
+                    room.triggers.push_back(makeDoorTrigger(dir, off, dh, w, h));
+                    break;
+                }
+            }
+        }
+
+        // Pillars, kept two tiles in from the chamber edge so the corridors
+        // (which run along it) always connect. The start room stays open.
+        const int px0 = x0 + 2, px1 = x0 + cw - 3;
+        const int py0 = y0 + 2, py1 = y0 + ch - 3;
+        if (!startRoom && px1 >= px0 && py1 >= py0)
+        {
+            const int area = (px1 - px0 + 1) * (py1 - py0 + 1);
+            const int pillars = rng.range(std::min(4, area / 4) + 1);
+            for (int i = 0; i < pillars; ++i)
+                carve.fill(px0 + rng.range(px1 - px0 + 1), py0 + rng.range(py1 - py0 + 1), 1, 1, TILE_WALL);
+            sealPockets(room.tiles, w, h, x0, y0);
+        }
+
+        // spawns
+        if (startRoom)
+        {
+            room.spawns.push_back(SpawnPoint{SpawnType::Player, x0 + cw / 2, y0 + ch / 2});
+        }
+        else
+        {
+            const int enemies = rng.range(c.maxEnemies + 1);
+            for (int i = 0; i < enemies; ++i)
+            {
+                // a few tries for a free tile that isn't right at a door
+                for (int attempt = 0; attempt < 8; ++attempt)
+                {
+                    const int tx = x0 + rng.range(cw), ty = y0 + rng.range(ch);
+                    bool ok = carve.floor(tx, ty);
+                    for (int d = 0; d < doorCount && ok; ++d)
+                        ok = std::abs(doorTiles[d].x - tx) > 2 || std::abs(doorTiles[d].y - ty) > 2;
+                    for (const SpawnPoint& s : room.spawns)
+                        ok = ok && (s.tx != tx || s.ty != ty);
+                    if (ok)
+                    {
+                        const SpawnType type = rng.range(3) == 0 ? SpawnType::Ambusher : SpawnType::Enemy;
+                        room.spawns.push_back(SpawnPoint{type, tx, ty});
+                        break;
+                    }
+                }
+            }
+        }
+
+        room.tintId = rng.range(4);
+        out = std::move(room);
+        return true;
+    }
+
+    void DungeonGenerator::generateRooms(int first, int count, std::vector<RoomData>& out, unsigned threads) const
+    {
+        count = std::max(0, std::min(count, roomCount() - first));
+        out.clear();
+        out.resize(static_cast<std::size_t>(count));
+        if (count == 0)
+            return;
+
+        if (threads == 0)
+            threads = std::max(1u, std::thread::hardware_concurrency());
+        threads = std::min<unsigned>(threads, static_cast<unsigned>(count));
+
+        const int gw = m_config.gridW;
+        auto carveRange = [this, first, gw, &out](int begin, int end) {
+            for (int i = begin; i < end; ++i)
+                generateRoom((first + i) % gw, (first + i) / gw, out[i]);
+        };
+
+        // contiguous slices like BatchRunner: every room is written by exactly
+        // one thread and rooms don't read each other, so no locking
+        const int perThread = count / static_cast<int>(threads);
+        const int extra = count % static_cast<int>(threads);
+
+        std::vector<std::thread> workers;
+        workers.reserve(threads - 1);
+
+        int begin = 0;
+        for (unsigned t = 0; t < threads; ++t)
+        {
+            const int end = begin + perThread + (static_cast<int>(t) < extra ? 1 : 0);
+            if (t + 1 == threads)
+                carveRange(begin, end); // calling thread takes the last slice
+            else
+                workers.emplace_back(carveRange, begin, end);
+            begin = end;
+        }
+        for (auto& worker : workers)
+            worker.join();
+    }
+
+    void DungeonGenerator::pregenerate(unsigned threads)
+    {
+        std::vector<RoomData> rooms;
+        generateRooms(0, roomCount(), rooms, threads);
+        m_rooms = std::move(rooms);
+    }
+
+    RoomLoader DungeonGenerator::loader(std::shared_ptr<const DungeonGenerator> generator)
+    {
+        return [generator](int rx, int ry, RoomData& out) {
+            return generator->generateRoom(rx, ry, out);
+        };
+    }
+
+    std::uint64_t DungeonGenerator::hashRoom(const RoomData& room)
+    {
+        std::uint64_t h = 0xCBF29CE484222325ull;
+        auto add = [&h](std::int64_t v) {
+            for (int i = 0; i < 8; ++i)
+            {
+                h ^= static_cast<std::uint64_t>(v >> (i * 8)) & 0xFF;
+                h *= 0x100000001B3ull;
+            }
+        };
+
+        add(room.width);
+        add(room.height);
+        add(room.tintId);
+        for (int t : room.tiles)
+            add(t);
+        for (const TriggerDef& def : room.triggers)
+        {
+            add(static_cast<int>(def.type));
+            add(def.rect.x);
+            add(def.rect.y);
+            add(def.rect.w);
+            add(def.rect.h);
+            add(def.param);
+        }
+        for (const SpawnPoint& s : room.spawns)
+        {
+            add(static_cast<int>(s.type));
+            add(s.tx);
+            add(s.ty);
+        }
+        return h;
+    }
+}
@@ -0,0 +1,93 @@
+#pragma once
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+
+#include "RoomLoader.h"
+
+namespace zelda::game
+{
+    struct DungeonConfig
+    {
+        std::uint64_t seed = 1;
+
+        // room grid
+        int gridW = 100;
+        int gridH = 100;
+
+        // every room has the same size (door spawn math relies on it)
+        int roomTilesW = 10;
+        int roomTilesH = 8;
+
+        // door gaps: along north / south walls, along west / east walls
+        int doorWidth  = 3;
+        int doorHeight = 2;
+
+        // chance (in 1/256) that a wall the spanning tree left closed gets a door anyway
+        int loopChance = 40;
+
+        // enemy spawns per room (start room has none)
+        int maxEnemies = 3;
+    };
+
+    // Seeded procedural dungeon.
+    //
+    // The constructor lays out the room graph: a random spanning tree over
+    // the grid (Kruskal with hashed edge weights, so every room is
+    // reachable) plus a few extra doors for loops. That's one byte per room.
+    //
+    // Rooms are carved on demand by generateRoom(): a chamber, a corridor
+    // from every door into it, pillars and spawn points. A room only depends
+    // on (seed, room position, its doors), never on what was generated
+    // before it, so rooms can be made in any order, on any thread, lazily
+    // or all at once, and a seed always gives bit-identical rooms.
+    // All randomness is integer hashing (no <random> distributions, whose
+    // output differs between standard libraries).
+    class DungeonGenerator
+    {
+    public:
+        explicit DungeonGenerator(const DungeonConfig& config);
+
+        const DungeonConfig& config() const { return m_config; }
+        int roomCount() const { return m_config.gridW * m_config.gridH; }
+
+        // where the player starts (its room has the Player spawn)
+        int startX() const { return m_startX; }
+        int startY() const { return m_startY; }
+
+        // RoomDir bit set of the doors of a room
+        std::uint8_t doors(int rx, int ry) const { return m_doors[ry * m_config.gridW + rx]; }
+        static constexpr std::uint8_t doorBit(RoomDir dir) { return static_cast<std::uint8_t>(1u << static_cast<int>(dir)); }
+
+        // Carve one room. Thread-safe (const, touches nothing shared).
+        bool generateRoom(int rx, int ry, RoomData& out) const;
+
+        // Carve rooms [first, first + count) in room index order (y * gridW + x)
+        // into out[0 .. count), split over `threads` threads (0 = one per core).
+        // The result doesn't depend on the thread count.
+        void generateRooms(int first, int count, std::vector<RoomData>& out, unsigned threads = 0) const;
+
+        // Generate every room now (in parallel); loader() then serves copies.
+        void pregenerate(unsigned threads = 0);
+        bool pregenerated() const { return !m_rooms.empty(); }
+
+        // Loader for RoomManager::init(). Keeps `generator` alive and may be
+        // called from the prefetch thread.
+        static RoomLoader loader(std::shared_ptr<const DungeonGenerator> generator);
+
+        // FNV-1a over everything a room is made of (determinism checks).
+        static std::uint64_t hashRoom(const RoomData& room);
+
+    private:
+        // door position along its wall (first tile of the gap), shared by both rooms
+        int doorOffset(int rx, int ry, RoomDir dir) const;
+
+        DungeonConfig m_config;
+        std::vector<std::uint8_t> m_doors; // gridW * gridH
+        int m_startX = 0;
+        int m_startY = 0;
+
+        std::vector<RoomData> m_rooms; // filled by pregenerate()
+    };
+}
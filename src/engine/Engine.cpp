@@ -1,6 +1,11 @@
 #include "Engine.h"
+#include "AllocTracker.h"
+#include "WorldRenderer.h"
+#include "Log.h"
 
 #include <SDL2/SDL_image.h>
+#include <cstdlib>
+#include <cstring>
 
 using namespace zelda;
 
@@ -11,6 +16,16 @@ namespace zelda::engine
 
     bool Engine::init(const char *title, int windowWidth, int windowHeight, bool fullscreen)
     {
+        game::AllocStageScope allocStage(game::AllocStage::Init);
+
+        // log writer thread first: from here on logging never blocks the
+        // frame. ZELDA_LOG_FILE=<path> writes a rotating file instead of stderr.
+        {
+            game::LogConfig logConfig;
+            logConfig.path = std::getenv("ZELDA_LOG_FILE");
+            game::logStart(logConfig);
+        }
+
         if (SDL_Init(SDL_INIT_VIDEO | SDL_INIT_AUDIO | SDL_INIT_EVENTS) != 0)
             return false;
 
@@ -18,7 +33,7 @@ namespace zelda::engine
         int imgFlags = IMG_INIT_PNG;
         if ((IMG_Init(imgFlags) & imgFlags) != imgFlags)
         {
-            SDL_Log("IMG_Init failed: %s", IMG_GetError());
+            ZLOG_ERROR("IMG_Init failed: %s", IMG_GetError());
             return false;
         }
 
@@ -35,64 +50,78 @@ namespace zelda::engine
             flags);
         if (!m_window)
         {
-            SDL_Log("SDL_CreateWindow failed: %s", SDL_GetError());
+            ZLOG_ERROR("SDL_CreateWindow failed: %s", SDL_GetError());
             return false;
         }
 
         m_renderer = SDL_CreateRenderer(
             m_window,
             -1,
-            SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC);
+            SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC | SDL_RENDERER_TARGETTEXTURE);
         if (!m_renderer)
         {
-            SDL_Log("SDL_CreateRenderer failed: %s", SDL_GetError());
+            ZLOG_ERROR("SDL_CreateRenderer failed: %s", SDL_GetError());
             return false;
         }
 
         m_windowWidth = windowWidth;
         m_windowHeight = windowHeight;
 
-        // camera starts same size as window
-        m_camera.width = windowWidth;
-        m_camera.height = windowHeight;
-
-        // player spawn
-        m_player.x = 64.0f;
-        m_player.y = 64.0f;
-
-        // enemy placeholder
-        m_enemy.x = 128.0f;
-        m_enemy.y = 96.0f;
-        m_enemy.hp = 3;
-
-        // create our 2x2 grid of rooms (each room is 10x8 tiles)
-        m_rooms.debugInitRooms(/*w=*/10, /*h=*/8);
+        if (!createSceneTarget())
+        {
+            // no render targets: let SDL scale the draw calls instead
+            ZLOG_WARN("Scene target unavailable (%s), scaling draw calls", SDL_GetError());
+            SDL_RenderSetLogicalSize(m_renderer, LOGICAL_WIDTH, LOGICAL_HEIGHT);
+            SDL_RenderSetIntegerScale(m_renderer, SDL_TRUE);
+        }
+        updatePresentRect();
 
         // Load textures
-        // tiles.png: floor (0..15 x), wall(16..31 x), player(32..47 x)
-        // player.png optional, but we support both keys
+        // tiles.png row 0: floor (0..15 x), wall(16..31 x)
+        //           row 1: 16 autotiled wall variants by neighbour mask
+        // sprites.png: animation frames (SpriteAnimation.h)
         if (!m_textures.loadTexture("tiles", "assets/tiles.png", m_renderer))
         {
-            SDL_Log("Failed to load tiles texture");
+            ZLOG_ERROR("Failed to load tiles texture");
             return false;
         }
 
-        // Optional separate player.png. If you didn't create one, we won't fail.
-        if (!m_textures.loadTexture("player", "assets/player.png", m_renderer))
+        // Sprites are optional: without them entities draw as flat boxes.
+        if (!m_textures.loadTexture("sprites", "assets/sprites.png", m_renderer))
+            ZLOG_WARN("Sprite texture missing, drawing flat boxes");
+
+        // HUD font: built in, rasterised once into an atlas
+        if (!m_text.createAtlas(m_renderer))
+            ZLOG_WARN("Text atlas unavailable (%s), HUD disabled", SDL_GetError());
+
+        // Sound is optional: without a device the game just runs silent.
+        m_audio.init();
+        loadSounds();
+
+        // create the game: 2x2 grid of rooms, or a generated dungeon
+        // (each room is 10x8 tiles), camera sees the logical resolution, not the window
         {
-            SDL_Log("Player texture missing, falling back to tiles strip");
-            // not fatal
+            game::WorldConfig config;
+            config.roomTilesW = 10;
+            config.roomTilesH = 8;
+            config.dungeonSeed = m_dungeonSeed;
+            config.viewWidth = LOGICAL_WIDTH;
+            config.viewHeight = LOGICAL_HEIGHT;
+            m_world.init(config);
+            m_world.rooms().ensureCurrentTextures(m_textures, m_renderer);
         }
 
-        // sync camera to current room so camera math is valid
+        // Snapshot buffers: sized once here, never reallocated while playing.
         {
-            game::TileMap &map = m_rooms.currentMap();
-            int mapWidthPx = map.width() * game::TileMap::TILE_SIZE;
-            int mapHeightPx = map.height() * game::TileMap::TILE_SIZE;
-            m_camera.follow(m_player.x, m_player.y, mapWidthPx, mapHeightPx);
+            const std::size_t bytes = m_world.snapshotCapacityBytes();
+            m_quickSave.reserve(bytes);
+            m_roomEntrySave.reserve(bytes);
+            m_rewind.init(REWIND_SECONDS * 60 / REWIND_INTERVAL_TICKS, bytes);
+            m_world.saveState(m_roomEntrySave);
         }
 
         m_lastTickMs = SDL_GetTicks();
+        m_fpsWindowMs = m_lastTickMs;
         m_accumulatorSec = 0.0f;
         m_running = true;
         return true;
@@ -100,10 +129,14 @@ namespace zelda::engine
 
     void Engine::run()
     {
+        int frames = 0;
         while (m_running)
         {
             uint32_t frameStartMs = SDL_GetTicks();
-            processInput();
+            {
+                game::AllocStageScope allocStage(game::AllocStage::Input);
+                processInput();
+            }
 
             uint32_t nowMs = SDL_GetTicks();
             uint32_t frameDeltaMs = nowMs - m_lastTickMs;
@@ -114,21 +147,141 @@ namespace zelda::engine
             if (m_accumulatorSec > 0.25f)
                 m_accumulatorSec = 0.25f;
 
-            while (m_accumulatorSec >= TARGET_DT_SEC)
+            const double ticksToMs = 1000.0 / SDL_GetPerformanceFrequency();
             {
-                updateFixedStep();
-                m_accumulatorSec -= TARGET_DT_SEC;
+                game::AllocStageScope allocStage(game::AllocStage::Update);
+                const Uint64 t0 = SDL_GetPerformanceCounter();
+
+                // a bounded number of catch-up steps; the rest of a long
+                // stall is dropped instead of being replayed as a burst
+                int steps = 0;
+                while (m_accumulatorSec >= TARGET_DT_SEC && steps < m_governor.maxCatchUpSteps())
+                {
+                    updateFixedStep();
+                    m_accumulatorSec -= TARGET_DT_SEC;
+                    ++steps;
+                }
+                const bool capped = m_accumulatorSec >= TARGET_DT_SEC;
+                if (capped)
+                {
+                    m_governor.noteDroppedTime(m_accumulatorSec);
+                    m_accumulatorSec = 0.0f;
+                }
+
+                const Uint64 t1 = SDL_GetPerformanceCounter();
+                m_governor.recordUpdate(static_cast<float>((t1 - t0) * ticksToMs), capped);
             }
 
-            renderFrame();
-            capFrameRate(frameStartMs);
+            // nothing on screen changed since the last present: don't draw
+            // at all (the window keeps showing that frame)
+            bool rendered = false;
+            ++m_loopFrames;
+            if (!m_sceneDirty)
+            {
+                ++m_idleFrames;
+                ++m_fpsIdleFrames;
+            }
+            else if (m_governor.beginRender())
+            {
+                game::AllocStageScope allocStage(game::AllocStage::Render);
+                const Uint64 t0 = SDL_GetPerformanceCounter();
+                renderFrame();
+                const Uint64 t1 = SDL_GetPerformanceCounter();
+                m_governor.recordRender(static_cast<float>((t1 - t0) * ticksToMs));
+
+                // not timed: with vsync this is where we wait for the display
+                SDL_RenderPresent(m_renderer);
+                m_sceneDirty = false;
+                rendered = true;
+                ++m_fpsFrames;
+            }
+            m_governor.endFrame();
+            updateFrameRate();
+            capFrameRate(frameStartMs, !rendered);
+
+            // from here on update / render must not touch the heap
+            game::AllocTracker::endFrame();
+            if (++frames == ALLOC_WARMUP_FRAMES)
+                game::AllocTracker::setSteadyState(true);
         }
     }
 
     void Engine::shutdown()
     {
+        // stop background room loading first
+        m_world.shutdown();
+        if (m_window)
+        {
+            const game::RoomManager &rooms = m_world.rooms();
+            ZLOG_INFO("Room prefetch: %llu requests, %llu hits, %llu misses",
+                      static_cast<unsigned long long>(rooms.prefetchRequests()),
+                      static_cast<unsigned long long>(rooms.prefetchHits()),
+                      static_cast<unsigned long long>(rooms.prefetchMisses()));
+
+            const game::TileBlockPool &blocks = rooms.tileBlocks();
+            ZLOG_INFO("Tile blocks: %zu shared (%llu chunk refs), %zu private, %llu copies on write, %zu KB saved",
+                      blocks.sharedBlocks(), static_cast<unsigned long long>(blocks.sharedRefs()),
+                      blocks.privateBlocks(), static_cast<unsigned long long>(blocks.copiesOnWrite()),
+                      blocks.bytesSaved() / 1024);
+
+            for (const game::Arena *arena : {&m_world.frameArena(), &rooms.levelArena()})
+            {
+                ZLOG_INFO("Arena %s: peak %zu bytes, capacity %zu bytes in %zu block(s), %llu resets",
+                          arena->name(), arena->peak(), arena->capacity(), arena->blockCount(),
+                          static_cast<unsigned long long>(arena->resetCount()));
+            }
+
+            if (m_renderFrames > 0)
+            {
+                const double n = static_cast<double>(m_renderFrames);
+                ZLOG_INFO("Render: %.1f draws, %.1f state changes, %.1f skipped per frame",
+                          m_renderDraws / n, m_renderStateChanges / n, m_renderStateSkipped / n);
+                ZLOG_INFO("HUD: %llu text layouts in %llu frames",
+                          static_cast<unsigned long long>(m_hud.layoutCount()),
+                          static_cast<unsigned long long>(m_renderFrames));
+            }
+            if (m_loopFrames > 0)
+            {
+                ZLOG_INFO("Idle: %llu of %llu frames had nothing new to draw (%.1f%% renders saved)",
+                          static_cast<unsigned long long>(m_idleFrames),
+                          static_cast<unsigned long long>(m_loopFrames),
+                          m_idleFrames * 100.0 / m_loopFrames);
+            }
+
+            m_governor.logSummary();
+            m_world.ai().logSummary();
+            m_world.visibility().logSummary();
+            const game::BehaviorStats &bs = m_world.behaviors().stats();
+            ZLOG_INFO("Behaviours: %zu running, %llu started, %llu resumes, %llu timers, %llu range checks",
+                      m_world.behaviors().running(),
+                      static_cast<unsigned long long>(bs.started),
+                      static_cast<unsigned long long>(bs.resumes),
+                      static_cast<unsigned long long>(bs.timersFired),
+                      static_cast<unsigned long long>(bs.rangeChecks));
+
+            const game::LogStats ls = game::logStats();
+            ZLOG_INFO("Log: %llu records written, %llu dropped (ring full)",
+                      static_cast<unsigned long long>(ls.written), static_cast<unsigned long long>(ls.dropped));
+
+            // AllocTracker prints synchronously (it can't log through the
+            // ring from inside operator new): let the queue catch up first
+            game::logFlush();
+            game::AllocTracker::setSteadyState(false);
+            game::AllocTracker::logSummary();
+        }
+
+        // close the device before the samples it reads go away
+        m_audio.shutdown();
+
         // free textures before renderer goes away
+        if (m_sceneTarget)
+        {
+            SDL_DestroyTexture(m_sceneTarget);
+            m_sceneTarget = nullptr;
+        }
         m_textures.clear();
+        m_text.releaseAtlas();
+        m_world.rooms().releaseRenderCaches();
 
         if (m_renderer)
         {
@@ -143,6 +296,9 @@ namespace zelda::engine
 
         IMG_Quit();
         SDL_Quit();
+
+        // last: everything above may still log
+        game::logStop();
     }
 
     void Engine::processInput()
@@ -150,406 +306,304 @@ namespace zelda::engine
         SDL_Event e;
         while (SDL_PollEvent(&e))
         {
+            // any input / window event may change what's shown
+            m_sceneDirty = true;
+
             if (e.type == SDL_QUIT)
                 m_running = false;
             else if (e.type == SDL_KEYDOWN && e.key.keysym.sym == SDLK_ESCAPE)
                 m_running = false;
+            else if (e.type == SDL_WINDOWEVENT && e.window.event == SDL_WINDOWEVENT_SIZE_CHANGED)
+                updatePresentRect();
+            else if (e.type == SDL_KEYDOWN && !e.key.repeat)
+            {
+                switch (e.key.keysym.sym)
+                {
+                    case SDLK_F5: // quicksave
+                    {
+                        Uint64 t0 = SDL_GetPerformanceCounter();
+                        bool ok = m_world.saveState(m_quickSave);
+                        Uint64 t1 = SDL_GetPerformanceCounter();
+                        ZLOG_INFO("Quicksave %s: %zu bytes in %.1f us",
+                                  ok ? "ok" : "FAILED",
+                                  m_quickSave.size(),
+                                  (t1 - t0) * 1000000.0 / SDL_GetPerformanceFrequency());
+                        break;
+                    }
+                    case SDLK_F9: // quickload
+                        if (!m_quickSave.empty() && !m_world.loadState(m_quickSave))
+                            ZLOG_WARN("Quickload failed");
+                        handleWorldEvents();
+                        break;
+                    case SDLK_F6: // retry room (state when we walked in)
+                        if (!m_roomEntrySave.empty() && !m_world.loadState(m_roomEntrySave))
+                            ZLOG_WARN("Room retry failed");
+                        handleWorldEvents();
+                        break;
+                    case SDLK_F3: // render / AI stats for the last frame, HUD debug lines on / off
+                    {
+                        m_hud.setDebugVisible(!m_hud.debugVisible());
+                        const game::RenderStats &rs = m_renderQueue.lastStats();
+                        ZLOG_INFO("Render: %u commands, %u draws, %u state changes, %u skipped",
+                                  rs.commands, rs.draws, rs.stateChanges, rs.stateSkipped);
+                        const game::AiStats &ai = m_world.ai().lastTick();
+                        ZLOG_INFO("AI: %llu thinks, %llu deferred, %llu skipped, %.1f us",
+                                  static_cast<unsigned long long>(ai.thinks),
+                                  static_cast<unsigned long long>(ai.deferred),
+                                  static_cast<unsigned long long>(ai.skipped), ai.thinkUs);
+                        break;
+                    }
+                    default:
+                        break;
+                }
+            }
         }
 
         const Uint8 *keys = SDL_GetKeyboardState(nullptr);
-        m_inputUp = keys[SDL_SCANCODE_UP] || keys[SDL_SCANCODE_W];
-        m_inputDown = keys[SDL_SCANCODE_DOWN] || keys[SDL_SCANCODE_S];
-        m_inputLeft = keys[SDL_SCANCODE_LEFT] || keys[SDL_SCANCODE_A];
-        m_inputRight = keys[SDL_SCANCODE_RIGHT] || keys[SDL_SCANCODE_D];
-
-        bool attackPressed = keys[SDL_SCANCODE_SPACE] || keys[SDL_SCANCODE_J];
-        if (attackPressed && m_player.attackCooldown <= 0.0f)
-        {
-            m_player.attacking = true;
-            m_player.attackCooldown = 0.3f;
-            spawnPlayerAttack();
-        }
+        m_rewinding = keys[SDL_SCANCODE_R] != 0;
+        m_input.up = keys[SDL_SCANCODE_UP] || keys[SDL_SCANCODE_W];
+        m_input.down = keys[SDL_SCANCODE_DOWN] || keys[SDL_SCANCODE_S];
+        m_input.left = keys[SDL_SCANCODE_LEFT] || keys[SDL_SCANCODE_A];
+        m_input.right = keys[SDL_SCANCODE_RIGHT] || keys[SDL_SCANCODE_D];
+        m_input.attack = keys[SDL_SCANCODE_SPACE] || keys[SDL_SCANCODE_J];
     }
 
     void Engine::updateFixedStep()
     {
-        // input -> player intent
-        m_player.moveUp = m_inputUp;
-        m_player.moveDown = m_inputDown;
-        m_player.moveLeft = m_inputLeft;
-        m_player.moveRight = m_inputRight;
-
-        // movement + collision
-        movePlayerWithCollision(TARGET_DT_SEC);
-
-        // room-to-room transitions
-        handleRoomTransition();
-
-        // attack cooldown
-        if (m_player.attackCooldown > 0.0f)
+        // Holding R plays the last few seconds backwards instead of simulating.
+        if (m_rewinding)
         {
-            m_player.attackCooldown -= TARGET_DT_SEC;
-            if (m_player.attackCooldown <= 0.0f)
-                m_player.attacking = false;
+            if (++m_rewindTick >= REWIND_INTERVAL_TICKS)
+            {
+                m_rewindTick = 0;
+                if (const game::SaveState *snap = m_rewind.pop())
+                {
+                    m_world.loadState(*snap);
+                    handleWorldEvents();
+                    m_sceneDirty = true;
+                }
+            }
+            return;
         }
 
-        // camera follow & clamp to room
+        // record history for rewind
+        if (++m_rewindTick >= REWIND_INTERVAL_TICKS)
         {
-            game::TileMap &map = m_rooms.currentMap();
-            int mapWidthPx = map.width() * game::TileMap::TILE_SIZE;
-            int mapHeightPx = map.height() * game::TileMap::TILE_SIZE;
-            m_camera.follow(m_player.x, m_player.y, mapWidthPx, mapHeightPx);
+            m_rewindTick = 0;
+            game::SaveState &slot = m_rewind.push();
+            if (!m_world.saveState(slot))
+                m_rewind.pop();
         }
 
-        // attacks + combat
-        updateAttacks(TARGET_DT_SEC);
-        handleCombat();
-    }
-
-    void Engine::movePlayerWithCollision(float dtSec)
-    {
-        game::TileMap &map = m_rooms.currentMap();
-
-        SDL_FPoint vel = m_player.computeVelocity();
-        float dx = vel.x * dtSec;
-        float dy = vel.y * dtSec;
-
-        if (dx != 0.0f)
-        {
-            float newX = m_player.x + dx;
-            SDL_Rect rectX{
-                static_cast<int>(newX),
-                static_cast<int>(m_player.y),
-                game::Player::WIDTH,
-                game::Player::HEIGHT};
-            if (!map.rectCollidesSolid(rectX))
-                m_player.x = newX;
-        }
+        m_world.step(m_input);
+        handleWorldEvents();
+        if (m_world.visualChanged())
+            m_sceneDirty = true;
 
-        if (dy != 0.0f)
+        // effects (the governor may run them at a lower rate)
+        m_effectsDtSec += TARGET_DT_SEC;
+        if (++m_effectsTick >= m_governor.effectsStride())
         {
-            float newY = m_player.y + dy;
-            SDL_Rect rectY{
-                static_cast<int>(m_player.x),
-                static_cast<int>(newY),
-                game::Player::WIDTH,
-                game::Player::HEIGHT};
-            if (!map.rectCollidesSolid(rectY))
-                m_player.y = newY;
+            m_particles.update(m_effectsDtSec);
+            m_effectsDtSec = 0.0f;
+            m_effectsTick = 0;
         }
+        if (m_particles.count() > 0)
+            m_sceneDirty = true;
     }
 
-    void Engine::handleRoomTransition()
+    void Engine::handleWorldEvents()
     {
-        game::TileMap &map = m_rooms.currentMap();
-
-        const int tileSize = game::TileMap::TILE_SIZE;
-        const int mapPixW = map.width() * tileSize;
-        const int mapPixH = map.height() * tileSize;
-
-        // Spawn points after walking through a door.
-        const float doorwayCenterX = 7 * tileSize + 4.0f;
-        const float topEntranceY = tileSize * 2.0f;
-        const float bottomEntranceY = mapPixH - tileSize * 2.0f;
-
-        const float leftEntranceX = tileSize * 2.0f;
-        const float rightEntranceX = mapPixW - tileSize * 2.0f;
-        const float midY = 3 * tileSize + 4.0f;
-
-        SDL_Rect playerRect{
-            static_cast<int>(m_player.x),
-            static_cast<int>(m_player.y),
-            game::Player::WIDTH,
-            game::Player::HEIGHT};
-
-        SDL_Rect northDoorTrigger{
-            6 * tileSize,
-            -8,
-            3 * tileSize,
-            16};
-
-        SDL_Rect southDoorTrigger{
-            6 * tileSize,
-            mapPixH - tileSize,
-            3 * tileSize,
-            tileSize + 8};
-
-        SDL_Rect westDoorTrigger{
-            -8,
-            3 * tileSize,
-            16,
-            2 * tileSize};
-
-        SDL_Rect eastDoorTrigger{
-            mapPixW - tileSize,
-            3 * tileSize,
-            tileSize + 8,
-            2 * tileSize};
-
-        // NORTH
-        if (SDL_HasIntersection(&playerRect, &northDoorTrigger))
+        for (const game::WorldEvent &ev : m_world.events())
         {
-            int beforeX = m_rooms.roomX();
-            int beforeY = m_rooms.roomY();
-            m_rooms.goNorth();
-            if (m_rooms.roomX() != beforeX || m_rooms.roomY() != beforeY)
+            switch (ev.type)
             {
-                game::TileMap &newMap = m_rooms.currentMap();
-                int newMapPixH = newMap.height() * tileSize;
-
-                float newBottomEntranceY = newMapPixH - tileSize * 2.0f;
-                m_player.x = doorwayCenterX;
-                m_player.y = newBottomEntranceY;
-
-                int newMapWidthPx = newMap.width() * tileSize;
-                int newMapHeightPx = newMap.height() * tileSize;
-                m_camera.follow(m_player.x, m_player.y, newMapWidthPx, newMapHeightPx);
+                case game::WorldEvent::Type::PlayerAttack:
+                    m_audio.play(m_sfxSwing, 0.5f, panForX(ev.x));
+                    break;
+                case game::WorldEvent::Type::EnemyHit:
+                    // hit sparks
+                    m_particles.emitBurst(ev.x, ev.y, burstCount(48), SDL_Color{255, 240, 160, 255}, 90.0f, 0.35f);
+                    m_audio.play(m_sfxHit, 0.8f, panForX(ev.x));
+                    break;
+                case game::WorldEvent::Type::EnemyKilled:
+                    ZLOG_TRACE("Enemy killed at (%.0f, %.0f), tick %llu", ev.x, ev.y,
+                               static_cast<unsigned long long>(m_world.tick()));
+                    // death burst
+                    m_particles.emitBurst(ev.x, ev.y, burstCount(400), SDL_Color{200, 40, 40, 255}, 140.0f, 0.8f);
+                    m_audio.play(m_sfxDeath, 1.0f, panForX(ev.x));
+                    break;
+                case game::WorldEvent::Type::RoomEntered:
+                    ZLOG_DEBUG("Entered room (%d, %d)", m_world.rooms().roomX(), m_world.rooms().roomY());
+                    m_world.rooms().ensureCurrentTextures(m_textures, m_renderer);
+                    m_particles.clear();
+                    // "retry room" point (not while rewinding / reloading)
+                    if (!m_rewinding)
+                        m_world.saveState(m_roomEntrySave);
+                    break;
+                default:
+                    break;
             }
-            return;
         }
 
-        // SOUTH
-        if (SDL_HasIntersection(&playerRect, &southDoorTrigger))
-        {
-            int beforeX = m_rooms.roomX();
-            int beforeY = m_rooms.roomY();
-            m_rooms.goSouth();
-            if (m_rooms.roomX() != beforeX || m_rooms.roomY() != beforeY)
-            {
-                game::TileMap &newMap = m_rooms.currentMap();
-                m_player.x = doorwayCenterX;
-                m_player.y = topEntranceY;
-
-                int newMapWidthPx = newMap.width() * tileSize;
-                int newMapHeightPx = newMap.height() * tileSize;
-                m_camera.follow(m_player.x, m_player.y, newMapWidthPx, newMapHeightPx);
-            }
-            return;
-        }
-
-        // WEST
-        if (SDL_HasIntersection(&playerRect, &westDoorTrigger))
-        {
-            int beforeX = m_rooms.roomX();
-            int beforeY = m_rooms.roomY();
-            m_rooms.goWest();
-            if (m_rooms.roomX() != beforeX || m_rooms.roomY() != beforeY)
-            {
-                game::TileMap &newMap = m_rooms.currentMap();
-                int newMapPixW = newMap.width() * tileSize;
-
-                m_player.x = newMapPixW - tileSize * 2.0f; // enter from east
-                m_player.y = midY;
-
-                int newMapWidthPx = newMap.width() * tileSize;
-                int newMapHeightPx = newMap.height() * tileSize;
-                m_camera.follow(m_player.x, m_player.y, newMapWidthPx, newMapHeightPx);
-            }
-            return;
-        }
-
-        // EAST
-        if (SDL_HasIntersection(&playerRect, &eastDoorTrigger))
-        {
-            int beforeX = m_rooms.roomX();
-            int beforeY = m_rooms.roomY();
-            m_rooms.goEast();
-            if (m_rooms.roomX() != beforeX || m_rooms.roomY() != beforeY)
-            {
-                game::TileMap &newMap = m_rooms.currentMap();
-
-                m_player.x = leftEntranceX; // enter from west
-                m_player.y = midY;
-
-                int newMapWidthPx = newMap.width() * tileSize;
-                int newMapHeightPx = newMap.height() * tileSize;
-                m_camera.follow(m_player.x, m_player.y, newMapWidthPx, newMapHeightPx);
-            }
-            return;
-        }
+        // prefetched tilesets only need an upload now
+        m_world.rooms().uploadPendingTilesets(m_textures, m_renderer);
     }
 
-    void Engine::spawnPlayerAttack()
+    void Engine::loadSounds()
     {
-        const int range = 18;
-        int ax = static_cast<int>(m_player.x);
-        int ay = static_cast<int>(m_player.y);
-        int w = 12, h = 12;
-
-        if (m_inputUp)
-            ay -= range;
-        else if (m_inputDown)
-            ay += game::Player::HEIGHT;
-        else if (m_inputLeft)
-            ax -= range;
-        else if (m_inputRight)
-            ax += game::Player::WIDTH;
-        else
-            ay += game::Player::HEIGHT;
+        // WAVs under assets/sfx and assets/music win; missing sfx get a
+        // generated placeholder so there is always something to hear.
+        m_sfxSwing = m_audio.loadWav("assets/sfx/swing.wav");
+        if (m_sfxSwing < 0)
+            m_sfxSwing = m_audio.synthBlip(900.0f, 300.0f, 0.12f, 0.6f);
+
+        m_sfxHit = m_audio.loadWav("assets/sfx/hit.wav");
+        if (m_sfxHit < 0)
+            m_sfxHit = m_audio.synthBlip(220.0f, 110.0f, 0.10f, 0.2f);
+
+        m_sfxDeath = m_audio.loadWav("assets/sfx/death.wav");
+        if (m_sfxDeath < 0)
+            m_sfxDeath = m_audio.synthBlip(180.0f, 40.0f, 0.45f, 0.5f);
+
+        m_music = m_audio.loadWav("assets/music/dungeon.wav");
+        if (m_music >= 0)
+            m_audio.play(m_music, 0.35f, 0.0f, true);
+    }
 
-        m_attacks.emplace_back(ax, ay, w, h);
+    int Engine::burstCount(int full) const
+    {
+        return std::max(1, static_cast<int>(full * m_governor.particleScale()));
     }
 
-    void Engine::updateAttacks(float dtSec)
+    float Engine::panForX(float mapX) const
     {
-        for (auto &atk : m_attacks)
-            atk.lifetime -= dtSec;
-
-        m_attacks.erase(
-            std::remove_if(
-                m_attacks.begin(),
-                m_attacks.end(),
-                [](const game::PlayerAttack &a)
-                {
-                    return a.isExpired();
-                }),
-            m_attacks.end());
+        // left edge of the screen = hard left, right edge = hard right
+        const game::Camera &camera = m_world.camera();
+        if (camera.width <= 0)
+            return 0.0f;
+        return std::clamp((mapX - camera.x) / camera.width * 2.0f - 1.0f, -1.0f, 1.0f);
     }
 
-    void Engine::handleCombat()
+    bool Engine::createSceneTarget()
     {
-        if (m_enemy.hp <= 0)
-            return;
+        m_sceneTarget = SDL_CreateTexture(
+            m_renderer,
+            SDL_PIXELFORMAT_RGBA8888,
+            SDL_TEXTUREACCESS_TARGET,
+            LOGICAL_WIDTH,
+            LOGICAL_HEIGHT);
+        if (!m_sceneTarget)
+            return false;
 
-        for (auto &atk : m_attacks)
-        {
-            SDL_Rect eRect = m_enemy.getBounds();
-            if (SDL_HasIntersection(&atk.rect, &eRect))
-            {
-                m_enemy.hp--;
-                if (m_enemy.hp <= 0)
-                {
-                    m_enemy.x = -1000.0f;
-                    m_enemy.y = -1000.0f;
-                }
-                break;
-            }
-        }
+        // opaque copy, hard pixel edges
+        SDL_SetTextureBlendMode(m_sceneTarget, SDL_BLENDMODE_NONE);
+        SDL_SetTextureScaleMode(m_sceneTarget, SDL_ScaleModeNearest);
+        return true;
+    }
+
+    void Engine::updatePresentRect()
+    {
+        // output size is in pixels (high-dpi / fullscreen desktop), not window units
+        int outW = m_windowWidth;
+        int outH = m_windowHeight;
+        SDL_GetRendererOutputSize(m_renderer, &outW, &outH);
+
+        // largest whole multiple that fits, centred, the rest is letterbox
+        // (only blitted with a scene target; without one SDL's logical size does this)
+        m_presentScale = std::max(1, std::min(outW / LOGICAL_WIDTH, outH / LOGICAL_HEIGHT));
+        m_presentRect.w = LOGICAL_WIDTH * m_presentScale;
+        m_presentRect.h = LOGICAL_HEIGHT * m_presentScale;
+        m_presentRect.x = (outW - m_presentRect.w) / 2;
+        m_presentRect.y = (outH - m_presentRect.h) / 2;
+
+        if (m_sceneTarget)
+            ZLOG_INFO("Presenting %dx%d scene at %dx to %dx%d",
+                      LOGICAL_WIDTH, LOGICAL_HEIGHT, m_presentScale, outW, outH);
+        else
+            ZLOG_INFO("Presenting through SDL logical size %dx%d (integer scale) to %dx%d",
+                      LOGICAL_WIDTH, LOGICAL_HEIGHT, outW, outH);
     }
 
     void Engine::renderFrame()
     {
-        // Clear background
+        // Clear background (the scene target when we have one)
+        if (m_sceneTarget)
+            SDL_SetRenderTarget(m_renderer, m_sceneTarget);
         SDL_SetRenderDrawColor(m_renderer, 8, 8, 12, 255);
         SDL_RenderClear(m_renderer);
 
-        game::TileMap &map = m_rooms.currentMap();
-        SDL_Rect view = m_camera.getViewRect();
-
-        const int tileSize = game::TileMap::TILE_SIZE;
-        int mapPxW = map.width() * tileSize;
-        int mapPxH = map.height() * tileSize;
-
-        // Center the map in the view if it's smaller
-        int offsetX = (mapPxW < m_camera.width) ? (m_camera.width - mapPxW) / 2 : 0;
-        int offsetY = (mapPxH < m_camera.height) ? (m_camera.height - mapPxH) / 2 : 0;
+        SDL_Texture *tilesTex = m_textures.get(m_world.rooms().currentTilesetKey());
 
-        SDL_Texture *tilesTex = m_textures.get("tiles");
-        SDL_Texture *playerTex = nullptr;
-        if (!playerTex)
-        {
-            // If player.png didn't load, reuse the tiles strip.
-            playerTex = tilesTex;
-        }
+        // everything is recorded, then sorted and submitted in one flush
+        m_renderQueue.begin(m_renderer);
+        game::recordWorld(m_renderQueue, m_sprites, m_world, &m_particles, tilesTex, m_textures.get("sprites"));
 
-        // Tilesheet assumptions:
-        // [0,0]-[15,15]   = floor
-        // [16,0]-[31,15]  = wall
-        SDL_Rect srcFloor{0, 0, 16, 16};
-        SDL_Rect srcWall{16, 0, 16, 16};
-
-        // Player sprite assumptions:
-        // either its own texture at 0,0
-        // or on tiles.png at x=32
-        SDL_Rect srcPlayer{0, 0, 16, 16};
-        if (playerTex == tilesTex)
+        // HUD on top, one batch; lines only re-layout when their value changed
+        m_hud.update(m_world);
+        if (m_hud.debugVisible())
         {
-            // using combined strip: third slot
-            srcPlayer.x = 32;
-            srcPlayer.y = 0;
-            srcPlayer.w = 16;
-            srcPlayer.h = 16;
+            game::HudDebugInfo info;
+            info.fps = m_fps;
+            info.updateMs = m_governor.updateMs();
+            info.renderMs = m_governor.renderMs();
+            info.draws = m_renderQueue.lastStats().draws;
+            info.thinks = m_world.ai().lastTick().thinks;
+            info.tier = qualityTierName(m_governor.tier());
+            info.idlePercent = m_idlePercent;
+            info.rendersSaved = m_idleFrames;
+            m_hud.updateDebug(info);
         }
+        m_hud.record(m_renderQueue, m_text, LOGICAL_WIDTH);
+        m_renderQueue.flush();
 
-        // draw tilemap
-        for (int ty = 0; ty < map.height(); ++ty)
-        {
-            for (int tx = 0; tx < map.width(); ++tx)
-            {
-                int tileID = map.getTileId(tx, ty);
-
-                SDL_Rect dst{
-                    tx * tileSize - view.x + offsetX,
-                    ty * tileSize - view.y + offsetY,
-                    tileSize,
-                    tileSize};
-
-                if (!tilesTex)
-                {
-                    // fallback debug colors if texture didn't load
-                    if (tileID == 1)
-                        SDL_SetRenderDrawColor(m_renderer, 80, 40, 40, 255);
-                    else
-                        SDL_SetRenderDrawColor(m_renderer, 40, 60, 80, 255);
-                    SDL_RenderFillRect(m_renderer, &dst);
-                }
-                else
-                {
-                    SDL_Rect *srcRect = (tileID == 1) ? &srcWall : &srcFloor;
-                    SDL_RenderCopy(m_renderer, tilesTex, srcRect, &dst);
-                }
-            }
-        }
+        const game::RenderStats &rs = m_renderQueue.lastStats();
+        ++m_renderFrames;
+        m_renderDraws += rs.draws;
+        m_renderStateChanges += rs.stateChanges;
+        m_renderStateSkipped += rs.stateSkipped;
 
-        // draw enemy (still a red box)
-        if (m_enemy.hp > 0)
+        // one scaled blit of the whole scene to the window
+        if (m_sceneTarget)
         {
-            SDL_Rect e{
-                static_cast<int>(m_enemy.x) - view.x + offsetX,
-                static_cast<int>(m_enemy.y) - view.y + offsetY,
-                game::Enemy::WIDTH,
-                game::Enemy::HEIGHT};
-
-            SDL_SetRenderDrawColor(m_renderer, 180, 40, 40, 255);
-            SDL_RenderFillRect(m_renderer, &e);
+            SDL_SetRenderTarget(m_renderer, nullptr);
+            SDL_SetRenderDrawColor(m_renderer, 0, 0, 0, 255);
+            SDL_RenderClear(m_renderer);
+            SDL_RenderCopy(m_renderer, m_sceneTarget, nullptr, &m_presentRect);
         }
+    }
 
-        // draw attack hitboxes (yellow boxes)
-        for (auto &atk : m_attacks)
-        {
-            SDL_Rect r{
-                atk.rect.x - view.x + offsetX,
-                atk.rect.y - view.y + offsetY,
-                atk.rect.w,
-                atk.rect.h};
-
-            SDL_SetRenderDrawColor(m_renderer, 255, 255, 0, 180);
-            SDL_RenderFillRect(m_renderer, &r);
-        }
+    void Engine::updateFrameRate()
+    {
+        // frames drawn / left idle over the last whole second
+        const uint32_t nowMs = SDL_GetTicks();
+        const uint32_t windowMs = nowMs - m_fpsWindowMs;
+        if (windowMs < 1000)
+            return;
 
-        // draw player using texture
-        {
-            // draw player using fallback rect color only
-            {
-                SDL_Rect dstPlayer{
-                    static_cast<int>(m_player.x) - view.x + offsetX,
-                    static_cast<int>(m_player.y) - view.y + offsetY,
-                    game::Player::WIDTH,
-                    game::Player::HEIGHT};
-
-                // bright green placeholder
-                SDL_SetRenderDrawColor(m_renderer, 0, 200, 0, 255);
-                SDL_RenderFillRect(m_renderer, &dstPlayer);
-            }
+        const int loops = m_fpsFrames + m_fpsIdleFrames;
+        m_fps = static_cast<int>(m_fpsFrames * 1000u / windowMs);
+        m_idlePercent = loops > 0 ? m_fpsIdleFrames * 100 / loops : 0;
+        m_fpsFrames = 0;
+        m_fpsIdleFrames = 0;
+        m_fpsWindowMs = nowMs;
 
-            SDL_RenderPresent(m_renderer);
-        }
+        // the debug lines changed even if the game didn't
+        if (m_hud.debugVisible())
+            m_sceneDirty = true;
     }
 
-    void Engine::capFrameRate(uint32_t frameStartMs)
+    void Engine::capFrameRate(uint32_t frameStartMs, bool idle)
     {
         uint32_t frameTimeMs = SDL_GetTicks() - frameStartMs;
-        if (frameTimeMs < FRAME_MS_CAP)
+        if (frameTimeMs >= FRAME_MS_CAP)
+            return;
+
+        // idle: sleep until the next frame is due or input arrives,
+        // whichever comes first (the event stays queued for processInput)
+        if (idle)
+            SDL_WaitEventTimeout(nullptr, static_cast<int>(FRAME_MS_CAP - frameTimeMs));
+        else
             SDL_Delay(FRAME_MS_CAP - frameTimeMs);
     }
 }
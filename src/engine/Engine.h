@@ -2,87 +2,19 @@
 
 #include <SDL2/SDL.h>
 #include <vector>
+#include <array>
 #include <algorithm>
 
-#include "RoomManager.h"
-#include "TileMap.h"
-#include "Camera.h"
+#include "World.h"
 #include "TextureManager.h"
-
-namespace zelda::game {
-
-    struct PlayerAttack {
-        SDL_Rect rect;
-        float lifetime;
-        PlayerAttack(int x,int y,int w,int h)
-        {
-            rect = {x,y,w,h};
-            lifetime = 0.15f;
-        }
-        bool isExpired() const { return lifetime <= 0.0f; }
-    };
-
-    struct Player {
-        static constexpr int WIDTH  = 14;
-        static constexpr int HEIGHT = 14;
-
-        float x = 0.f;
-        float y = 0.f;
-
-        bool moveUp = false;
-        bool moveDown = false;
-        bool moveLeft = false;
-        bool moveRight = false;
-
-        bool attacking = false;
-        float attackCooldown = 0.0f;
-
-        float speed = 80.0f; // px/sec
-
-        SDL_FPoint computeVelocity() const
-        {
-            float vx = 0.f;
-            float vy = 0.f;
-            if (moveUp)    vy -= 1.f;
-            if (moveDown)  vy += 1.f;
-            if (moveLeft)  vx -= 1.f;
-            if (moveRight) vx += 1.f;
-
-            float mag2 = vx*vx + vy*vy;
-            if (mag2 > 1.0f)
-            {
-                float invMag = 1.0f / SDL_sqrtf(mag2);
-                vx *= invMag;
-                vy *= invMag;
-            }
-
-            vx *= speed;
-            vy *= speed;
-
-            SDL_FPoint out{vx, vy};
-            return out;
-        }
-    };
-
-    struct Enemy {
-        static constexpr int WIDTH  = 14;
-        static constexpr int HEIGHT = 14;
-
-        float x = 0.f;
-        float y = 0.f;
-        int hp = 3;
-
-        SDL_Rect getBounds() const
-        {
-            return SDL_Rect{
-                static_cast<int>(x),
-                static_cast<int>(y),
-                WIDTH,
-                HEIGHT
-            };
-        }
-    };
-}
+#include "ParticleSystem.h"
+#include "RenderQueue.h"
+#include "SpriteBatch.h"
+#include "TextRenderer.h"
+#include "Hud.h"
+#include "AudioSystem.h"
+#include "SaveState.h"
+#include "FrameGovernor.h"
 
 namespace zelda::engine
 {
@@ -92,6 +24,10 @@ namespace zelda::engine
         Engine();
         ~Engine();
 
+        // Play a generated dungeon with this seed (0 = the 2x2 debug rooms).
+        // Call before init().
+        void setDungeonSeed(std::uint64_t seed) { m_dungeonSeed = seed; }
+
         bool init(const char *title, int windowWidth, int windowHeight, bool fullscreen);
         void run();
         void shutdown();
@@ -99,43 +35,96 @@ namespace zelda::engine
     private:
         void processInput();
         void updateFixedStep();
-        void movePlayerWithCollision(float dtSec);
-        void handleRoomTransition();
-        void spawnPlayerAttack();
-        void updateAttacks(float dtSec);
-        void handleCombat();
+        void handleWorldEvents();
+        void loadSounds();
+        float panForX(float mapX) const;
+        int burstCount(int full) const;
         void renderFrame();
-        void capFrameRate(uint32_t frameStartMs);
+        bool createSceneTarget();
+        void updatePresentRect();
+        void updateFrameRate();
+        void capFrameRate(uint32_t frameStartMs, bool idle);
 
         // SDL
         SDL_Window   *m_window   = nullptr;
         SDL_Renderer *m_renderer = nullptr;
 
+        std::uint64_t m_dungeonSeed = 0;
+
         int m_windowWidth  = 0;
         int m_windowHeight = 0;
 
+        // The scene is drawn at a fixed pixel-art resolution into
+        // m_sceneTarget, then blitted once, integer scaled and centred,
+        // to the window. Fill cost doesn't grow with the window.
+        static constexpr int LOGICAL_WIDTH  = 320;
+        static constexpr int LOGICAL_HEIGHT = 240;
+        SDL_Texture *m_sceneTarget = nullptr;
+        SDL_Rect     m_presentRect{0, 0, LOGICAL_WIDTH, LOGICAL_HEIGHT};
+        int          m_presentScale = 1;
+
         // timing
         uint32_t m_lastTickMs     = 0;
         float    m_accumulatorSec = 0.0f;
         bool     m_running        = false;
 
         // fixed timestep config
-        static constexpr float TARGET_DT_SEC    = 1.0f / 60.0f;
+        static constexpr float TARGET_DT_SEC    = zelda::game::World::TICK_SEC;
         static constexpr uint32_t FRAME_MS_CAP = 1000 / 60; // ~16ms
 
-        // input state
-        bool m_inputUp    = false;
-        bool m_inputDown  = false;
-        bool m_inputLeft  = false;
-        bool m_inputRight = false;
+        // frame budget: what update / render cost decides how much effect work we do
+        FrameGovernor m_governor;
+        float m_effectsDtSec = 0.0f; // effect time not simulated yet (effects stride)
+        int   m_effectsTick  = 0;
+
+        // allocation tracking builds: frames before update / render must stop allocating
+        static constexpr int ALLOC_WARMUP_FRAMES = 120;
+
+        // input state (sampled every frame, consumed by the next tick)
+        zelda::game::WorldInput m_input;
 
         // game state
-        zelda::game::Player m_player;
-        zelda::game::Enemy  m_enemy;
-        zelda::game::Camera m_camera;
-        std::vector<zelda::game::PlayerAttack> m_attacks;
+        zelda::game::World m_world;
+        zelda::game::ParticleSystem m_particles; // hit / death effects
+
+        // sound
+        zelda::game::AudioSystem m_audio;
+        zelda::game::SoundId m_sfxSwing = -1;
+        zelda::game::SoundId m_sfxHit   = -1;
+        zelda::game::SoundId m_sfxDeath = -1;
+        zelda::game::SoundId m_music    = -1;
+
+        // snapshots
+        static constexpr int REWIND_SECONDS        = 5;
+        static constexpr int REWIND_INTERVAL_TICKS = 4; // record at 15 Hz
+        zelda::game::SaveState    m_quickSave;     // F5 / F9
+        zelda::game::SaveState    m_roomEntrySave; // F6, taken on every room change
+        zelda::game::SnapshotRing m_rewind;        // hold R
+        bool m_rewinding  = false;
+        int  m_rewindTick = 0;
 
-        zelda::game::RoomManager    m_rooms;
         zelda::game::TextureManager m_textures; // texture cache
+
+        // rendering
+        zelda::game::RenderQueue m_renderQueue;
+        zelda::game::SpriteBatch m_sprites;
+        zelda::game::TextRenderer m_text; // HUD glyph atlas + batch
+        zelda::game::Hud m_hud;           // F3 toggles its debug lines
+        uint32_t m_fpsWindowMs = 0;       // start of the current one second FPS window
+        int m_fpsFrames = 0;
+        int m_fpsIdleFrames = 0;
+        int m_fps = 0;
+        int m_idlePercent = 0;            // of the last second's loop iterations
+
+        // Render on change: input, visible world changes (World::visualChanged)
+        // and live particles mark the scene dirty; clean frames skip
+        // renderFrame() / present and wait for events instead.
+        bool m_sceneDirty = true;
+        uint64_t m_loopFrames = 0;
+        uint64_t m_idleFrames = 0; // renders saved
+        uint64_t m_renderFrames       = 0;
+        uint64_t m_renderDraws        = 0;
+        uint64_t m_renderStateChanges = 0;
+        uint64_t m_renderStateSkipped = 0;
     };
 }
@@ -0,0 +1,130 @@
+#include "FrameGovernor.h"
+#include "Log.h"
+
+#include <SDL2/SDL.h>
+
+namespace zelda::engine
+{
+    namespace
+    {
+        constexpr float SMOOTHING = 0.1f; // EMA weight of the newest frame
+    }
+
+    const char* qualityTierName(QualityTier tier)
+    {
+        switch (tier)
+        {
+            case QualityTier::Full:            return "full";
+            case QualityTier::ReducedEffects:  return "reduced-effects";
+            case QualityTier::HalfRateEffects: return "half-rate-effects";
+            case QualityTier::SkipFrames:      return "skip-frames";
+            default:                           return "?";
+        }
+    }
+
+    FrameGovernor::FrameGovernor(const FrameGovernorConfig& config)
+        : m_config(config)
+    {
+    }
+
+    void FrameGovernor::recordUpdate(float ms, bool capped)
+    {
+        m_updateMs += (ms - m_updateMs) * SMOOTHING;
+        m_capped = capped;
+        if (capped)
+            ++m_cappedFrames;
+    }
+
+    void FrameGovernor::recordRender(float ms)
+    {
+        m_renderMs += (ms - m_renderMs) * SMOOTHING;
+    }
+
+    bool FrameGovernor::beginRender()
+    {
+        ++m_framesInTier[static_cast<int>(m_tier)];
+        if (m_frame++ % renderEvery() != 0)
+        {
+            ++m_skippedFrames;
+            return false;
+        }
+        return true;
+    }
+
+    float FrameGovernor::particleScale() const
+    {
+        switch (m_tier)
+        {
+            case QualityTier::Full:           return 1.0f;
+            case QualityTier::ReducedEffects: return 0.5f;
+            default:                          return 0.25f;
+        }
+    }
+
+    int FrameGovernor::effectsStride() const
+    {
+        return m_tier >= QualityTier::HalfRateEffects ? 2 : 1;
+    }
+
+    void FrameGovernor::endFrame()
+    {
+        ++m_sinceChange;
+
+        // skipped frames don't render, so the render cost is spread out
+        const float loadMs = m_updateMs + m_renderMs / renderEvery();
+        const float load = loadMs / m_config.budgetMs;
+
+        if (load < m_config.recoverAt && !m_capped)
+            ++m_headroomFrames;
+        else
+            m_headroomFrames = 0;
+
+        if (m_sinceChange < m_config.holdFrames)
+            return;
+
+        const int tier = static_cast<int>(m_tier);
+        const int lowest = static_cast<int>(QualityTier::Count) - 1;
+
+        if ((load > m_config.degradeAt || m_capped) && tier < lowest)
+        {
+            setTier(static_cast<QualityTier>(tier + 1), m_capped ? "catch-up capped" : "over budget");
+        }
+        else if (m_headroomFrames >= m_config.recoverFrames && tier > 0)
+        {
+            setTier(static_cast<QualityTier>(tier - 1), "headroom");
+        }
+    }
+
+    void FrameGovernor::setTier(QualityTier tier, const char* reason)
+    {
+        const float loadMs = m_updateMs + m_renderMs / renderEvery();
+        ZLOG_INFO("Governor: %s -> %s (%s: update %.2f ms, render %.2f ms, %.0f%% of %.1f ms)",
+                  qualityTierName(m_tier), qualityTierName(tier), reason,
+                  m_updateMs, m_renderMs, loadMs * 100.0f / m_config.budgetMs, m_config.budgetMs);
+
+        m_tier = tier;
+        m_sinceChange = 0;
+        m_headroomFrames = 0;
+        ++m_decisions;
+    }
+
+    void FrameGovernor::logSummary() const
+    {
+        std::uint64_t total = 0;
+        for (std::uint64_t n : m_framesInTier)
+            total += n;
+        if (total == 0)
+            return;
+
+        ZLOG_INFO("Governor: %llu decisions, %llu frames skipped, %llu capped catch-ups (%.2f s dropped)",
+                  static_cast<unsigned long long>(m_decisions),
+                  static_cast<unsigned long long>(m_skippedFrames),
+                  static_cast<unsigned long long>(m_cappedFrames),
+                  m_droppedSec);
+        for (int t = 0; t < static_cast<int>(QualityTier::Count); ++t)
+        {
+            ZLOG_INFO("  %-18s %5.1f%% of frames", qualityTierName(static_cast<QualityTier>(t)),
+                      m_framesInTier[t] * 100.0 / total);
+        }
+    }
+}
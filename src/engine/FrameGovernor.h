@@ -0,0 +1,102 @@
+#pragma once
+#include <array>
+#include <cstdint>
+
+namespace zelda::engine
+{
+    // Cheapest last: each tier keeps everything the one above it cut.
+    enum class QualityTier : int
+    {
+        Full = 0,
+        ReducedEffects,  // half the particles per burst
+        HalfRateEffects, // quarter particles, effects simulated every 2nd tick
+        SkipFrames,      // ... and only every 2nd frame is drawn
+        Count
+    };
+
+    const char* qualityTierName(QualityTier tier);
+
+    struct FrameGovernorConfig
+    {
+        float budgetMs = 1000.0f / 60.0f;
+
+        // fraction of the budget the smoothed frame cost may use
+        float degradeAt = 0.85f; // above: step one tier down
+        float recoverAt = 0.50f; // below for recoverFrames in a row: step one tier up
+
+        int holdFrames    = 20;  // min frames between two decisions (let the EMA settle)
+        int recoverFrames = 120; // ~2 s of headroom before we try more work again
+
+        // fixed steps run per frame before the rest of the backlog is dropped
+        int maxCatchUpSteps = 4;
+    };
+
+    // Watches what simulation and rendering actually cost each frame and
+    // trades visual work for frame time before the loop falls behind.
+    //
+    // Engine feeds it measured update / render times (present and the
+    // frame cap sleep excluded, so vsync doesn't count as load) and asks
+    // it how much to do: particles per burst, how often effects are
+    // simulated, whether this frame is drawn at all, and how many catch-up
+    // steps one frame may run. Decisions move one tier at a time with
+    // hysteresis and every one is logged with the numbers behind it.
+    //
+    // Only presentation work is ever scaled, World::step() itself is never
+    // thinned out. The one thing that touches the simulation is the
+    // catch-up cap: a stall longer than maxCatchUpSteps ticks is dropped
+    // (the game pauses for it) instead of being replayed in one burst.
+    class FrameGovernor
+    {
+    public:
+        explicit FrameGovernor(const FrameGovernorConfig& config = FrameGovernorConfig{});
+
+        // capped = the catch-up backlog was cut off this frame
+        void recordUpdate(float ms, bool capped);
+        void recordRender(float ms);
+
+        // Decide the tier for the next frame.
+        void endFrame();
+
+        // Advance the frame counter; false = skip drawing this frame.
+        bool beginRender();
+
+        QualityTier tier() const { return m_tier; }
+        float particleScale() const;
+        int effectsStride() const;
+        int maxCatchUpSteps() const { return m_config.maxCatchUpSteps; }
+
+        // smoothed costs the decisions are based on (ms per frame)
+        float updateMs() const { return m_updateMs; }
+        float renderMs() const { return m_renderMs; }
+
+        // seconds of simulation thrown away instead of bursting
+        void noteDroppedTime(float sec) { m_droppedSec += sec; }
+
+        std::uint64_t decisions() const     { return m_decisions; }
+        std::uint64_t skippedFrames() const { return m_skippedFrames; }
+
+        void logSummary() const;
+
+    private:
+        int renderEvery() const { return m_tier == QualityTier::SkipFrames ? 2 : 1; }
+        void setTier(QualityTier tier, const char* reason);
+
+        FrameGovernorConfig m_config;
+        QualityTier m_tier = QualityTier::Full;
+
+        // smoothed per-frame costs (ms)
+        float m_updateMs = 0.0f;
+        float m_renderMs = 0.0f;
+        bool  m_capped   = false;
+
+        int m_sinceChange = 0;
+        int m_headroomFrames = 0;
+
+        std::uint64_t m_frame = 0;
+        std::uint64_t m_decisions = 0;
+        std::uint64_t m_skippedFrames = 0;
+        std::uint64_t m_cappedFrames = 0;
+        float m_droppedSec = 0.0f;
+        std::array<std::uint64_t, static_cast<int>(QualityTier::Count)> m_framesInTier{};
+    };
+}
@@ -0,0 +1,77 @@
+#include "Hud.h"
+#include "BitmapFont.h"
+
+#include <algorithm>
+#include <climits>
+
+namespace zelda::game
+{
+    Hud::Hud()
+        : m_foes(16), m_foeHp(16),
+          m_fps(16), m_updateMs(16), m_renderMs(16), m_draws(16), m_thinks(24), m_tier(24), m_idle(16), m_saved(24)
+    {
+    }
+
+    void Hud::update(const World& world)
+    {
+        int alive = 0, hp = 0;
+        for (const Enemy& e : world.enemies())
+        {
+            if (e.hp <= 0)
+                continue;
+            ++alive;
+            hp += e.hp;
+        }
+        m_foes.setNumber("FOES ", alive);
+        m_foeHp.setNumber("HP ", hp);
+    }
+
+    void Hud::updateDebug(const HudDebugInfo& info)
+    {
+        m_fps.setNumber("FPS ", info.fps);
+        m_updateMs.setTenths("UPD ", info.updateMs, " MS");
+        m_renderMs.setTenths("REN ", info.renderMs, " MS");
+        m_draws.setNumber("DRAWS ", static_cast<int>(info.draws));
+        m_thinks.setNumber("THINKS ", static_cast<int>(info.thinks));
+        m_tier.set(info.tier);
+        m_idle.setNumber("IDLE ", info.idlePercent, "%");
+        m_saved.setNumber("SAVED ", static_cast<int>(std::min<std::uint64_t>(info.rendersSaved, INT_MAX)));
+    }
+
+    void Hud::record(RenderQueue& queue, TextRenderer& text, int viewW) const
+    {
+        const SDL_Color white{255, 255, 255, 255};
+        const SDL_Color red{255, 120, 120, 255};
+
+        text.begin();
+
+        const float left = static_cast<float>(MARGIN);
+        text.drawShadowed(m_foes, left, MARGIN, white);
+        text.drawShadowed(m_foeHp, left, MARGIN + font::LINE_HEIGHT, red);
+
+        if (m_debugVisible)
+        {
+            // right aligned, one line each
+            const SDL_Color yellow{255, 230, 120, 255};
+            const TextLabel* lines[] = {&m_fps, &m_updateMs, &m_renderMs, &m_draws, &m_thinks, &m_tier,
+                                        &m_idle, &m_saved};
+            float y = MARGIN;
+            for (const TextLabel* line : lines)
+            {
+                text.drawShadowed(*line, static_cast<float>(viewW - MARGIN - line->width()), y, yellow);
+                y += font::LINE_HEIGHT;
+            }
+        }
+
+        text.submit(queue, DrawLayer::Hud);
+    }
+
+    std::uint64_t Hud::layoutCount() const
+    {
+        std::uint64_t n = 0;
+        for (const TextLabel* l : {&m_foes, &m_foeHp, &m_fps, &m_updateMs, &m_renderMs,
+                                   &m_draws, &m_thinks, &m_tier, &m_idle, &m_saved})
+            n += l->layoutCount();
+        return n;
+    }
+}
@@ -0,0 +1,62 @@
+#pragma once
+#include <cstdint>
+
+#include "World.h"
+#include "RenderQueue.h"
+#include "TextRenderer.h"
+
+namespace zelda::game
+{
+    // Numbers for the debug overlay, filled in by whoever owns the loop.
+    struct HudDebugInfo
+    {
+        int fps = 0;
+        float updateMs = 0.0f; // smoothed per frame
+        float renderMs = 0.0f;
+        std::uint32_t draws = 0; // last frame
+        std::uint64_t thinks = 0; // AI, last tick
+        const char* tier = "";    // quality tier name
+        int idlePercent = 0;      // frames with nothing to redraw, last second
+        std::uint64_t rendersSaved = 0;
+    };
+
+    // Heads-up display: enemy count / HP of the current room, plus an
+    // optional debug overlay (FPS, frame costs, draw calls, idle ratio, ...).
+    //
+    // Values are pushed every frame but every line is a TextLabel, so
+    // only lines whose number changed get laid out again, and the whole
+    // HUD is one geometry command on DrawLayer::Hud.
+    class Hud
+    {
+    public:
+        Hud();
+
+        void update(const World& world);
+        void updateDebug(const HudDebugInfo& info);
+
+        void setDebugVisible(bool visible) { m_debugVisible = visible; }
+        bool debugVisible() const          { return m_debugVisible; }
+
+        // viewW: width of the screen being drawn to (logical pixels)
+        void record(RenderQueue& queue, TextRenderer& text, int viewW) const;
+
+        // total re-layouts over every line (stats)
+        std::uint64_t layoutCount() const;
+
+    private:
+        static constexpr int MARGIN = 4;
+
+        TextLabel m_foes;
+        TextLabel m_foeHp;
+
+        bool m_debugVisible = false;
+        TextLabel m_fps;
+        TextLabel m_updateMs;
+        TextLabel m_renderMs;
+        TextLabel m_draws;
+        TextLabel m_thinks;
+        TextLabel m_tier;
+        TextLabel m_idle;
+        TextLabel m_saved;
+    };
+}
@@ -0,0 +1,392 @@
+#include "Log.h"
+#include "MpscRing.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace zelda::game
+{
+    namespace
+    {
+        using detail::LogRecord;
+        using Clock = std::chrono::steady_clock;
+
+        constexpr std::size_t RING_RECORDS = 4096; // ~800 KB, static storage
+        constexpr std::size_t LINE_BYTES = 1024;
+        constexpr auto IDLE_WAIT = std::chrono::milliseconds(5);
+
+        const char* levelName(LogLevel level)
+        {
+            switch (level)
+            {
+                case LogLevel::Trace: return "TRACE";
+                case LogLevel::Debug: return "DEBUG";
+                case LogLevel::Info:  return "INFO";
+                case LogLevel::Warn:  return "WARN";
+                case LogLevel::Error: return "ERROR";
+            }
+            return "?";
+        }
+
+        bool isOneOf(char c, const char* set)
+        {
+            for (; *set; ++set)
+                if (*set == c)
+                    return true;
+            return false;
+        }
+
+        // printf the record's format with its captured arguments. Length
+        // modifiers in the format are ignored: what counts is the type
+        // that was captured (every integer was widened to long long).
+        std::size_t formatRecord(const LogRecord& r, char* out, std::size_t cap)
+        {
+            std::size_t len = 0;
+            int arg = 0;
+            auto append = [&](int n)
+            {
+                if (n > 0)
+                    len += std::min<std::size_t>(static_cast<std::size_t>(n), cap - 1 - len);
+            };
+
+            const char* f = r.format;
+            while (*f && len + 1 < cap)
+            {
+                if (*f != '%')
+                {
+                    out[len++] = *f++;
+                    continue;
+                }
+                if (f[1] == '%')
+                {
+                    out[len++] = '%';
+                    f += 2;
+                    continue;
+                }
+
+                // % [flags] [width] [.precision] [length] conversion
+                const char* start = f++;
+                while (*f && isOneOf(*f, "-+ #0"))
+                    ++f;
+                while (*f && (isOneOf(*f, "0123456789.")))
+                    ++f;
+                const char* lengthStart = f;
+                while (*f && isOneOf(*f, "hlLqjzt"))
+                    ++f;
+                const char conv = *f;
+                if (!conv)
+                    break;
+                ++f;
+
+                char spec[32];
+                std::size_t specLen = std::min<std::size_t>(static_cast<std::size_t>(lengthStart - start), 24);
+                std::memcpy(spec, start, specLen);
+
+                if (arg >= r.argCount)
+                {
+                    append(std::snprintf(out + len, cap - len, "?"));
+                    continue;
+                }
+                const LogRecord::Value& v = r.values[arg];
+                const LogRecord::Arg kind = r.kinds[arg];
+                ++arg;
+
+                const bool integerConv = isOneOf(conv, "diouxX");
+                const bool floatConv = isOneOf(conv, "fFeEgGaA");
+                auto finish = [&](const char* tail)
+                {
+                    std::size_t i = 0;
+                    while (tail[i] && specLen < sizeof(spec) - 1)
+                        spec[specLen++] = tail[i++];
+                    spec[specLen] = '\0';
+                };
+                const char convStr[2] = {conv, '\0'};
+
+                switch (kind)
+                {
+                    case LogRecord::Arg::Int:
+                    case LogRecord::Arg::UInt:
+                    {
+                        const long long i = kind == LogRecord::Arg::Int ? v.i : static_cast<long long>(v.u);
+                        if (conv == 'c')
+                        {
+                            finish("c");
+                            append(std::snprintf(out + len, cap - len, spec, static_cast<int>(i)));
+                        }
+                        else if (floatConv)
+                        {
+                            finish(convStr);
+                            append(std::snprintf(out + len, cap - len, spec, static_cast<double>(i)));
+                        }
+                        else if (kind == LogRecord::Arg::UInt && isOneOf(conv, "ouxX"))
+                        {
+                            finish("ll");
+                            finish(convStr);
+                            append(std::snprintf(out + len, cap - len, spec, v.u));
+                        }
+                        else
+                        {
+                            finish("ll");
+                            finish(integerConv ? convStr : (kind == LogRecord::Arg::Int ? "d" : "u"));
+                            if (kind == LogRecord::Arg::Int || isOneOf(conv, "di"))
+                                append(std::snprintf(out + len, cap - len, spec, i));
+                            else
+                                append(std::snprintf(out + len, cap - len, spec, v.u));
+                        }
+                        break;
+                    }
+                    case LogRecord::Arg::Double:
+                        finish(floatConv ? convStr : "g");
+                        append(std::snprintf(out + len, cap - len, spec, v.d));
+                        break;
+                    case LogRecord::Arg::Pointer:
+                        finish("p");
+                        append(std::snprintf(out + len, cap - len, spec, v.p));
+                        break;
+                    case LogRecord::Arg::String:
+                        finish("s");
+                        append(std::snprintf(out + len, cap - len, spec, r.strings + v.offset));
+                        break;
+                }
+            }
+            out[len] = '\0';
+            return len;
+        }
+
+        struct Sink
+        {
+            MpscRing<LogRecord, RING_RECORDS> ring;
+            std::atomic<bool> running{false};
+            std::atomic<std::uint64_t> pushed{0};
+            std::atomic<std::uint64_t> consumed{0};
+            std::atomic<std::uint64_t> written{0};
+            std::atomic<std::uint64_t> dropped{0};
+            const Clock::time_point epoch = Clock::now();
+
+            // writer side
+            std::thread thread;
+            std::mutex mutex;
+            std::condition_variable wake;
+            bool stopRequested = false;
+
+            LogConfig config;
+            std::string path;
+            std::FILE* file = nullptr;
+            std::size_t fileBytes = 0;
+            std::uint64_t reportedDrops = 0;
+
+            // logStop() wasn't called: at least don't terminate on a joinable thread
+            ~Sink()
+            {
+                if (thread.joinable())
+                {
+                    {
+                        std::lock_guard<std::mutex> lock(mutex);
+                        stopRequested = true;
+                    }
+                    wake.notify_one();
+                    thread.join();
+                }
+            }
+        };
+
+        Sink& sink()
+        {
+            static Sink s;
+            return s;
+        }
+
+        std::FILE* output(Sink& s)
+        {
+            return s.file ? s.file : stderr;
+        }
+
+        // path -> path.1 -> ... -> path.keepFiles (the oldest falls off)
+        void rotateFiles(Sink& s)
+        {
+            if (s.file)
+            {
+                std::fclose(s.file);
+                s.file = nullptr;
+            }
+            if (s.config.keepFiles <= 0)
+            {
+                std::remove(s.path.c_str());
+            }
+            else
+            {
+                const std::string oldest = s.path + "." + std::to_string(s.config.keepFiles);
+                std::remove(oldest.c_str());
+                for (int k = s.config.keepFiles - 1; k >= 1; --k)
+                {
+                    const std::string from = s.path + "." + std::to_string(k);
+                    const std::string to = s.path + "." + std::to_string(k + 1);
+                    std::rename(from.c_str(), to.c_str());
+                }
+                std::rename(s.path.c_str(), (s.path + ".1").c_str());
+            }
+
+            s.file = std::fopen(s.path.c_str(), "w");
+            s.fileBytes = 0;
+            if (!s.file)
+                std::fprintf(stderr, "log: can't open %s, writing to stderr\n", s.path.c_str());
+        }
+
+        void writeLine(Sink& s, const char* line, std::size_t len)
+        {
+            std::fwrite(line, 1, len, output(s));
+            if (s.file)
+            {
+                s.fileBytes += len;
+                if (s.fileBytes >= s.config.rotateBytes)
+                    rotateFiles(s);
+            }
+        }
+
+        std::size_t formatLine(const LogRecord& r, char* line)
+        {
+            int head = std::snprintf(line, LINE_BYTES, "%10.3f %-5s ", r.timeUs / 1000000.0, levelName(r.level));
+            if (head < 0)
+                head = 0;
+            std::size_t len = static_cast<std::size_t>(head);
+            len += formatRecord(r, line + len, LINE_BYTES - 1 - len);
+            line[len++] = '\n';
+            return len;
+        }
+
+        // everything queued right now; true if there was anything
+        bool drain(Sink& s)
+        {
+            char line[LINE_BYTES];
+            LogRecord r;
+            std::uint64_t n = 0;
+            while (s.ring.pop(r))
+            {
+                writeLine(s, line, formatLine(r, line));
+                ++n;
+            }
+
+            const std::uint64_t dropped = s.dropped.load(std::memory_order_relaxed);
+            if (dropped != s.reportedDrops)
+            {
+                const int len = std::snprintf(line, LINE_BYTES, "log: %llu record(s) dropped, ring full\n",
+                                              static_cast<unsigned long long>(dropped - s.reportedDrops));
+                writeLine(s, line, static_cast<std::size_t>(len));
+                s.reportedDrops = dropped;
+            }
+
+            if (n == 0)
+                return false;
+            std::fflush(output(s));
+            s.written.fetch_add(n, std::memory_order_relaxed);
+            s.consumed.fetch_add(n, std::memory_order_release);
+            return true;
+        }
+
+        void writerLoop(Sink& s)
+        {
+            for (;;)
+            {
+                if (drain(s))
+                    continue;
+
+                // producers never signal (that could block them): poll a few
+                // times a frame while idle, stop / flush wake us early
+                std::unique_lock<std::mutex> lock(s.mutex);
+                if (s.stopRequested)
+                    break;
+                s.wake.wait_for(lock, IDLE_WAIT);
+            }
+        }
+    }
+
+    void logStart(const LogConfig& config)
+    {
+        Sink& s = sink();
+        if (s.running.load())
+            return;
+
+        s.config = config;
+        s.stopRequested = false;
+        if (config.path)
+        {
+            s.path = config.path;
+            rotateFiles(s); // keep the previous run as path.1
+        }
+        s.thread = std::thread(writerLoop, std::ref(s));
+        s.running.store(true, std::memory_order_release);
+    }
+
+    void logStop()
+    {
+        Sink& s = sink();
+        if (!s.running.exchange(false))
+            return;
+
+        {
+            std::lock_guard<std::mutex> lock(s.mutex);
+            s.stopRequested = true;
+        }
+        s.wake.notify_one();
+        s.thread.join();
+
+        // writer is gone: this thread is the only consumer now
+        drain(s);
+        if (s.file)
+        {
+            std::fclose(s.file);
+            s.file = nullptr;
+        }
+    }
+
+    void logFlush()
+    {
+        Sink& s = sink();
+        const std::uint64_t target = s.pushed.load(std::memory_order_acquire);
+        while (s.running.load() && s.consumed.load(std::memory_order_acquire) < target)
+        {
+            s.wake.notify_one();
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+
+    LogStats logStats()
+    {
+        const Sink& s = sink();
+        LogStats out;
+        out.written = s.written.load(std::memory_order_relaxed);
+        out.dropped = s.dropped.load(std::memory_order_relaxed);
+        return out;
+    }
+
+    namespace detail
+    {
+        void logSubmit(LogRecord& record)
+        {
+            Sink& s = sink();
+            record.timeUs = static_cast<std::uint64_t>(
+                std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - s.epoch).count());
+
+            if (s.running.load(std::memory_order_acquire))
+            {
+                if (s.ring.push(record))
+                    s.pushed.fetch_add(1, std::memory_order_relaxed);
+                else
+                    s.dropped.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+
+            // no writer thread: format and write here and now
+            char line[LINE_BYTES];
+            const std::size_t len = formatLine(record, line);
+            std::fwrite(line, 1, len, stderr);
+            s.written.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+}
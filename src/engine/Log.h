@@ -0,0 +1,193 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+// Compile-time floor: calls below it compile to nothing (arguments are
+// not evaluated). 0 = trace, 1 = debug, 2 = info, 3 = warn, 4 = error, 5 = off.
+#ifndef ZELDA_LOG_LEVEL
+#  ifdef NDEBUG
+#    define ZELDA_LOG_LEVEL 2
+#  else
+#    define ZELDA_LOG_LEVEL 0
+#  endif
+#endif
+
+namespace zelda::game
+{
+    enum class LogLevel
+    {
+        Trace = 0,
+        Debug,
+        Info,
+        Warn,
+        Error
+    };
+
+    struct LogConfig
+    {
+        // nullptr = stderr, else a file that rotates to path.1 .. path.keepFiles
+        const char* path = nullptr;
+        std::size_t rotateBytes = 1024 * 1024;
+        int keepFiles = 3;
+    };
+
+    struct LogStats
+    {
+        std::uint64_t written = 0;
+        std::uint64_t dropped = 0; // ring was full
+    };
+
+    // Asynchronous log.
+    //
+    // A log call only copies the format string pointer and its arguments
+    // (numbers as they are, strings into the record) into a lock-free
+    // ring and returns; formatting and writing happen on a background
+    // thread. Callers never block and never allocate. When the ring is
+    // full the record is dropped and counted; the writer reports drops.
+    //
+    // The format must be a string literal (printf style, the pointer is
+    // kept). Strings are cut at LogRecord::STRING_BYTES in total.
+    //
+    // Before logStart() / after logStop() calls are formatted and
+    // written right away on the calling thread, so tools that never
+    // start the writer still print. Stop other logging threads before
+    // logStop(): a record racing with it can be lost.
+    void logStart(const LogConfig& config = LogConfig{});
+    void logStop(); // drains everything queued, then joins the writer
+
+    // Block until everything queued so far is written.
+    void logFlush();
+
+    LogStats logStats();
+
+    // Compiled in at all? (ZELDA_LOG_LEVEL)
+    constexpr bool logLevelEnabled(LogLevel level)
+    {
+        return static_cast<int>(level) >= ZELDA_LOG_LEVEL;
+    }
+
+    namespace detail
+    {
+        struct LogRecord
+        {
+            static constexpr int MAX_ARGS = 8;
+            static constexpr std::size_t STRING_BYTES = 112;
+
+            enum class Arg : std::uint8_t { Int = 0, UInt, Double, Pointer, String };
+
+            std::uint64_t timeUs;
+            const char* format;
+            LogLevel level;
+            std::uint8_t argCount;
+            std::uint8_t stringBytes;
+            Arg kinds[MAX_ARGS];
+            union Value
+            {
+                long long i;
+                unsigned long long u;
+                double d;
+                const void* p;
+                std::size_t offset; // String: into strings[]
+            } values[MAX_ARGS];
+            char strings[STRING_BYTES];
+        };
+
+        inline void addString(LogRecord& r, std::string_view s)
+        {
+            // NUL terminated, back to back; out of room = cut short. The
+            // last byte is always '\0': strings that don't fit at all point there.
+            constexpr std::size_t LIMIT = LogRecord::STRING_BYTES - 1;
+            const std::size_t used = r.stringBytes;
+            r.kinds[r.argCount] = LogRecord::Arg::String;
+            if (used >= LIMIT)
+            {
+                r.values[r.argCount++].offset = LIMIT;
+                return;
+            }
+
+            const std::size_t n = s.size() < LIMIT - used - 1 ? s.size() : LIMIT - used - 1;
+            std::memcpy(r.strings + used, s.data(), n);
+            r.strings[used + n] = '\0';
+            r.stringBytes = static_cast<std::uint8_t>(used + n + 1);
+            r.values[r.argCount++].offset = used;
+        }
+
+        template <typename T>
+        void addArg(LogRecord& r, const T& v)
+        {
+            if (r.argCount >= LogRecord::MAX_ARGS)
+                return;
+
+            using U = std::decay_t<T>;
+            if constexpr (std::is_same_v<U, const char*> || std::is_same_v<U, char*>)
+            {
+                addString(r, v ? std::string_view(v) : std::string_view("(null)"));
+            }
+            else if constexpr (std::is_same_v<U, std::string> || std::is_same_v<U, std::string_view>)
+            {
+                addString(r, v);
+            }
+            else if constexpr (std::is_floating_point_v<U>)
+            {
+                r.kinds[r.argCount] = LogRecord::Arg::Double;
+                r.values[r.argCount++].d = static_cast<double>(v);
+            }
+            else if constexpr (std::is_enum_v<U>)
+            {
+                r.kinds[r.argCount] = LogRecord::Arg::Int;
+                r.values[r.argCount++].i = static_cast<long long>(v);
+            }
+            else if constexpr (std::is_integral_v<U> && std::is_signed_v<U>)
+            {
+                r.kinds[r.argCount] = LogRecord::Arg::Int;
+                r.values[r.argCount++].i = v;
+            }
+            else if constexpr (std::is_integral_v<U>)
+            {
+                r.kinds[r.argCount] = LogRecord::Arg::UInt;
+                r.values[r.argCount++].u = v;
+            }
+            else if constexpr (std::is_pointer_v<U>)
+            {
+                r.kinds[r.argCount] = LogRecord::Arg::Pointer;
+                r.values[r.argCount++].p = static_cast<const void*>(v);
+            }
+            else
+            {
+                static_assert(std::is_pointer_v<U>, "unsupported log argument type");
+            }
+        }
+
+        void logSubmit(LogRecord& record);
+
+        template <typename... Args>
+        void logWrite(LogLevel level, const char* format, const Args&... args)
+        {
+            LogRecord r;
+            r.level = level;
+            r.format = format;
+            r.argCount = 0;
+            r.stringBytes = 0;
+            r.strings[LogRecord::STRING_BYTES - 1] = '\0';
+            (addArg(r, args), ...);
+            logSubmit(r);
+        }
+    }
+}
+
+#define ZELDA_LOG_AT(level, ...)                                                      \
+    do                                                                                \
+    {                                                                                 \
+        if constexpr (::zelda::game::logLevelEnabled(level))                          \
+            ::zelda::game::detail::logWrite(level, __VA_ARGS__);                      \
+    } while (0)
+
+#define ZLOG_TRACE(...) ZELDA_LOG_AT(::zelda::game::LogLevel::Trace, __VA_ARGS__)
+#define ZLOG_DEBUG(...) ZELDA_LOG_AT(::zelda::game::LogLevel::Debug, __VA_ARGS__)
+#define ZLOG_INFO(...)  ZELDA_LOG_AT(::zelda::game::LogLevel::Info, __VA_ARGS__)
+#define ZLOG_WARN(...)  ZELDA_LOG_AT(::zelda::game::LogLevel::Warn, __VA_ARGS__)
+#define ZLOG_ERROR(...) ZELDA_LOG_AT(::zelda::game::LogLevel::Error, __VA_ARGS__)
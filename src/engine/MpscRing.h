@@ -0,0 +1,92 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace zelda::game
+{
+    // Fixed-size multi-producer / single-consumer queue.
+    //
+    // Any number of threads push(), one thread pop()s. Every slot carries
+    // a sequence number saying whose turn it is, so producers only race on
+    // claiming a slot (one CAS) and never wait for each other to finish
+    // copying. No locks, no allocation. Capacity must be a power of two;
+    // push() returns false when full (the caller counts the drop).
+    template <typename T, std::size_t Capacity>
+    class MpscRing
+    {
+        static_assert((Capacity & (Capacity - 1)) == 0, "capacity must be a power of two");
+        static_assert(std::is_trivially_copyable<T>::value, "ring items are copied around as bytes");
+
+    public:
+        MpscRing()
+        {
+            for (std::size_t i = 0; i < Capacity; ++i)
+                m_cells[i].seq.store(i, std::memory_order_relaxed);
+        }
+
+        MpscRing(const MpscRing&) = delete;
+        MpscRing& operator=(const MpscRing&) = delete;
+
+        bool push(const T& item)
+        {
+            std::size_t pos = m_head.load(std::memory_order_relaxed);
+            Cell* cell;
+            for (;;)
+            {
+                cell = &m_cells[pos & MASK];
+                const std::size_t seq = cell->seq.load(std::memory_order_acquire);
+                const std::intptr_t diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos);
+                if (diff == 0)
+                {
+                    // our turn for this slot, if nobody claimed it first
+                    if (m_head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                        break;
+                }
+                else if (diff < 0)
+                {
+                    return false; // full: the consumer hasn't freed this slot yet
+                }
+                else
+                {
+                    pos = m_head.load(std::memory_order_relaxed); // someone else got it
+                }
+            }
+
+            cell->item = item;
+            cell->seq.store(pos + 1, std::memory_order_release);
+            return true;
+        }
+
+        bool pop(T& out)
+        {
+            const std::size_t pos = m_tail.load(std::memory_order_relaxed);
+            Cell& cell = m_cells[pos & MASK];
+            if (cell.seq.load(std::memory_order_acquire) != pos + 1)
+                return false; // empty (or the producer is still copying)
+
+            out = cell.item;
+            cell.seq.store(pos + Capacity, std::memory_order_release); // free for the next lap
+            m_tail.store(pos + 1, std::memory_order_relaxed);
+            return true;
+        }
+
+        static constexpr std::size_t capacity() { return Capacity; }
+
+    private:
+        static constexpr std::size_t MASK = Capacity - 1;
+
+        struct Cell
+        {
+            std::atomic<std::size_t> seq;
+            T item;
+        };
+
+        // producer and consumer indices on separate cache lines
+        alignas(64) std::atomic<std::size_t> m_head{0};
+        alignas(64) std::atomic<std::size_t> m_tail{0};
+        alignas(64) std::array<Cell, Capacity> m_cells;
+    };
+}
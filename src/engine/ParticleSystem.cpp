@@ -0,0 +1,242 @@
+#include "ParticleSystem.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__AVX__)
+    #include <immintrin.h>
+    #define ZELDA_PARTICLES_AVX 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define ZELDA_PARTICLES_SSE2 1
+#endif
+
+namespace zelda::game
+{
+    namespace
+    {
+        std::uint32_t xorshift32(std::uint32_t& state)
+        {
+            state ^= state << 13;
+            state ^= state >> 17;
+            state ^= state << 5;
+            return state;
+        }
+
+        float random01(std::uint32_t& state)
+        {
+            return static_cast<float>(xorshift32(state) >> 8) * (1.0f / 16777216.0f);
+        }
+
+        // Scalar reference kernel. Also handles whatever the SIMD loops leave over.
+        void updateScalar(float* x, float* y, const float* vx, float* vy,
+                          float* life, const float* invLife, float* alpha,
+                          std::size_t begin, std::size_t end,
+                          float dt, float gravity)
+        {
+            const float gdt = gravity * dt;
+            for (std::size_t i = begin; i < end; ++i)
+            {
+                vy[i] += gdt;
+                x[i] += vx[i] * dt;
+                y[i] += vy[i] * dt;
+                life[i] -= dt;
+
+                float a = life[i] * invLife[i];
+                alpha[i] = a < 0.0f ? 0.0f : (a > 1.0f ? 1.0f : a);
+            }
+        }
+    }
+
+    ParticleSystem::ParticleSystem(std::size_t capacity)
+    : m_capacity(capacity)
+    {
+        m_x.assign(capacity, 0.0f);
+        m_y.assign(capacity, 0.0f);
+        m_vx.assign(capacity, 0.0f);
+        m_vy.assign(capacity, 0.0f);
+        m_life.assign(capacity, 0.0f);
+        m_invLife.assign(capacity, 0.0f);
+        m_alpha.assign(capacity, 0.0f);
+        m_color.assign(capacity, SDL_Color{255, 255, 255, 255});
+
+        m_vertices.resize(capacity * 4);
+        m_indices.resize(capacity * 6);
+
+        // index pattern never changes, build it once
+        for (std::size_t i = 0; i < capacity; ++i)
+        {
+            int v = static_cast<int>(i * 4);
+            int* idx = &m_indices[i * 6];
+            idx[0] = v + 0;
+            idx[1] = v + 1;
+            idx[2] = v + 2;
+            idx[3] = v + 2;
+            idx[4] = v + 3;
+            idx[5] = v + 0;
+        }
+    }
+
+    const char* ParticleSystem::kernelName()
+    {
+#if defined(ZELDA_PARTICLES_AVX)
+        return "AVX";
+#elif defined(ZELDA_PARTICLES_SSE2)
+        return "SSE2";
+#else
+        return "scalar";
+#endif
+    }
+
+    void ParticleSystem::emitBurst(float x, float y, int count, SDL_Color color, float speed, float lifetime)
+    {
+        if (lifetime <= 0.0f)
+            return;
+
+        const float invLife = 1.0f / lifetime;
+        for (int n = 0; n < count && m_count < m_capacity; ++n)
+        {
+            const std::size_t i = m_count++;
+
+            float angle = random01(m_rng) * 6.2831853f;
+            float mag   = speed * (0.25f + 0.75f * random01(m_rng));
+
+            m_x[i]  = x;
+            m_y[i]  = y;
+            m_vx[i] = std::cos(angle) * mag;
+            m_vy[i] = std::sin(angle) * mag - speed * 0.5f; // little upward kick
+            // jitter lifetime so a burst doesn't vanish in one frame
+            m_life[i]    = lifetime * (0.6f + 0.4f * random01(m_rng));
+            m_invLife[i] = invLife;
+            m_alpha[i]   = 1.0f;
+            m_color[i]   = color;
+        }
+    }
+
+    void ParticleSystem::update(float dtSec)
+    {
+        if (m_count == 0)
+            return;
+
+        float* x       = m_x.data();
+        float* y       = m_y.data();
+        float* vx      = m_vx.data();
+        float* vy      = m_vy.data();
+        float* life    = m_life.data();
+        float* invLife = m_invLife.data();
+        float* alpha   = m_alpha.data();
+
+        std::size_t i = 0;
+
+#if defined(ZELDA_PARTICLES_AVX)
+        {
+            const __m256 dt   = _mm256_set1_ps(dtSec);
+            const __m256 gdt  = _mm256_set1_ps(gravity * dtSec);
+            const __m256 zero = _mm256_setzero_ps();
+            const __m256 one  = _mm256_set1_ps(1.0f);
+
+            for (; i + 8 <= m_count; i += 8)
+            {
+                __m256 pvy = _mm256_add_ps(_mm256_loadu_ps(vy + i), gdt);
+                __m256 px  = _mm256_add_ps(_mm256_loadu_ps(x + i), _mm256_mul_ps(_mm256_loadu_ps(vx + i), dt));
+                __m256 py  = _mm256_add_ps(_mm256_loadu_ps(y + i), _mm256_mul_ps(pvy, dt));
+                __m256 pl  = _mm256_sub_ps(_mm256_loadu_ps(life + i), dt);
+                __m256 pa  = _mm256_mul_ps(pl, _mm256_loadu_ps(invLife + i));
+                pa = _mm256_min_ps(_mm256_max_ps(pa, zero), one);
+
+                _mm256_storeu_ps(vy + i, pvy);
+                _mm256_storeu_ps(x + i, px);
+                _mm256_storeu_ps(y + i, py);
+                _mm256_storeu_ps(life + i, pl);
+                _mm256_storeu_ps(alpha + i, pa);
+            }
+        }
+#elif defined(ZELDA_PARTICLES_SSE2)
+        {
+            const __m128 dt   = _mm_set1_ps(dtSec);
+            const __m128 gdt  = _mm_set1_ps(gravity * dtSec);
+            const __m128 zero = _mm_setzero_ps();
+            const __m128 one  = _mm_set1_ps(1.0f);
+
+            for (; i + 4 <= m_count; i += 4)
+            {
+                __m128 pvy = _mm_add_ps(_mm_loadu_ps(vy + i), gdt);
+                __m128 px  = _mm_add_ps(_mm_loadu_ps(x + i), _mm_mul_ps(_mm_loadu_ps(vx + i), dt));
+                __m128 py  = _mm_add_ps(_mm_loadu_ps(y + i), _mm_mul_ps(pvy, dt));
+                __m128 pl  = _mm_sub_ps(_mm_loadu_ps(life + i), dt);
+                __m128 pa  = _mm_mul_ps(pl, _mm_loadu_ps(invLife + i));
+                pa = _mm_min_ps(_mm_max_ps(pa, zero), one);
+
+                _mm_storeu_ps(vy + i, pvy);
+                _mm_storeu_ps(x + i, px);
+                _mm_storeu_ps(y + i, py);
+                _mm_storeu_ps(life + i, pl);
+                _mm_storeu_ps(alpha + i, pa);
+            }
+        }
+#endif
+
+        // tail (or the whole thing on the scalar build)
+        updateScalar(x, y, vx, vy, life, invLife, alpha, i, m_count, dtSec, gravity);
+
+        removeDead();
+    }
+
+    void ParticleSystem::removeDead()
+    {
+        // swap-with-last keeps the live range packed; order doesn't matter
+        std::size_t i = 0;
+        while (i < m_count)
+        {
+            if (m_life[i] > 0.0f)
+            {
+                ++i;
+                continue;
+            }
+
+            const std::size_t last = --m_count;
+            m_x[i]       = m_x[last];
+            m_y[i]       = m_y[last];
+            m_vx[i]      = m_vx[last];
+            m_vy[i]      = m_vy[last];
+            m_life[i]    = m_life[last];
+            m_invLife[i] = m_invLife[last];
+            m_alpha[i]   = m_alpha[last];
+            m_color[i]   = m_color[last];
+        }
+    }
+
+    void ParticleSystem::render(RenderQueue& queue, DrawLayer layer, int offsetX, int offsetY)
+    {
+        if (m_count == 0)
+            return;
+
+        const float size = static_cast<float>(PARTICLE_SIZE);
+        const float ox   = static_cast<float>(offsetX);
+        const float oy   = static_cast<float>(offsetY);
+
+        for (std::size_t i = 0; i < m_count; ++i)
+        {
+            SDL_Color c = m_color[i];
+            c.a = static_cast<Uint8>(m_alpha[i] * 255.0f);
+
+            const float px = m_x[i] + ox;
+            const float py = m_y[i] + oy;
+
+            SDL_Vertex* v = &m_vertices[i * 4];
+            v[0] = SDL_Vertex{SDL_FPoint{px, py}, c, SDL_FPoint{0.0f, 0.0f}};
+            v[1] = SDL_Vertex{SDL_FPoint{px + size, py}, c, SDL_FPoint{0.0f, 0.0f}};
+            v[2] = SDL_Vertex{SDL_FPoint{px + size, py + size}, c, SDL_FPoint{0.0f, 0.0f}};
+            v[3] = SDL_Vertex{SDL_FPoint{px, py + size}, c, SDL_FPoint{0.0f, 0.0f}};
+        }
+
+        queue.geometry(
+            layer,
+            nullptr,
+            m_vertices.data(),
+            static_cast<int>(m_count * 4),
+            m_indices.data(),
+            static_cast<int>(m_count * 6),
+            SDL_BLENDMODE_BLEND);
+    }
+}
@@ -0,0 +1,74 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <SDL2/SDL.h>
+
+#include "RenderQueue.h"
+
+namespace zelda::game
+{
+    // Hit sparks / death bursts.
+    //
+    // Particles are stored as a struct-of-arrays so the update kernel can
+    // stream through one float lane at a time (AVX = 8, SSE = 4 particles
+    // per instruction, plain scalar loop as fallback).
+    // Dead particles are swap-removed, so the live ones are always packed
+    // at [0, count()).
+    //
+    // Everything is sized once at construction: emitting, updating and
+    // drawing never allocate. Extra particles past capacity are dropped.
+    class ParticleSystem
+    {
+    public:
+        static constexpr std::size_t DEFAULT_CAPACITY = 32768;
+        static constexpr int PARTICLE_SIZE = 2; // px, square
+
+        explicit ParticleSystem(std::size_t capacity = DEFAULT_CAPACITY);
+
+        // Spray `count` particles out of (x, y) in random directions.
+        // speed is the max initial speed in px/sec, lifetime in seconds.
+        void emitBurst(float x, float y, int count, SDL_Color color, float speed, float lifetime);
+
+        // Integrate, apply gravity, age and fade every live particle.
+        void update(float dtSec);
+
+        // Queue one geometry command for all live particles on `layer`.
+        // (offsetX, offsetY) is added to every particle (camera / centering).
+        // The vertex buffers are ours, so don't update() before the queue flushes.
+        void render(RenderQueue& queue, DrawLayer layer, int offsetX, int offsetY);
+
+        void clear() { m_count = 0; }
+
+        std::size_t count() const    { return m_count; }
+        std::size_t capacity() const { return m_capacity; }
+
+        // Which update kernel this build uses: "AVX", "SSE2" or "scalar".
+        static const char* kernelName();
+
+        float gravity = 240.0f; // px/sec^2, pulls particles "down" the screen
+
+    private:
+        void removeDead();
+
+        std::size_t m_capacity = 0;
+        std::size_t m_count    = 0;
+
+        // SoA lanes, capacity long. The kernel runs whole vectors while
+        // they fit under m_count and a scalar tail does the rest.
+        std::vector<float> m_x;
+        std::vector<float> m_y;
+        std::vector<float> m_vx;
+        std::vector<float> m_vy;
+        std::vector<float> m_life;    // seconds remaining
+        std::vector<float> m_invLife; // 1 / initial lifetime
+        std::vector<float> m_alpha;   // 0..1, derived from life each update
+        std::vector<SDL_Color> m_color;
+
+        // draw buffers (4 vertices / 6 indices per particle)
+        std::vector<SDL_Vertex> m_vertices;
+        std::vector<int>        m_indices;
+
+        std::uint32_t m_rng = 0x9E3779B9u;
+    };
+}
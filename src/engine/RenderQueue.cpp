@@ -0,0 +1,204 @@
+#include "RenderQueue.h"
+
+#include <algorithm>
+#include <functional>
+
+namespace zelda::game
+{
+    namespace
+    {
+        std::uint32_t packColor(SDL_Color c)
+        {
+            return (std::uint32_t(c.r) << 24) | (std::uint32_t(c.g) << 16) | (std::uint32_t(c.b) << 8) | c.a;
+        }
+
+        bool sameColor(SDL_Color a, SDL_Color b)
+        {
+            return packColor(a) == packColor(b);
+        }
+    }
+
+    RenderQueue::RenderQueue(std::size_t reserveCommands)
+    {
+        m_commands.reserve(reserveCommands);
+        m_order.reserve(reserveCommands);
+        m_fillBatch.reserve(reserveCommands);
+    }
+
+    void RenderQueue::begin(SDL_Renderer* renderer)
+    {
+        m_renderer = renderer;
+        m_commands.clear();
+        m_order.clear();
+    }
+
+    void RenderQueue::fillRect(DrawLayer layer, const SDL_Rect& rect, SDL_Color color, SDL_BlendMode blend)
+    {
+        Command cmd{};
+        cmd.layer = layer;
+        cmd.kind = Kind::Fill;
+        cmd.blend = blend;
+        cmd.color = color;
+        cmd.dst = rect;
+        cmd.seq = static_cast<std::uint32_t>(m_commands.size());
+        m_commands.push_back(cmd);
+    }
+
+    void RenderQueue::copy(DrawLayer layer, SDL_Texture* texture, const SDL_Rect* src, const SDL_Rect& dst)
+    {
+        if (!texture)
+            return;
+
+        Command cmd{};
+        cmd.layer = layer;
+        cmd.kind = Kind::Copy;
+        cmd.texture = texture;
+        cmd.hasSrc = (src != nullptr);
+        if (src)
+            cmd.src = *src;
+        cmd.dst = dst;
+        cmd.seq = static_cast<std::uint32_t>(m_commands.size());
+        m_commands.push_back(cmd);
+    }
+
+    void RenderQueue::geometry(DrawLayer layer, SDL_Texture* texture,
+                               const SDL_Vertex* vertices, int vertexCount,
+                               const int* indices, int indexCount,
+                               SDL_BlendMode blend)
+    {
+        if (vertexCount <= 0)
+            return;
+
+        Command cmd{};
+        cmd.layer = layer;
+        cmd.kind = Kind::Geometry;
+        cmd.blend = blend;
+        cmd.texture = texture;
+        cmd.vertices = vertices;
+        cmd.vertexCount = vertexCount;
+        cmd.indices = indices;
+        cmd.indexCount = indexCount;
+        cmd.seq = static_cast<std::uint32_t>(m_commands.size());
+        m_commands.push_back(cmd);
+    }
+
+    void RenderQueue::setDrawColor(SDL_Color c)
+    {
+        if (m_hasColor && sameColor(m_color, c))
+        {
+            ++m_stats.stateSkipped;
+            return;
+        }
+        SDL_SetRenderDrawColor(m_renderer, c.r, c.g, c.b, c.a);
+        m_color = c;
+        m_hasColor = true;
+        ++m_stats.stateChanges;
+    }
+
+    void RenderQueue::setDrawBlend(SDL_BlendMode b)
+    {
+        if (m_hasBlend && m_blend == b)
+        {
+            ++m_stats.stateSkipped;
+            return;
+        }
+        SDL_SetRenderDrawBlendMode(m_renderer, b);
+        m_blend = b;
+        m_hasBlend = true;
+        ++m_stats.stateChanges;
+    }
+
+    void RenderQueue::useTexture(SDL_Texture* t)
+    {
+        // SDL binds the texture per call; we only count switches
+        if (t == m_texture)
+            return;
+        m_texture = t;
+        ++m_stats.stateChanges;
+    }
+
+    void RenderQueue::flush()
+    {
+        m_stats = RenderStats{};
+        m_stats.commands = static_cast<std::uint32_t>(m_commands.size());
+        if (!m_renderer || m_commands.empty())
+            return;
+
+        // layer > texture > blend > kind > colour (fills), submit order breaks ties
+        m_order.resize(m_commands.size());
+        for (std::uint32_t i = 0; i < m_order.size(); ++i)
+            m_order[i] = i;
+
+        const Command* cmds = m_commands.data();
+        std::sort(m_order.begin(), m_order.end(), [cmds](std::uint32_t ia, std::uint32_t ib)
+        {
+            const Command& a = cmds[ia];
+            const Command& b = cmds[ib];
+            if (a.layer != b.layer)     return a.layer < b.layer;
+            if (a.texture != b.texture) return std::less<SDL_Texture*>()(a.texture, b.texture);
+            if (a.blend != b.blend)     return a.blend < b.blend;
+            if (a.kind != b.kind)       return a.kind < b.kind;
+            if (a.kind == Kind::Fill)
+            {
+                const std::uint32_t ca = packColor(a.color), cb = packColor(b.color);
+                if (ca != cb)
+                    return ca < cb;
+            }
+            return a.seq < b.seq;
+        });
+
+        // whatever happened while recording (chunk rasterising) left unknown state
+        m_hasColor = false;
+        m_hasBlend = false;
+        m_texture = nullptr;
+
+        const std::size_t n = m_order.size();
+        std::size_t i = 0;
+        while (i < n)
+        {
+            const Command& cmd = cmds[m_order[i]];
+            switch (cmd.kind)
+            {
+                case Kind::Fill:
+                {
+                    // one call for the whole run of same-state fills
+                    m_fillBatch.clear();
+                    std::size_t j = i;
+                    while (j < n)
+                    {
+                        const Command& next = cmds[m_order[j]];
+                        if (next.kind != Kind::Fill || next.blend != cmd.blend || !sameColor(next.color, cmd.color))
+                            break;
+                        m_fillBatch.push_back(next.dst);
+                        ++j;
+                    }
+
+                    useTexture(nullptr);
+                    setDrawBlend(cmd.blend);
+                    setDrawColor(cmd.color);
+                    SDL_RenderFillRects(m_renderer, m_fillBatch.data(), static_cast<int>(m_fillBatch.size()));
+                    ++m_stats.draws;
+                    i = j;
+                    continue;
+                }
+                case Kind::Copy:
+                    useTexture(cmd.texture);
+                    SDL_RenderCopy(m_renderer, cmd.texture, cmd.hasSrc ? &cmd.src : nullptr, &cmd.dst);
+                    ++m_stats.draws;
+                    break;
+                case Kind::Geometry:
+                    useTexture(cmd.texture);
+                    if (!cmd.texture)
+                        setDrawBlend(cmd.blend); // untextured geometry uses the draw blend mode
+                    SDL_RenderGeometry(m_renderer, cmd.texture, cmd.vertices, cmd.vertexCount,
+                                       cmd.indices, cmd.indexCount);
+                    ++m_stats.draws;
+                    break;
+            }
+            ++i;
+        }
+
+        m_commands.clear();
+        m_order.clear();
+    }
+}
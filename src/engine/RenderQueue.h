@@ -0,0 +1,110 @@
+#pragma once
+#include <SDL2/SDL.h>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace zelda::game
+{
+    // Back-to-front draw order. Inside one layer the queue is free to
+    // reorder (by texture, blend mode, colour) so anything that must
+    // stay on top of something else needs its own layer.
+    enum class DrawLayer : std::uint8_t
+    {
+        Floor = 0,
+        Decoration,
+        Enemies,
+        Attacks,
+        Particles,
+        Player,
+        Overlay,
+        Hud,
+        Count
+    };
+
+    struct RenderStats
+    {
+        std::uint32_t commands     = 0; // recorded this frame
+        std::uint32_t draws        = 0; // SDL draw calls issued
+        std::uint32_t stateChanges = 0; // draw colour / blend / texture switches issued
+        std::uint32_t stateSkipped = 0; // redundant changes the cache dropped
+    };
+
+    // Thin command layer between game code and SDL_Renderer.
+    //
+    // Game code records fills, texture copies and geometry into the queue;
+    // flush() sorts them by layer, then texture, then blend mode (then
+    // command kind and fill colour), keeps submit order for equal keys,
+    // tracks draw colour / blend mode so unchanged state is never
+    // re-sent, and merges runs of same-coloured fills into one
+    // SDL_RenderFillRects.
+    //
+    // Geometry vertex / index pointers must stay valid until flush().
+    // Storage is reused frame to frame, so a warmed-up queue doesn't allocate.
+    class RenderQueue
+    {
+    public:
+        explicit RenderQueue(std::size_t reserveCommands = 4096);
+
+        // Start a frame (drops anything not flushed).
+        void begin(SDL_Renderer* renderer);
+
+        // For code that has to touch the renderer directly while recording
+        // (e.g. rasterising into a render target). The cache is re-synced at flush().
+        SDL_Renderer* renderer() const { return m_renderer; }
+
+        void fillRect(DrawLayer layer, const SDL_Rect& rect, SDL_Color color,
+                      SDL_BlendMode blend = SDL_BLENDMODE_NONE);
+
+        // src == nullptr copies the whole texture (texture blend mode applies)
+        void copy(DrawLayer layer, SDL_Texture* texture, const SDL_Rect* src, const SDL_Rect& dst);
+
+        void geometry(DrawLayer layer, SDL_Texture* texture,
+                      const SDL_Vertex* vertices, int vertexCount,
+                      const int* indices, int indexCount,
+                      SDL_BlendMode blend = SDL_BLENDMODE_BLEND);
+
+        // Sort and submit everything recorded since begin().
+        void flush();
+
+        const RenderStats& lastStats() const { return m_stats; }
+
+    private:
+        enum class Kind : std::uint8_t { Fill = 0, Copy, Geometry };
+
+        struct Command
+        {
+            DrawLayer layer;
+            Kind kind;
+            SDL_BlendMode blend;
+            SDL_Texture* texture;
+            SDL_Color color;
+            bool hasSrc;
+            SDL_Rect src;
+            SDL_Rect dst;
+            const SDL_Vertex* vertices;
+            const int* indices;
+            int vertexCount;
+            int indexCount;
+            std::uint32_t seq; // submit order, tie breaker
+        };
+
+        void setDrawColor(SDL_Color c);
+        void setDrawBlend(SDL_BlendMode b);
+        void useTexture(SDL_Texture* t);
+
+        SDL_Renderer* m_renderer = nullptr;
+        std::vector<Command> m_commands;
+        std::vector<std::uint32_t> m_order;   // indices into m_commands, sorted
+        std::vector<SDL_Rect> m_fillBatch;    // scratch for SDL_RenderFillRects
+
+        // what the renderer currently has (valid only inside flush())
+        bool m_hasColor = false;
+        SDL_Color m_color{0, 0, 0, 0};
+        bool m_hasBlend = false;
+        SDL_BlendMode m_blend = SDL_BLENDMODE_NONE;
+        SDL_Texture* m_texture = nullptr;
+
+        RenderStats m_stats;
+    };
+}
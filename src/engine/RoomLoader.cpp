@@ -0,0 +1,142 @@
+#include "RoomLoader.h"
+
+#include <fstream>
+
+#include "TileMap.h"
+
+namespace zelda::game
+{
+    TriggerDef makeDoorTrigger(RoomDir dir, int offset, int span, int w, int h)
+    {
+        const int tileSize = TileMap::TILE_SIZE;
+        const int mapPixW = w * tileSize;
+        const int mapPixH = h * tileSize;
+
+        SDL_Rect rect{0, 0, 0, 0};
+        switch (dir)
+        {
+            case RoomDir::North: rect = SDL_Rect{offset * tileSize, -8, span * tileSize, 16}; break;
+            case RoomDir::South: rect = SDL_Rect{offset * tileSize, mapPixH - tileSize, span * tileSize, tileSize + 8}; break;
+            case RoomDir::West:  rect = SDL_Rect{-8, offset * tileSize, 16, span * tileSize}; break;
+            case RoomDir::East:  rect = SDL_Rect{mapPixW - tileSize, offset * tileSize, tileSize + 8, span * tileSize}; break;
+        }
+        return TriggerDef{TriggerType::Door, rect, static_cast<int>(dir)};
+    }
+
+    RoomData makeDebugRoom(int w, int h, int tintId)
+    {
+        RoomData room;
+        room.width  = w;
+        room.height = h;
+        room.tintId = tintId;
+
+        std::vector<int>& base = room.tiles;
+        base.assign(w * h, TILE_FLOOR);
+
+        // Add solid border walls
+        for (int x = 0; x < w; ++x)
+        {
+            base[x] = TILE_WALL;               // top
+            base[x + (h - 1) * w] = TILE_WALL; // bottom
+        }
+        for (int y = 0; y < h; ++y)
+        {
+            base[0 + y * w] = TILE_WALL;       // left
+            base[(w - 1) + y * w] = TILE_WALL; // right
+        }
+
+        // Carve gaps (doors) in all 4 directions:
+        // vertical door gap centered horizontally
+        const int doorXStart = 6;
+        const int doorWidth  = 3;
+        for (int dx = 0; dx < doorWidth; ++dx)
+        {
+            // north/south doors
+            base[(doorXStart + dx) + 0 * w] = TILE_FLOOR;       // top gap
+            base[(doorXStart + dx) + (h - 1) * w] = TILE_FLOOR; // bottom gap
+        }
+
+        // horizontal door gap centered vertically
+        const int doorYStart = 3;
+        const int doorHeight = 2;
+        for (int dy = 0; dy < doorHeight; ++dy)
+        {
+            // west/east doors
+            base[0 + (doorYStart + dy) * w] = TILE_FLOOR;       // left gap
+            base[(w - 1) + (doorYStart + dy) * w] = TILE_FLOOR; // right gap
+        }
+
+        // Door triggers over the gaps.
+        room.triggers.push_back(makeDoorTrigger(RoomDir::North, doorXStart, doorWidth, w, h));
+        room.triggers.push_back(makeDoorTrigger(RoomDir::South, doorXStart, doorWidth, w, h));
+        room.triggers.push_back(makeDoorTrigger(RoomDir::West, doorYStart, doorHeight, w, h));
+        room.triggers.push_back(makeDoorTrigger(RoomDir::East, doorYStart, doorHeight, w, h));
+
+        return room;
+    }
+
+    bool loadRoomFile(const std::string& path, RoomData& out)
+    {
+        std::ifstream in(path);
+        if (!in)
+            return false;
+
+        int w = 0, h = 0;
+        if (!(in >> w >> h) || w <= 0 || h <= 0)
+            return false;
+
+        RoomData room;
+        room.width  = w;
+        room.height = h;
+        room.tiles.reserve(w * h);
+
+        std::string row;
+        for (int y = 0; y < h; ++y)
+        {
+            if (!(in >> row) || (int)row.size() != w)
+                return false;
+            for (char c : row)
+            {
+                if (c < '0' || c > '9')
+                    return false;
+                room.tiles.push_back(c - '0');
+            }
+        }
+
+        // optional trigger lines
+        std::string word;
+        while (in >> word)
+        {
+            if (word != "trigger")
+                return false;
+
+            std::string type;
+            TriggerDef def;
+            if (!(in >> type >> def.rect.x >> def.rect.y >> def.rect.w >> def.rect.h >> def.param))
+                return false;
+
+            if (type == "door")          def.type = TriggerType::Door;
+            else if (type == "trap")     def.type = TriggerType::Trap;
+            else if (type == "plate")    def.type = TriggerType::PressurePlate;
+            else if (type == "cutscene") def.type = TriggerType::Cutscene;
+            else return false;
+
+            // doors travel param (a RoomDir); anything else would index past the neighbour tables
+            if (def.type == TriggerType::Door &&
+                (def.param < static_cast<int>(RoomDir::North) || def.param > static_cast<int>(RoomDir::East)))
+                return false;
+
+            room.triggers.push_back(def);
+        }
+        if (room.triggers.empty())
+            room.triggers = std::move(out.triggers);
+
+        // keep whatever tint / tileset / spawns the caller already picked
+        room.spawns      = std::move(out.spawns);
+        room.tintId      = out.tintId;
+        room.tilesetKey  = out.tilesetKey;
+        room.tilesetPath = out.tilesetPath;
+        out = std::move(room);
+        return true;
+    }
+}
@@ -0,0 +1,74 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <functional>
+
+#include "TriggerSystem.h"
+
+namespace zelda::game
+{
+    enum class RoomDir : int
+    {
+        North = 0,
+        South,
+        West,
+        East
+    };
+
+    enum class SpawnType : int
+    {
+        Player = 0,
+        Enemy,
+        Ambusher // enemy that lies dormant until the player comes close
+    };
+
+    // Where something appears when its room is entered (tile coords).
+    struct SpawnPoint
+    {
+        SpawnType type = SpawnType::Enemy;
+        int tx = 0;
+        int ty = 0;
+    };
+
+    // Plain room description, decoded but not yet turned into a TileMap.
+    // Safe to build on any thread (no SDL objects inside).
+    struct RoomData
+    {
+        int width  = 0;
+        int height = 0;
+        std::vector<int> tiles; // width * height, 0=floor, 1=wall
+        int tintId = 0;
+
+        // trigger volumes (doors etc.), map pixels
+        std::vector<TriggerDef> triggers;
+
+        // player start / enemies (generated dungeons; debug rooms have none)
+        std::vector<SpawnPoint> spawns;
+
+        // texture the room is drawn with (key in TextureManager + file on disk)
+        std::string tilesetKey  = "tiles";
+        std::string tilesetPath = "assets/tiles.png";
+    };
+
+    // Produces the room at grid position (roomX, roomY).
+    // Must be thread-safe: the prefetcher calls it from its worker thread.
+    using RoomLoader = std::function<bool(int roomX, int roomY, RoomData& out)>;
+
+    // Door trigger over a gap in a w x h room's `dir` wall. The gap starts
+    // `offset` tiles along the wall and is `span` tiles long. The trigger
+    // pokes out past the map edge so walking into the gap always reaches it.
+    TriggerDef makeDoorTrigger(RoomDir dir, int offset, int span, int w, int h);
+
+    // The Milestone 7 test room: border walls with a door gap on every side.
+    RoomData makeDebugRoom(int w, int h, int tintId);
+
+    // Text room file:
+    //   line 1: "<width> <height>"
+    //   then <height> lines of <width> digits (tile ids)
+    //   then any number of trigger lines (pixels):
+    //     trigger <door|trap|plate|cutscene> <x> <y> <w> <h> <param>
+    // A file without trigger lines keeps the triggers already in `out`
+    // (spawns are always kept).
+    // Returns false if the file is missing or malformed.
+    bool loadRoomFile(const std::string& path, RoomData& out);
+}
@@ -1,3 +1,210 @@
 #include "RoomManager.h"
-// All methods are inline in the header for now.
-// This file exists so CMake still has a .cpp for RoomManager.
+#include "AllocTracker.h"
+#include "Log.h"
+
+namespace zelda::game
+{
+    void RoomManager::init(int gridW, int gridH, RoomLoader loader, int startX, int startY,
+                           bool backgroundLoading)
+    {
+        shutdown();
+        unload();
+
+        m_gridW = std::max(1, gridW);
+        m_gridH = std::max(1, gridH);
+        m_rooms.resize(static_cast<std::size_t>(m_gridW) * m_gridH);
+
+        m_loader = std::move(loader);
+        m_prefetchHits = 0;
+        m_prefetchMisses = 0;
+
+        m_roomX = std::clamp(startX, 0, m_gridW - 1);
+        m_roomY = std::clamp(startY, 0, m_gridH - 1);
+        enterRoom(m_roomX, m_roomY);
+
+        m_backgroundLoading = backgroundLoading;
+        if (m_backgroundLoading)
+            m_prefetcher.start(m_loader);
+    }
+
+    void RoomManager::debugInitRooms(int w, int h, bool backgroundLoading)
+    {
+        // Every room is the same bordered layout, each gets its own tint.
+        // Layout index = (y * 2 + x)
+        // A file at assets/rooms/room_<x>_<y>.txt replaces the generated layout.
+        RoomLoader loader = [w, h](int rx, int ry, RoomData& out)
+        {
+            out = makeDebugRoom(w, h, ry * 2 + rx);
+            loadRoomFile("assets/rooms/room_" + std::to_string(rx) + "_" + std::to_string(ry) + ".txt", out);
+            return true;
+        };
+
+        // start in top-left room (0,0)
+        init(2, 2, loader, 0, 0, backgroundLoading);
+    }
+
+    void RoomManager::shutdown()
+    {
+        m_prefetcher.stop();
+
+        for (auto& pending : m_pendingTilesets)
+            SDL_FreeSurface(pending.surface);
+        m_pendingTilesets.clear();
+    }
+
+    void RoomManager::unload()
+    {
+        releaseRenderCaches();
+        m_rooms.clear();
+        m_levelArena.reset();
+    }
+
+    bool RoomManager::neighbor(RoomDir dir, int& outX, int& outY) const
+    {
+        int nx = m_roomX;
+        int ny = m_roomY;
+        switch (dir)
+        {
+            case RoomDir::North: ny -= 1; break;
+            case RoomDir::South: ny += 1; break;
+            case RoomDir::West:  nx -= 1; break;
+            case RoomDir::East:  nx += 1; break;
+        }
+        if (!inGrid(nx, ny))
+            return false;
+
+        outX = nx;
+        outY = ny;
+        return true;
+    }
+
+    void RoomManager::go(RoomDir dir)
+    {
+        int nx, ny;
+        if (!neighbor(dir, nx, ny))
+            return;
+
+        enterRoom(nx, ny);
+        m_roomX = nx;
+        m_roomY = ny;
+    }
+
+    bool RoomManager::restoreRoom(int rx, int ry)
+    {
+        if (!inGrid(rx, ry))
+            return false;
+
+        enterRoom(rx, ry);
+        m_roomX = rx;
+        m_roomY = ry;
+        return true;
+    }
+
+    void RoomManager::enterRoom(int rx, int ry)
+    {
+        RoomSlot& slot = m_rooms[slotIndex(rx, ry)];
+        slot.visited = true;
+        if (slot.valid)
+        {
+            if (slot.prefetched)
+            {
+                ++m_prefetchHits;
+                slot.prefetched = false;
+            }
+            return;
+        }
+
+        // Not resident: blocking load on the main thread.
+        // (The first room of the world always lands here.)
+        ++m_prefetchMisses;
+
+        AllocAllowScope loading;
+
+        RoomData data;
+        if (!m_loader || !m_loader(rx, ry, data))
+        {
+            ZLOG_WARN("RoomManager: failed to load room (%d,%d), using debug layout", rx, ry);
+            data = makeDebugRoom(10, 8, 0);
+        }
+        installRoom(rx, ry, data);
+    }
+
+    void RoomManager::installRoom(int rx, int ry, RoomData& data)
+    {
+        RoomSlot& slot = m_rooms[slotIndex(rx, ry)];
+        slot.map.setArena(&m_levelArena);
+        slot.map.setBlockPool(&m_tileBlocks);
+        slot.map.load(data.width, data.height, data.tiles);
+        slot.triggers.build(data.triggers, data.width, data.height, &m_levelArena);
+        slot.spawns = ArenaVector<SpawnPoint>(data.spawns.begin(), data.spawns.end(),
+                                              ArenaAllocator<SpawnPoint>(&m_levelArena));
+        slot.tintId = data.tintId;
+        slot.tilesetKey = std::move(data.tilesetKey);
+        slot.tilesetPath = std::move(data.tilesetPath);
+        slot.valid = true;
+    }
+
+    void RoomManager::ensureCurrentTextures(TextureManager& textures, SDL_Renderer* renderer)
+    {
+        const RoomSlot& slot = currentSlot();
+        if (slot.tilesetKey.empty() || textures.get(slot.tilesetKey))
+            return;
+
+        AllocAllowScope loading;
+        textures.loadTexture(slot.tilesetKey, slot.tilesetPath, renderer);
+    }
+
+    void RoomManager::prefetch(int rx, int ry)
+    {
+        if (!m_backgroundLoading || !inGrid(rx, ry) || m_rooms[slotIndex(rx, ry)].valid)
+            return;
+
+        // Neighbours usually share our tileset (which is loaded, we're
+        // standing in it); only decode theirs if it differs.
+        AllocAllowScope loading;
+        m_prefetcher.request(rx, ry, currentSlot().tilesetKey);
+    }
+
+    void RoomManager::collectPrefetched()
+    {
+        if (!m_backgroundLoading)
+            return;
+
+        AllocAllowScope loading; // installing rooms fills the level arena
+        m_collected.clear();
+        m_prefetcher.takeReady(m_collected);
+
+        for (auto& room : m_collected)
+        {
+            if (room.tileset)
+            {
+                // pixels were decoded on the worker; the upload waits for the renderer
+                m_pendingTilesets.push_back(PendingTileset{room.data.tilesetKey, room.tileset});
+                room.tileset = nullptr;
+            }
+
+            if (!inGrid(room.roomX, room.roomY))
+                continue;
+
+            RoomSlot& slot = m_rooms[slotIndex(room.roomX, room.roomY)];
+            if (slot.valid)
+                continue; // we got there first with a blocking load
+
+            installRoom(room.roomX, room.roomY, room.data);
+            slot.prefetched = true;
+        }
+    }
+
+    void RoomManager::uploadPendingTilesets(TextureManager& textures, SDL_Renderer* renderer)
+    {
+        AllocAllowScope loading;
+        for (auto& pending : m_pendingTilesets)
+        {
+            // upload only, no file I/O
+            if (!textures.get(pending.key))
+                textures.loadTextureFromSurface(pending.key, pending.surface, renderer);
+            SDL_FreeSurface(pending.surface);
+        }
+        m_pendingTilesets.clear();
+    }
+}
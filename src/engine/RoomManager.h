@@ -1,8 +1,14 @@
 #pragma once
 #include <vector>
 #include <array>
+#include <string>
+#include <cstdint>
 #include <algorithm>
 #include "TileMap.h"
+#include "RoomLoader.h"
+#include "RoomPrefetcher.h"
+#include "TextureManager.h"
+#include "Arena.h"
 
 namespace zelda::game
 {
@@ -13,8 +19,19 @@ namespace zelda::game
     //
     // room coords: (m_roomX, m_roomY)
     //
-    // We generate all 4 rooms procedurally for now.
-    // Each room gets a different "tintId" so we can color it differently when rendering.
+    // Milestone 9:
+    // Rooms are no longer all built up front. They come from a RoomLoader
+    // (disk or generator) the first time they are needed. The engine asks
+    // for likely next rooms ahead of time (prefetch()); those load on a
+    // background thread and get installed by collectPrefetched(), so the
+    // door transition itself never waits on I/O.
+    //
+    // All room tile chunks and trigger tables live in one level arena.
+    // There is no per-room free: the whole level goes in one reset when
+    // the world unloads (unload(), init() or destruction).
+    //
+    // Tile ids go through one TileBlockPool per level: rooms built from the
+    // same template share their chunk data until one of them is edited.
 
     class RoomManager
     {
@@ -23,76 +40,47 @@ namespace zelda::game
         : m_roomX(0)
         , m_roomY(0)
         {
-            for (auto &slot : m_rooms)
-                slot.valid = false;
         }
 
         struct RoomSlot {
             bool valid = false;
             TileMap map;
             int tintId = 0; // 0,1,2,3 for visual variation
+
+            std::string tilesetKey;
+            std::string tilesetPath;
+
+            // doors, traps, plates, ... (indexed on this room's tile grid)
+            TriggerTable triggers;
+
+            // player start / enemy spawn tiles (level arena)
+            ArenaVector<SpawnPoint> spawns;
+
+            // installed by the prefetcher and not entered yet
+            bool prefetched = false;
+
+            // player has been here (saved in snapshots)
+            bool visited = false;
         };
 
+        // Set up a gridW x gridH world whose rooms come from `loader`.
+        // Only the start room is loaded right away. Without background
+        // loading, prefetch() does nothing and every room loads on entry.
+        void init(int gridW, int gridH, RoomLoader loader, int startX = 0, int startY = 0,
+                  bool backgroundLoading = true);
+
         // build a 2x2 block of rooms with borders + door gaps
-        void debugInitRooms(int w, int h)
-        {
-            // Precompute base tiles for a single room
-            std::vector<int> base;
-            base.resize(w * h);
-
-            for (int i = 0; i < w * h; ++i)
-                base[i] = 0; // floor
-
-            // Add solid border walls (tile = 1)
-            for (int x = 0; x < w; ++x)
-            {
-                base[x] = 1;                   // top
-                base[x + (h - 1) * w] = 1;     // bottom
-            }
-            for (int y = 0; y < h; ++y)
-            {
-                base[0 + y * w] = 1;           // left
-                base[(w - 1) + y * w] = 1;     // right
-            }
-
-            // Carve gaps (doors) in all 4 directions:
-            // vertical door gap centered horizontally
-            const int doorXStart = 6;
-            const int doorWidth  = 3;
-            for (int dx = 0; dx < doorWidth; ++dx)
-            {
-                // north/south doors
-                base[(doorXStart + dx) + 0 * w] = 0;           // top gap
-                base[(doorXStart + dx) + (h - 1) * w] = 0;     // bottom gap
-            }
-
-            // horizontal door gap centered vertically
-            const int doorYStart = 3;
-            const int doorHeight = 2;
-            for (int dy = 0; dy < doorHeight; ++dy)
-            {
-                // west/east doors
-                base[0 + (doorYStart + dy) * w] = 0;           // left gap
-                base[(w - 1) + (doorYStart + dy) * w] = 0;     // right gap
-            }
-
-            // Now clone that room into a 2x2 grid with different tintIds
-            // Layout index = (y * 2 + x)
-            for (int y = 0; y < 2; ++y)
-            {
-                for (int x = 0; x < 2; ++x)
-                {
-                    int idx = y * 2 + x;
-                    m_rooms[idx].valid = true;
-                    m_rooms[idx].map.load(w, h, base);
-                    m_rooms[idx].tintId = idx; // 0,1,2,3
-                }
-            }
-
-            // start in top-left room (0,0)
-            m_roomX = 0;
-            m_roomY = 0;
-        }
+        void debugInitRooms(int w, int h, bool backgroundLoading = true);
+
+        // Stop the background loader (joins the worker thread).
+        void shutdown();
+
+        // Drop every room and free the level arena in one go.
+        // Render caches are released first, so the renderer must still be alive.
+        void unload();
+
+        const Arena& levelArena() const { return m_levelArena; }
+        const TileBlockPool& tileBlocks() const { return m_tileBlocks; }
 
         // Return the active room's tilemap
         TileMap& currentMap()
@@ -106,22 +94,91 @@ namespace zelda::game
             return currentSlot().tintId;
         }
 
+        const TriggerTable& currentTriggers() const
+        {
+            return currentSlot().triggers;
+        }
+
+        const ArenaVector<SpawnPoint>& currentSpawns() const
+        {
+            return currentSlot().spawns;
+        }
+
+        // Texture key the current room is drawn with.
+        const std::string& currentTilesetKey() const
+        {
+            return currentSlot().tilesetKey;
+        }
+
+        // Load the current room's tileset if it isn't cached yet.
+        // (Blocking I/O, only hit when the prefetcher didn't get there first.)
+        void ensureCurrentTextures(TextureManager& textures, SDL_Renderer* renderer);
+
+        // Drop every room's cached chunk textures (call before the renderer dies).
+        void releaseRenderCaches()
+        {
+            for (auto &slot : m_rooms)
+                slot.map.releaseRenderCache();
+        }
+
         // Where we are in the grid
         int roomX() const { return m_roomX; }
         int roomY() const { return m_roomY; }
+        int gridWidth() const  { return m_gridW; }
+        int gridHeight() const { return m_gridH; }
+
+        // Room on the other side of a door, false at the edge of the grid.
+        bool neighbor(RoomDir dir, int& outX, int& outY) const;
+
+        bool isLoaded(int rx, int ry) const
+        {
+            return inGrid(rx, ry) && m_rooms[slotIndex(rx, ry)].valid;
+        }
+
+        int roomCount() const { return m_gridW * m_gridH; }
+
+        // Per-room state that goes into snapshots (index = y * gridWidth + x).
+        bool isVisited(int index) const { return m_rooms[index].visited; }
+        void setVisited(int index, bool v) { m_rooms[index].visited = v; }
+
+        // Jump straight to a room (snapshot restore). Loads it if needed.
+        bool restoreRoom(int rx, int ry);
 
         // Movement between rooms:
-        void goNorth() { if (m_roomY > 0) m_roomY -= 1; }
-        void goSouth() { if (m_roomY < 1) m_roomY += 1; }
-        void goWest()  { if (m_roomX > 0) m_roomX -= 1; }
-        void goEast()  { if (m_roomX < 1) m_roomX += 1; }
+        void goNorth() { go(RoomDir::North); }
+        void goSouth() { go(RoomDir::South); }
+        void goWest()  { go(RoomDir::West); }
+        void goEast()  { go(RoomDir::East); }
+
+        // --- prefetch ---
+
+        // Ask for a room to be loaded in the background (no-op if loaded / in flight).
+        void prefetch(int rx, int ry);
+
+        // Install finished background loads. Does no file I/O.
+        // Decoded tilesets are kept until uploadPendingTilesets().
+        void collectPrefetched();
+
+        // Turn tilesets decoded by the prefetcher into textures (render thread).
+        void uploadPendingTilesets(TextureManager& textures, SDL_Renderer* renderer);
+
+        std::uint64_t prefetchRequests() const { return m_prefetcher.requestCount(); }
+        std::uint64_t prefetchHits() const     { return m_prefetchHits; }
+        std::uint64_t prefetchMisses() const   { return m_prefetchMisses; }
 
     private:
         // Map a (roomX, roomY) to a slot index
+        int slotIndex(int rx, int ry) const
+        {
+            return ry * m_gridW + rx;
+        }
         int idx() const
         {
-            // 2 columns, 2 rows
-            return m_roomY * 2 + m_roomX;
+            return slotIndex(m_roomX, m_roomY);
+        }
+        bool inGrid(int rx, int ry) const
+        {
+            return rx >= 0 && ry >= 0 && rx < m_gridW && ry < m_gridH;
         }
 
         RoomSlot& currentSlot()
@@ -133,10 +190,36 @@ namespace zelda::game
             return m_rooms[idx()];
         }
 
-        // 2x2 grid => 4 total
-        std::array<RoomSlot, 4> m_rooms;
+        void go(RoomDir dir);
+        void installRoom(int rx, int ry, RoomData& data);
+
+        // Make sure the room we just walked into is resident, load it
+        // synchronously if the prefetcher missed it.
+        void enterRoom(int rx, int ry);
+
+        // declared before m_rooms: rooms point into these, so they must die after them
+        Arena m_levelArena{"level", 64 * 1024};
+        TileBlockPool m_tileBlocks;
+
+        std::vector<RoomSlot> m_rooms; // m_gridW * m_gridH
+        int m_gridW = 0;
+        int m_gridH = 0;
 
         int m_roomX;
         int m_roomY;
+
+        RoomLoader m_loader;
+        RoomPrefetcher m_prefetcher;
+        std::vector<PrefetchedRoom> m_collected; // scratch, reused every tick
+        bool m_backgroundLoading = true;
+
+        struct PendingTileset {
+            std::string key;
+            SDL_Surface* surface;
+        };
+        std::vector<PendingTileset> m_pendingTilesets;
+
+        std::uint64_t m_prefetchHits   = 0;
+        std::uint64_t m_prefetchMisses = 0;
     };
 }
@@ -0,0 +1,138 @@
+#include "RoomPrefetcher.h"
+#include "Log.h"
+
+#include <SDL2/SDL_image.h>
+
+namespace zelda::game
+{
+    RoomPrefetcher::~RoomPrefetcher()
+    {
+        stop();
+    }
+
+    void RoomPrefetcher::start(RoomLoader loader)
+    {
+        stop();
+
+        m_loader = std::move(loader);
+        m_quit = false;
+        m_worker = std::thread(&RoomPrefetcher::workerMain, this);
+    }
+
+    void RoomPrefetcher::stop()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_quit = true;
+            m_queue.clear();
+        }
+        m_wake.notify_all();
+
+        if (m_worker.joinable())
+            m_worker.join();
+
+        // nobody is going to collect these any more
+        for (auto& room : m_ready)
+        {
+            if (room.tileset)
+                SDL_FreeSurface(room.tileset);
+        }
+        m_ready.clear();
+        m_hasActive = false;
+    }
+
+    void RoomPrefetcher::request(int roomX, int roomY, const std::string& residentTileset)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_quit || !m_worker.joinable())
+                return;
+
+            if (m_hasActive && m_active.roomX == roomX && m_active.roomY == roomY)
+                return;
+            for (const auto& job : m_queue)
+                if (job.roomX == roomX && job.roomY == roomY)
+                    return;
+            for (const auto& room : m_ready)
+                if (room.roomX == roomX && room.roomY == roomY)
+                    return;
+
+            m_queue.push_back(Job{roomX, roomY, residentTileset});
+        }
+        m_requests++;
+        m_wake.notify_one();
+    }
+
+    void RoomPrefetcher::takeReady(std::vector<PrefetchedRoom>& out)
+    {
+        // try_lock: if the worker is publishing right now, just pick it up next tick
+        std::unique_lock<std::mutex> lock(m_mutex, std::try_to_lock);
+        if (!lock.owns_lock() || m_ready.empty())
+            return;
+
+        for (auto& room : m_ready)
+            out.push_back(std::move(room));
+        m_ready.clear();
+    }
+
+    bool RoomPrefetcher::isInFlight(int roomX, int roomY) const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_hasActive && m_active.roomX == roomX && m_active.roomY == roomY)
+            return true;
+        for (const auto& job : m_queue)
+            if (job.roomX == roomX && job.roomY == roomY)
+                return true;
+        return false;
+    }
+
+    void RoomPrefetcher::workerMain()
+    {
+        for (;;)
+        {
+            Job job{0, 0, {}};
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_wake.wait(lock, [this] { return m_quit || !m_queue.empty(); });
+                if (m_quit)
+                    return;
+
+                job = m_queue.front();
+                m_queue.pop_front();
+                m_active = job;
+                m_hasActive = true;
+            }
+
+            PrefetchedRoom room;
+            room.roomX = job.roomX;
+            room.roomY = job.roomY;
+
+            bool ok = m_loader && m_loader(job.roomX, job.roomY, room.data);
+            if (ok && room.data.tilesetKey != job.residentTileset && !room.data.tilesetPath.empty())
+            {
+                room.tileset = IMG_Load(room.data.tilesetPath.c_str());
+                if (!room.tileset)
+                {
+                    ZLOG_WARN("RoomPrefetcher: failed to decode '%s': %s",
+                              room.data.tilesetPath.c_str(),
+                              IMG_GetError());
+                }
+            }
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_hasActive = false;
+            if (!ok)
+            {
+                ZLOG_WARN("RoomPrefetcher: loader failed for room (%d,%d)", job.roomX, job.roomY);
+                continue;
+            }
+            if (m_quit)
+            {
+                if (room.tileset)
+                    SDL_FreeSurface(room.tileset);
+                return;
+            }
+            m_ready.push_back(std::move(room));
+        }
+    }
+}
@@ -0,0 +1,85 @@
+#pragma once
+#include <SDL2/SDL.h>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <vector>
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+#include "RoomLoader.h"
+
+namespace zelda::game
+{
+    // A room that finished loading on the worker thread.
+    struct PrefetchedRoom
+    {
+        int roomX = 0;
+        int roomY = 0;
+        RoomData data;
+
+        // Decoded tileset pixels, if the main thread asked for them.
+        // Turning this into an SDL_Texture is cheap and has to happen on
+        // the main thread anyway (renderer isn't thread-safe).
+        // Ownership passes to whoever takes the room.
+        SDL_Surface* tileset = nullptr;
+    };
+
+    // Background room loader.
+    //
+    // The main thread queues rooms it thinks the player is about to walk
+    // into; one worker thread runs the RoomLoader (disk read + parse) and
+    // decodes the tileset image. Finished rooms wait in a small "ready"
+    // list until the main thread collects them with takeReady().
+    // Nothing here ever blocks the main thread on I/O.
+    class RoomPrefetcher
+    {
+    public:
+        RoomPrefetcher() = default;
+        ~RoomPrefetcher();
+
+        RoomPrefetcher(const RoomPrefetcher&) = delete;
+        RoomPrefetcher& operator=(const RoomPrefetcher&) = delete;
+
+        void start(RoomLoader loader);
+        void stop();
+
+        // Queue a room. Ignored if it's already queued, loading or ready.
+        // The room's tileset gets decoded too, unless it turns out to be
+        // `residentTileset` (a texture key the main thread already has).
+        void request(int roomX, int roomY, const std::string& residentTileset);
+
+        // Move every finished room into `out`. Never waits on the worker.
+        void takeReady(std::vector<PrefetchedRoom>& out);
+
+        // Is (roomX, roomY) queued or currently loading?
+        bool isInFlight(int roomX, int roomY) const;
+
+        std::uint64_t requestCount() const { return m_requests.load(); }
+
+    private:
+        struct Job
+        {
+            int roomX;
+            int roomY;
+            std::string residentTileset;
+        };
+
+        void workerMain();
+
+        RoomLoader m_loader;
+        std::thread m_worker;
+
+        mutable std::mutex m_mutex;
+        std::condition_variable m_wake;
+        std::deque<Job> m_queue;
+        std::vector<PrefetchedRoom> m_ready;
+        bool m_hasActive = false; // job currently being loaded
+        Job  m_active{0, 0, {}};
+        bool m_quit = false;
+
+        std::atomic<std::uint64_t> m_requests{0};
+    };
+}
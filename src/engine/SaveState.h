@@ -0,0 +1,271 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+
+namespace zelda::game
+{
+    // Flat binary game snapshot.
+    //
+    // Records are the raw host-layout structs below (host byte order, no
+    // padding surprises: every record is made of 4-byte fields), so a
+    // blob is only readable by the same build on the same kind of machine.
+    // Layout:
+    //
+    //   SnapshotHeader
+    //   PlayerRecord
+    //   CameraRecord
+    //   RoomRecord
+    //   visited bits        (RoomRecord::gridW * gridH bits, rounded up to bytes)
+    //   uint32 enemyCount,  EnemyRecord  x enemyCount
+    //   uint32 attackCount, AttackRecord x attackCount
+    //
+    // Bump SNAPSHOT_VERSION whenever a record changes. Old blobs are rejected.
+    //
+    // The buffer is sized once with reserve(); writing and reading after
+    // that never touches the heap, so snapshots are cheap enough to take
+    // every tick (rewind) as well as on demand (quicksave / retry).
+
+    constexpr std::uint32_t SNAPSHOT_MAGIC   = 0x5641535Au; // "ZSAV"
+    constexpr std::uint16_t SNAPSHOT_VERSION = 4;
+
+    struct SnapshotHeader
+    {
+        std::uint32_t magic;
+        std::uint16_t version;
+        std::uint16_t reserved;
+        std::uint32_t payloadBytes; // everything after the header
+    };
+
+    struct PlayerRecord
+    {
+        float x;
+        float y;
+        float attackCooldown;
+        std::uint32_t flags; // PLAYER_* bits below
+        std::uint32_t anim;  // SpriteAnimator::packSlot()
+    };
+
+    enum : std::uint32_t
+    {
+        PLAYER_MOVE_UP    = 1u << 0,
+        PLAYER_MOVE_DOWN  = 1u << 1,
+        PLAYER_MOVE_LEFT  = 1u << 2,
+        PLAYER_MOVE_RIGHT = 1u << 3,
+        PLAYER_ATTACKING  = 1u << 4
+    };
+
+    struct CameraRecord
+    {
+        float x;
+        float y;
+        std::int32_t width;
+        std::int32_t height;
+    };
+
+    struct RoomRecord
+    {
+        std::int32_t roomX;
+        std::int32_t roomY;
+        std::int32_t gridW;
+        std::int32_t gridH;
+    };
+
+    struct EnemyRecord
+    {
+        float x;
+        float y;
+        std::int32_t hp;
+
+        // brain (EnemyBrain), so a restored world thinks the same way
+        std::int32_t mode;
+        float dirX;
+        float dirY;
+        float targetX;
+        float targetY;
+        float credit;
+        std::int32_t modeTicks;
+
+        std::uint32_t flags; // ENEMY_* bits below
+        std::uint32_t anim;  // SpriteAnimator::packSlot()
+    };
+
+    enum : std::uint32_t
+    {
+        ENEMY_DORMANT = 1u << 0 // ambusher still waiting (its behaviour restarts on load)
+    };
+
+    struct AttackRecord
+    {
+        std::int32_t x;
+        std::int32_t y;
+        std::int32_t w;
+        std::int32_t h;
+        float lifetime;
+    };
+
+    class SaveState
+    {
+    public:
+        // The only allocation. Writes past this capacity fail instead of growing.
+        void reserve(std::size_t bytes)
+        {
+            m_bytes.resize(bytes);
+            m_size = 0;
+        }
+
+        std::size_t size() const     { return m_size; }
+        std::size_t capacity() const { return m_bytes.size(); }
+        bool empty() const           { return m_size == 0; }
+        const std::uint8_t* data() const { return m_bytes.data(); }
+
+        void clear() { m_size = 0; }
+
+        // --- writing ---
+
+        // Start a new blob (leaves room for the header).
+        void beginWrite()
+        {
+            m_size = 0;
+            m_overflow = false;
+            SnapshotHeader h{SNAPSHOT_MAGIC, SNAPSHOT_VERSION, 0, 0};
+            write(h);
+        }
+
+        void writeBytes(const void* src, std::size_t n)
+        {
+            if (m_overflow || m_size + n > m_bytes.size())
+            {
+                m_overflow = true;
+                return;
+            }
+            std::memcpy(m_bytes.data() + m_size, src, n);
+            m_size += n;
+        }
+
+        template <typename T>
+        void write(const T& record)
+        {
+            static_assert(std::is_trivially_copyable<T>::value, "snapshot records must be POD");
+            writeBytes(&record, sizeof(T));
+        }
+
+        // Patch the header; false (and an empty blob) if anything didn't fit.
+        bool endWrite()
+        {
+            if (m_overflow)
+            {
+                m_size = 0;
+                return false;
+            }
+            std::uint32_t payload = static_cast<std::uint32_t>(m_size - sizeof(SnapshotHeader));
+            std::memcpy(m_bytes.data() + offsetof(SnapshotHeader, payloadBytes), &payload, sizeof(payload));
+            return true;
+        }
+
+        // --- reading ---
+
+        class Reader
+        {
+        public:
+            explicit Reader(const SaveState& state)
+            : m_data(state.data())
+            , m_size(state.size())
+            {
+            }
+
+            // Checks magic, version and size. Call first.
+            bool readHeader()
+            {
+                SnapshotHeader h;
+                if (!read(h))
+                    return false;
+                return h.magic == SNAPSHOT_MAGIC &&
+                       h.version == SNAPSHOT_VERSION &&
+                       h.payloadBytes == m_size - sizeof(SnapshotHeader);
+            }
+
+            bool readBytes(void* dst, std::size_t n)
+            {
+                if (m_pos + n > m_size)
+                    return false;
+                std::memcpy(dst, m_data + m_pos, n);
+                m_pos += n;
+                return true;
+            }
+
+            template <typename T>
+            bool read(T& record)
+            {
+                static_assert(std::is_trivially_copyable<T>::value, "snapshot records must be POD");
+                return readBytes(&record, sizeof(T));
+            }
+
+            // Borrow the next n bytes in place (no copy).
+            const std::uint8_t* view(std::size_t n)
+            {
+                if (m_pos + n > m_size)
+                    return nullptr;
+                const std::uint8_t* p = m_data + m_pos;
+                m_pos += n;
+                return p;
+            }
+
+        private:
+            const std::uint8_t* m_data;
+            std::size_t m_size;
+            std::size_t m_pos = 0;
+        };
+
+    private:
+        std::vector<std::uint8_t> m_bytes;
+        std::size_t m_size = 0;
+        bool m_overflow = false;
+    };
+
+    // Fixed ring of recent snapshots for rewinding.
+    // push() overwrites the oldest one once full; pop() walks back in time.
+    class SnapshotRing
+    {
+    public:
+        void init(std::size_t count, std::size_t bytesEach)
+        {
+            m_slots.resize(count);
+            for (auto& s : m_slots)
+                s.reserve(bytesEach);
+            m_head = 0;
+            m_count = 0;
+        }
+
+        // Slot to write the next snapshot into.
+        SaveState& push()
+        {
+            SaveState& slot = m_slots[m_head];
+            m_head = (m_head + 1) % m_slots.size();
+            if (m_count < m_slots.size())
+                ++m_count;
+            return slot;
+        }
+
+        // Most recent snapshot, removed from the ring. nullptr when empty.
+        const SaveState* pop()
+        {
+            if (m_count == 0)
+                return nullptr;
+            m_head = (m_head + m_slots.size() - 1) % m_slots.size();
+            --m_count;
+            return &m_slots[m_head];
+        }
+
+        std::size_t count() const    { return m_count; }
+        std::size_t capacity() const { return m_slots.size(); }
+        void clear()                 { m_head = 0; m_count = 0; }
+
+    private:
+        std::vector<SaveState> m_slots;
+        std::size_t m_head = 0;
+        std::size_t m_count = 0;
+    };
+}
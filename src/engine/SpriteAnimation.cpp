@@ -0,0 +1,100 @@
+#include "SpriteAnimation.h"
+
+namespace zelda::game
+{
+    void SpriteAnimator::resize(std::size_t slots)
+    {
+        m_clip.assign(slots, 0);
+        m_frame.assign(slots, 0);
+        m_flags.assign(slots, 0);
+        m_time.assign(slots, 0);
+        m_finished.clear();
+        m_finished.reserve(slots);
+    }
+
+    void SpriteAnimator::restart(std::uint32_t slot, AnimClipId clip)
+    {
+        if (&frame(slot) != &ANIM_FRAMES[ANIM_CLIPS[static_cast<int>(clip)].first])
+            ++m_frameChanges;
+        m_clip[slot] = static_cast<std::uint8_t>(clip);
+        m_frame[slot] = 0;
+        m_flags[slot] = 0;
+        m_time[slot] = 0;
+    }
+
+    void SpriteAnimator::advance(std::size_t count)
+    {
+        m_finished.clear();
+
+        const std::size_t n = count < m_clip.size() ? count : m_clip.size();
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            if (m_flags[i] & FLAG_DONE)
+                continue;
+
+            const AnimClip& clip = ANIM_CLIPS[m_clip[i]];
+            if (++m_time[i] < ANIM_FRAMES[clip.first + m_frame[i]].ticks)
+                continue;
+            m_time[i] = 0;
+
+            const int last = clip.count - 1;
+            int frame = m_frame[i];
+            switch (clip.loop)
+            {
+                case AnimLoop::Loop:
+                    frame = frame < last ? frame + 1 : 0;
+                    break;
+                case AnimLoop::Once:
+                    if (frame < last)
+                    {
+                        ++frame;
+                    }
+                    else
+                    {
+                        m_flags[i] |= FLAG_DONE;
+                        m_finished.push_back(static_cast<std::uint32_t>(i)); // reserved in resize()
+                    }
+                    break;
+                case AnimLoop::PingPong:
+                    if (last == 0)
+                        break;
+                    if (m_flags[i] & FLAG_BACKWARDS)
+                    {
+                        if (--frame == 0)
+                            m_flags[i] &= ~FLAG_BACKWARDS;
+                    }
+                    else if (++frame == last)
+                    {
+                        m_flags[i] |= FLAG_BACKWARDS;
+                    }
+                    break;
+            }
+            m_frameChanges += frame != m_frame[i];
+            m_frame[i] = static_cast<std::uint8_t>(frame);
+        }
+    }
+
+    std::uint32_t SpriteAnimator::packSlot(std::uint32_t slot) const
+    {
+        return static_cast<std::uint32_t>(m_clip[slot]) |
+               static_cast<std::uint32_t>(m_frame[slot]) << 8 |
+               static_cast<std::uint32_t>(m_flags[slot]) << 16 |
+               static_cast<std::uint32_t>(m_time[slot]) << 24;
+    }
+
+    void SpriteAnimator::unpackSlot(std::uint32_t slot, std::uint32_t packed)
+    {
+        // anything out of range (old / damaged snapshot) restarts clip 0
+        const std::uint8_t clip = static_cast<std::uint8_t>(packed);
+        const std::uint8_t frame = static_cast<std::uint8_t>(packed >> 8);
+        if (clip >= static_cast<std::uint8_t>(AnimClipId::Count) || frame >= ANIM_CLIPS[clip].count)
+        {
+            restart(slot, AnimClipId::PlayerIdle);
+            return;
+        }
+        m_clip[slot] = clip;
+        m_frame[slot] = frame;
+        m_flags[slot] = static_cast<std::uint8_t>(packed >> 16);
+        m_time[slot] = static_cast<std::uint8_t>(packed >> 24);
+    }
+}
@@ -0,0 +1,176 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <SDL2/SDL.h>
+
+namespace zelda::game
+{
+    // Sprite animation clips on assets/sprites.png (16px cells):
+    //   row 0: player  idle 0-1, walk 2-5, attack 6
+    //   row 1: enemy   idle 0-1, walk 2-3, dormant 4, waking 5-7
+    //
+    // A clip is a run of frames in ANIM_FRAMES; every frame has its own
+    // duration and a flat colour for when sprites.png didn't load.
+
+    enum class AnimLoop : std::uint8_t
+    {
+        Loop = 0, // 0 1 2 0 1 2 ...
+        Once,     // 0 1 2, then holds 2 and reports the clip as finished
+        PingPong  // 0 1 2 1 0 1 ...
+    };
+
+    struct AnimFrame
+    {
+        SDL_Rect src;
+        std::uint8_t ticks; // how long it shows (60 Hz ticks, >= 1)
+        SDL_Color fallback;
+    };
+
+    struct AnimClip
+    {
+        std::uint16_t first; // into ANIM_FRAMES
+        std::uint8_t count;
+        AnimLoop loop;
+    };
+
+    enum class AnimClipId : std::uint8_t
+    {
+        PlayerIdle = 0,
+        PlayerWalk,
+        PlayerAttack,
+        EnemyIdle,
+        EnemyWalk,
+        EnemyDormant,
+        EnemyWake,
+        Count
+    };
+
+    namespace detail
+    {
+        constexpr SDL_Rect spriteCell(int col, int row) { return SDL_Rect{col * 16, row * 16, 16, 16}; }
+
+        constexpr SDL_Color PLAYER_GREEN{0, 200, 0, 255};
+        constexpr SDL_Color ENEMY_RED{180, 40, 40, 255};
+        constexpr SDL_Color ENEMY_DARK{90, 30, 30, 255};
+        constexpr SDL_Color ENEMY_FLASH{255, 140, 140, 255};
+    }
+
+    inline constexpr AnimFrame ANIM_FRAMES[] = {
+        // player idle (0)
+        {detail::spriteCell(0, 0), 30, detail::PLAYER_GREEN},
+        {detail::spriteCell(1, 0), 30, detail::PLAYER_GREEN},
+        // player walk (2)
+        {detail::spriteCell(2, 0), 6, detail::PLAYER_GREEN},
+        {detail::spriteCell(3, 0), 6, detail::PLAYER_GREEN},
+        {detail::spriteCell(4, 0), 6, detail::PLAYER_GREEN},
+        {detail::spriteCell(5, 0), 6, detail::PLAYER_GREEN},
+        // player attack (6), as long as the attack cooldown
+        {detail::spriteCell(6, 0), 18, detail::PLAYER_GREEN},
+        // enemy idle (7)
+        {detail::spriteCell(0, 1), 24, detail::ENEMY_RED},
+        {detail::spriteCell(1, 1), 24, detail::ENEMY_RED},
+        // enemy walk (9)
+        {detail::spriteCell(2, 1), 8, detail::ENEMY_RED},
+        {detail::spriteCell(3, 1), 8, detail::ENEMY_RED},
+        // enemy dormant (11)
+        {detail::spriteCell(4, 1), 60, detail::ENEMY_DARK},
+        // enemy waking up (12): flicker, then the eyes open
+        {detail::spriteCell(5, 1), 4, detail::ENEMY_FLASH},
+        {detail::spriteCell(6, 1), 4, detail::ENEMY_RED},
+        {detail::spriteCell(5, 1), 4, detail::ENEMY_FLASH},
+        {detail::spriteCell(6, 1), 4, detail::ENEMY_RED},
+        {detail::spriteCell(7, 1), 8, detail::ENEMY_FLASH},
+    };
+
+    inline constexpr AnimClip ANIM_CLIPS[] = {
+        {0, 2, AnimLoop::Loop},     // PlayerIdle
+        {2, 4, AnimLoop::Loop},     // PlayerWalk
+        {6, 1, AnimLoop::Once},     // PlayerAttack
+        {7, 2, AnimLoop::PingPong}, // EnemyIdle
+        {9, 2, AnimLoop::Loop},     // EnemyWalk
+        {11, 1, AnimLoop::Loop},    // EnemyDormant
+        {12, 5, AnimLoop::Once},    // EnemyWake
+    };
+
+    static_assert(sizeof(ANIM_CLIPS) / sizeof(ANIM_CLIPS[0]) == static_cast<std::size_t>(AnimClipId::Count),
+                  "one clip per AnimClipId");
+
+    namespace detail
+    {
+        constexpr bool frameTicksValid()
+        {
+            for (const AnimFrame& f : ANIM_FRAMES)
+                if (f.ticks < 1)
+                    return false;
+            return true;
+        }
+    }
+    static_assert(detail::frameTicksValid(), "frame durations must be at least one tick");
+
+    // Clip length in ticks (how long a Once clip takes to finish).
+    constexpr int clipTicks(AnimClipId id)
+    {
+        const AnimClip& clip = ANIM_CLIPS[static_cast<int>(id)];
+        int ticks = 0;
+        for (int i = 0; i < clip.count; ++i)
+            ticks += ANIM_FRAMES[clip.first + i].ticks;
+        return ticks;
+    }
+
+    // Animation state for a fixed set of slots (player, enemies, ...).
+    //
+    // State is kept as parallel arrays and advance() moves every slot one
+    // tick in a single pass; there's no per-entity object or callback.
+    // Once clips that end during advance() are listed in finished() until
+    // the next advance(), which is how gameplay waits for "animation end".
+    class SpriteAnimator
+    {
+    public:
+        // Slot count (allocates; do it at init).
+        void resize(std::size_t slots);
+        std::size_t size() const { return m_clip.size(); }
+
+        // Switch to `clip`; keeps the current phase if it's already playing.
+        void play(std::uint32_t slot, AnimClipId clip)
+        {
+            if (m_clip[slot] != static_cast<std::uint8_t>(clip))
+                restart(slot, clip);
+        }
+
+        // Start `clip` from its first frame.
+        void restart(std::uint32_t slot, AnimClipId clip);
+
+        // One tick for slots [0, count) (count past size() = all of them).
+        void advance(std::size_t count = SIZE_MAX);
+
+        AnimClipId clip(std::uint32_t slot) const { return static_cast<AnimClipId>(m_clip[slot]); }
+        bool done(std::uint32_t slot) const       { return m_flags[slot] & FLAG_DONE; }
+        const AnimFrame& frame(std::uint32_t slot) const
+        {
+            return ANIM_FRAMES[ANIM_CLIPS[m_clip[slot]].first + m_frame[slot]];
+        }
+
+        // Slots whose Once clip ended in the last advance().
+        const std::vector<std::uint32_t>& finished() const { return m_finished; }
+
+        // Counts every time some slot's shown frame changed (advance or
+        // restart); compare two readings to know if anything needs redrawing.
+        std::uint64_t frameChanges() const { return m_frameChanges; }
+
+        // Whole state of one slot in 32 bits (snapshots).
+        std::uint32_t packSlot(std::uint32_t slot) const;
+        void unpackSlot(std::uint32_t slot, std::uint32_t packed);
+
+    private:
+        static constexpr std::uint8_t FLAG_DONE = 1u << 0;
+        static constexpr std::uint8_t FLAG_BACKWARDS = 1u << 1; // ping-pong on the way back
+
+        std::vector<std::uint8_t> m_clip;
+        std::vector<std::uint8_t> m_frame;  // within the clip
+        std::vector<std::uint8_t> m_flags;
+        std::vector<std::uint8_t> m_time;   // ticks into the current frame
+        std::vector<std::uint32_t> m_finished;
+        std::uint64_t m_frameChanges = 0;
+    };
+}
@@ -0,0 +1,106 @@
+#include "SpriteBatch.h"
+
+#include <algorithm>
+#include <functional>
+
+namespace zelda::game
+{
+    SpriteBatch::SpriteBatch(std::size_t reserveSprites)
+    {
+        m_sprites.reserve(reserveSprites);
+        m_order.reserve(reserveSprites);
+        m_vertices.reserve(reserveSprites * 4);
+        m_indices.reserve(reserveSprites * 6);
+    }
+
+    void SpriteBatch::begin()
+    {
+        m_sprites.clear();
+    }
+
+    void SpriteBatch::add(DrawLayer layer, SDL_Texture* texture, const SDL_Rect& src, const SDL_FRect& dst,
+                          SDL_Color color)
+    {
+        m_sprites.push_back(Sprite{layer, texture, src, dst, color, static_cast<std::uint32_t>(m_sprites.size())});
+    }
+
+    void SpriteBatch::submit(RenderQueue& queue)
+    {
+        m_batches = 0;
+        const std::size_t n = m_sprites.size();
+        if (n == 0)
+            return;
+
+        // layer > texture > bottom edge, add order breaks ties
+        m_order.resize(n);
+        for (std::uint32_t i = 0; i < n; ++i)
+            m_order[i] = i;
+
+        const Sprite* sprites = m_sprites.data();
+        std::sort(m_order.begin(), m_order.end(), [sprites](std::uint32_t ia, std::uint32_t ib)
+        {
+            const Sprite& a = sprites[ia];
+            const Sprite& b = sprites[ib];
+            if (a.layer != b.layer)     return a.layer < b.layer;
+            if (a.texture != b.texture) return std::less<SDL_Texture*>()(a.texture, b.texture);
+            const float ya = a.dst.y + a.dst.h, yb = b.dst.y + b.dst.h;
+            if (ya != yb)               return ya < yb;
+            return a.seq < b.seq;
+        });
+
+        // the index pattern is the same for every quad, so one buffer
+        // (grown as needed) serves every batch
+        if (m_indices.size() < n * 6)
+        {
+            for (std::size_t q = m_indices.size() / 6; q < n; ++q)
+            {
+                const int v = static_cast<int>(q * 4);
+                const int quad[6] = {v, v + 1, v + 2, v + 2, v + 1, v + 3};
+                m_indices.insert(m_indices.end(), quad, quad + 6);
+            }
+        }
+
+        // all vertices first: the queue keeps pointers into this buffer
+        m_vertices.resize(n * 4);
+        std::size_t i = 0;
+        while (i < n)
+        {
+            const Sprite& head = sprites[m_order[i]];
+
+            float invW = 0.0f, invH = 0.0f;
+            if (head.texture)
+            {
+                int texW = 0, texH = 0;
+                SDL_QueryTexture(head.texture, nullptr, nullptr, &texW, &texH);
+                invW = texW > 0 ? 1.0f / texW : 0.0f;
+                invH = texH > 0 ? 1.0f / texH : 0.0f;
+            }
+
+            std::size_t j = i;
+            for (; j < n; ++j)
+            {
+                const Sprite& s = sprites[m_order[j]];
+                if (s.layer != head.layer || s.texture != head.texture)
+                    break;
+
+                const float u0 = s.src.x * invW, u1 = (s.src.x + s.src.w) * invW;
+                const float v0 = s.src.y * invH, v1 = (s.src.y + s.src.h) * invH;
+                const float x0 = s.dst.x, x1 = s.dst.x + s.dst.w;
+                const float y0 = s.dst.y, y1 = s.dst.y + s.dst.h;
+
+                SDL_Vertex* q = m_vertices.data() + j * 4;
+                q[0] = SDL_Vertex{SDL_FPoint{x0, y0}, s.color, SDL_FPoint{u0, v0}};
+                q[1] = SDL_Vertex{SDL_FPoint{x1, y0}, s.color, SDL_FPoint{u1, v0}};
+                q[2] = SDL_Vertex{SDL_FPoint{x0, y1}, s.color, SDL_FPoint{u0, v1}};
+                q[3] = SDL_Vertex{SDL_FPoint{x1, y1}, s.color, SDL_FPoint{u1, v1}};
+            }
+
+            // indices start at 0 for every batch: point at the batch's first vertex
+            const int quads = static_cast<int>(j - i);
+            queue.geometry(head.layer, head.texture, m_vertices.data() + i * 4, quads * 4,
+                           m_indices.data(), quads * 6);
+            ++m_batches;
+            i = j;
+        }
+    }
+}
@@ -0,0 +1,56 @@
+#pragma once
+#include <SDL2/SDL.h>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+#include "RenderQueue.h"
+
+namespace zelda::game
+{
+    // Collects sprites (atlas sub-rect -> screen rect) for one frame and
+    // hands them to a RenderQueue as one geometry batch per layer and
+    // texture, instead of one copy per sprite.
+    //
+    // Inside a batch sprites are ordered by their bottom edge, so lower
+    // sprites overlap higher ones. Without a texture a sprite is a flat
+    // quad in its colour (still batched).
+    //
+    // The vertices live here until the queue is flushed: submit() after
+    // adding, flush the queue, then begin() the next frame. Storage is
+    // reused frame to frame.
+    class SpriteBatch
+    {
+    public:
+        explicit SpriteBatch(std::size_t reserveSprites = 1024);
+
+        void begin();
+
+        // `color` tints textured sprites and is the fill of untextured ones.
+        void add(DrawLayer layer, SDL_Texture* texture, const SDL_Rect& src, const SDL_FRect& dst,
+                 SDL_Color color = SDL_Color{255, 255, 255, 255});
+
+        // Sort and record everything added since begin() into `queue`.
+        void submit(RenderQueue& queue);
+
+        std::size_t spriteCount() const { return m_sprites.size(); }
+        std::size_t batchCount() const  { return m_batches; } // geometry commands last submit()
+
+    private:
+        struct Sprite
+        {
+            DrawLayer layer;
+            SDL_Texture* texture;
+            SDL_Rect src;
+            SDL_FRect dst;
+            SDL_Color color;
+            std::uint32_t seq;
+        };
+
+        std::vector<Sprite> m_sprites;
+        std::vector<std::uint32_t> m_order;
+        std::vector<SDL_Vertex> m_vertices;
+        std::vector<int> m_indices; // 0 1 2 2 1 3, +4 per quad; shared by every batch
+        std::size_t m_batches = 0;
+    };
+}
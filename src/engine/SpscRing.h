@@ -0,0 +1,60 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+
+namespace zelda::game
+{
+    // Fixed-size single-producer / single-consumer queue.
+    //
+    // One thread push()es, one other thread pop()s; no locks, no
+    // allocation. Capacity must be a power of two (one slot stays empty
+    // to tell full from empty). push() returns false when full: the
+    // caller decides whether dropping is acceptable.
+    template <typename T, std::size_t Capacity>
+    class SpscRing
+    {
+        static_assert((Capacity & (Capacity - 1)) == 0, "capacity must be a power of two");
+        static_assert(std::is_trivially_copyable<T>::value, "ring items are copied around as bytes");
+
+    public:
+        bool push(const T& item)
+        {
+            const std::size_t head = m_head.load(std::memory_order_relaxed);
+            const std::size_t next = (head + 1) & MASK;
+            if (next == m_tail.load(std::memory_order_acquire))
+                return false; // full
+
+            m_items[head] = item;
+            m_head.store(next, std::memory_order_release);
+            return true;
+        }
+
+        bool pop(T& out)
+        {
+            const std::size_t tail = m_tail.load(std::memory_order_relaxed);
+            if (tail == m_head.load(std::memory_order_acquire))
+                return false; // empty
+
+            out = m_items[tail];
+            m_tail.store((tail + 1) & MASK, std::memory_order_release);
+            return true;
+        }
+
+        bool empty() const
+        {
+            return m_tail.load(std::memory_order_acquire) == m_head.load(std::memory_order_acquire);
+        }
+
+        static constexpr std::size_t capacity() { return Capacity - 1; }
+
+    private:
+        static constexpr std::size_t MASK = Capacity - 1;
+
+        // producer and consumer indices on separate cache lines
+        alignas(64) std::atomic<std::size_t> m_head{0};
+        alignas(64) std::atomic<std::size_t> m_tail{0};
+        alignas(64) std::array<T, Capacity> m_items{};
+    };
+}
@@ -0,0 +1,203 @@
+#include "TextRenderer.h"
+#include "BitmapFont.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+namespace zelda::game
+{
+    TextLabel::TextLabel(std::size_t maxChars)
+        : m_maxChars(maxChars)
+    {
+        m_text.reserve(maxChars);
+        m_quads.reserve(maxChars * 4);
+    }
+
+    bool TextLabel::set(std::string_view text)
+    {
+        m_kind = NumberKind::None;
+        if (text.size() > m_maxChars)
+            text = text.substr(0, m_maxChars);
+        if (text == m_text)
+            return false;
+
+        m_text.assign(text.data(), text.size());
+        layout();
+        return true;
+    }
+
+    bool TextLabel::setNumber(const char* prefix, int value, const char* suffix)
+    {
+        return setFormatted(NumberKind::Whole, prefix, value, suffix);
+    }
+
+    bool TextLabel::setTenths(const char* prefix, float value, const char* suffix)
+    {
+        return setFormatted(NumberKind::Tenths, prefix, static_cast<int>(std::lround(value * 10.0f)), suffix);
+    }
+
+    bool TextLabel::setFormatted(NumberKind kind, const char* prefix, int key, const char* suffix)
+    {
+        if (m_kind == kind && m_key == key && m_prefix == prefix && m_suffix == suffix)
+            return false;
+
+        char buf[128];
+        int len;
+        if (kind == NumberKind::Tenths)
+        {
+            const int whole = key / 10;
+            const int frac = key < 0 ? -(key % 10) : key % 10;
+            len = std::snprintf(buf, sizeof(buf), "%s%s%d.%d%s", prefix,
+                                key < 0 && whole == 0 ? "-" : "", whole, frac, suffix);
+        }
+        else
+        {
+            len = std::snprintf(buf, sizeof(buf), "%s%d%s", prefix, key, suffix);
+        }
+        if (len < 0)
+            len = 0;
+
+        const bool changed = set(std::string_view(buf, std::min<std::size_t>(len, sizeof(buf) - 1)));
+        m_kind = kind;
+        m_key = key;
+        m_prefix = prefix;
+        m_suffix = suffix;
+        return changed;
+    }
+
+    void TextLabel::layout()
+    {
+        ++m_layouts;
+        m_quads.clear();
+
+        constexpr float invW = 1.0f / font::ATLAS_W;
+        constexpr float invH = 1.0f / font::ATLAS_H;
+        const SDL_Color white{255, 255, 255, 255};
+
+        int penX = 0, penY = 0, widest = 0;
+        for (char c : m_text)
+        {
+            if (c == '\n')
+            {
+                penX = 0;
+                penY += font::LINE_HEIGHT;
+                continue;
+            }
+            if (c != ' ') // no quad for blanks, just the advance
+            {
+                const int g = font::glyphIndex(c);
+                const float u0 = font::glyphAtlasX(g) * invW, u1 = (font::glyphAtlasX(g) + font::GLYPH_W) * invW;
+                const float v0 = font::glyphAtlasY(g) * invH, v1 = (font::glyphAtlasY(g) + font::GLYPH_H) * invH;
+                const float x0 = static_cast<float>(penX), x1 = x0 + font::GLYPH_W;
+                const float y0 = static_cast<float>(penY), y1 = y0 + font::GLYPH_H;
+
+                m_quads.push_back(SDL_Vertex{SDL_FPoint{x0, y0}, white, SDL_FPoint{u0, v0}});
+                m_quads.push_back(SDL_Vertex{SDL_FPoint{x1, y0}, white, SDL_FPoint{u1, v0}});
+                m_quads.push_back(SDL_Vertex{SDL_FPoint{x0, y1}, white, SDL_FPoint{u0, v1}});
+                m_quads.push_back(SDL_Vertex{SDL_FPoint{x1, y1}, white, SDL_FPoint{u1, v1}});
+            }
+            penX += font::ADVANCE;
+            if (penX - 1 > widest)
+                widest = penX - 1; // no trailing gap
+        }
+
+        m_width = widest;
+        m_height = m_text.empty() ? 0 : penY + font::GLYPH_H;
+    }
+
+    TextRenderer::TextRenderer(std::size_t reserveGlyphs)
+    {
+        m_vertices.reserve(reserveGlyphs * 4);
+        m_indices.reserve(reserveGlyphs * 6);
+    }
+
+    bool TextRenderer::createAtlas(SDL_Renderer* renderer)
+    {
+        releaseAtlas();
+        if (!renderer)
+            return false;
+
+        SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormat(0, font::ATLAS_W, font::ATLAS_H, 32,
+                                                              SDL_PIXELFORMAT_RGBA32);
+        if (!surface)
+            return false;
+
+        // white glyphs on transparent: vertex colours tint them
+        // (a fresh RGB surface never needs locking)
+        auto* pixels = static_cast<std::uint8_t*>(surface->pixels);
+        std::memset(pixels, 0, static_cast<std::size_t>(surface->pitch) * font::ATLAS_H);
+        for (int g = 0; g < font::COUNT; ++g)
+        {
+            const int ox = font::glyphAtlasX(g), oy = font::glyphAtlasY(g);
+            for (int row = 0; row < font::GLYPH_H; ++row)
+            {
+                std::uint8_t* line = pixels + static_cast<std::size_t>(oy + row) * surface->pitch;
+                for (int col = 0; col < font::GLYPH_W; ++col)
+                {
+                    if (font::GLYPHS[g][row] & (0x10 >> col))
+                        std::memset(line + (ox + col) * 4, 0xFF, 4);
+                }
+            }
+        }
+
+        m_atlas = SDL_CreateTextureFromSurface(renderer, surface);
+        SDL_FreeSurface(surface);
+        if (!m_atlas)
+            return false;
+
+        SDL_SetTextureBlendMode(m_atlas, SDL_BLENDMODE_BLEND);
+        SDL_SetTextureScaleMode(m_atlas, SDL_ScaleModeNearest);
+        return true;
+    }
+
+    void TextRenderer::releaseAtlas()
+    {
+        if (m_atlas)
+        {
+            SDL_DestroyTexture(m_atlas);
+            m_atlas = nullptr;
+        }
+    }
+
+    void TextRenderer::begin()
+    {
+        m_vertices.clear();
+    }
+
+    void TextRenderer::draw(const TextLabel& label, float x, float y, SDL_Color color)
+    {
+        for (const SDL_Vertex& v : label.m_quads)
+        {
+            m_vertices.push_back(SDL_Vertex{SDL_FPoint{v.position.x + x, v.position.y + y}, color, v.tex_coord});
+        }
+    }
+
+    void TextRenderer::drawShadowed(const TextLabel& label, float x, float y, SDL_Color color)
+    {
+        // drawn first, so it ends up under the text inside the batch
+        draw(label, x + 1.0f, y + 1.0f, SDL_Color{0, 0, 0, static_cast<Uint8>(color.a * 3 / 4)});
+        draw(label, x, y, color);
+    }
+
+    void TextRenderer::submit(RenderQueue& queue, DrawLayer layer)
+    {
+        const std::size_t quads = m_vertices.size() / 4;
+        if (!m_atlas || quads == 0)
+            return;
+
+        if (m_indices.size() < quads * 6)
+        {
+            for (std::size_t q = m_indices.size() / 6; q < quads; ++q)
+            {
+                const int v = static_cast<int>(q * 4);
+                const int quad[6] = {v, v + 1, v + 2, v + 2, v + 1, v + 3};
+                m_indices.insert(m_indices.end(), quad, quad + 6);
+            }
+        }
+
+        queue.geometry(layer, m_atlas, m_vertices.data(), static_cast<int>(quads * 4),
+                       m_indices.data(), static_cast<int>(quads * 6));
+    }
+}
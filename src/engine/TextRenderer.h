@@ -0,0 +1,104 @@
+#pragma once
+#include <SDL2/SDL.h>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+#include "RenderQueue.h"
+
+namespace zelda::game
+{
+    // A piece of text that keeps its own layout (BitmapFont.h).
+    //
+    // set() only lays the string out again when it differs from what the
+    // label already shows, and the number setters don't even format when
+    // the value is unchanged, so a HUD can push its values every frame and
+    // pay for a layout only on the frames where something moved.
+    //
+    // The layout is a list of glyph quads relative to the label's top
+    // left corner; TextRenderer copies them to wherever it's drawn.
+    // Storage is sized for maxChars up front and longer text is cut, so
+    // updating a label never allocates.
+    class TextLabel
+    {
+    public:
+        explicit TextLabel(std::size_t maxChars = 32);
+
+        // true if the text changed (and was laid out again). '\n' starts a new line.
+        bool set(std::string_view text);
+
+        // "<prefix><value><suffix>". prefix / suffix are compared by
+        // pointer, so pass string literals.
+        bool setNumber(const char* prefix, int value, const char* suffix = "");
+
+        // Same with one decimal ("12.5"); only tenths count as a change.
+        bool setTenths(const char* prefix, float value, const char* suffix = "");
+
+        std::string_view text() const { return m_text; }
+        int width() const  { return m_width; }  // px
+        int height() const { return m_height; } // px
+        std::size_t glyphCount() const { return m_quads.size() / 4; }
+        std::uint64_t layoutCount() const { return m_layouts; }
+
+    private:
+        friend class TextRenderer;
+
+        enum class NumberKind : std::uint8_t { None = 0, Whole, Tenths };
+        bool setFormatted(NumberKind kind, const char* prefix, int key, const char* suffix);
+        void layout();
+
+        std::size_t m_maxChars;
+        std::string m_text;
+        std::vector<SDL_Vertex> m_quads; // 4 per visible glyph, white, label space
+        int m_width = 0;
+        int m_height = 0;
+        std::uint64_t m_layouts = 0;
+
+        // last setNumber / setTenths arguments
+        const char* m_prefix = nullptr;
+        const char* m_suffix = nullptr;
+        int m_key = 0; // the value, or value * 10 for Tenths
+        NumberKind m_kind = NumberKind::None; // None = set() was used last
+    };
+
+    // Draws TextLabels out of one glyph atlas.
+    //
+    // The atlas is rasterised once from the built-in font (createAtlas);
+    // after that a frame of text is: begin(), draw() every label (a copy
+    // of its cached quads, moved and tinted), submit() = one geometry
+    // command for everything drawn. Vertices live here until the queue
+    // is flushed; storage is reused frame to frame.
+    //
+    // NOTE: the atlas belongs to the renderer. Call releaseAtlas() before
+    // the renderer is destroyed (same rule as TextureManager::clear()).
+    class TextRenderer
+    {
+    public:
+        explicit TextRenderer(std::size_t reserveGlyphs = 512);
+
+        // Build the atlas texture (false if the renderer can't; text is then skipped).
+        bool createAtlas(SDL_Renderer* renderer);
+        void releaseAtlas();
+        SDL_Texture* atlas() const { return m_atlas; }
+
+        void begin();
+
+        // Top left corner at (x, y), whole pixels keep the font crisp.
+        void draw(const TextLabel& label, float x, float y, SDL_Color color);
+
+        // Same, over a 1px dark drop shadow (still the same batch).
+        void drawShadowed(const TextLabel& label, float x, float y, SDL_Color color);
+
+        // Record everything drawn since begin() as one geometry command.
+        void submit(RenderQueue& queue, DrawLayer layer);
+
+        std::size_t glyphCount() const { return m_vertices.size() / 4; } // drawn since begin()
+
+    private:
+        SDL_Texture* m_atlas = nullptr;
+        std::vector<SDL_Vertex> m_vertices;
+        std::vector<int> m_indices; // 0 1 2 2 1 3, +4 per quad
+    };
+}
@@ -5,6 +5,8 @@
 #include <string>
 #include <unordered_map>
 
+#include "Log.h"
+
 namespace zelda::game
 {
     class TextureManager
@@ -26,15 +28,37 @@ namespace zelda::game
             SDL_Texture* tex = createTextureFromFile(path, renderer);
             if (!tex)
             {
-                SDL_Log("TextureManager: Failed to load '%s' for key '%s': %s",
-                        path.c_str(),
-                        key.c_str(),
-                        IMG_GetError());
+                ZLOG_ERROR("TextureManager: Failed to load '%s' for key '%s': %s",
+                           path.c_str(),
+                           key.c_str(),
+                           IMG_GetError());
+                return false;
+            }
+
+            m_textures[key] = tex;
+            ZLOG_INFO("TextureManager: Loaded '%s' as key '%s'", path.c_str(), key.c_str());
+            return true;
+        }
+
+        // Cache an already-decoded surface under a string key (no file I/O).
+        // Used for images decoded on a background thread. Surface stays owned by the caller.
+        bool loadTextureFromSurface(const std::string& key,
+                                    SDL_Surface* surface,
+                                    SDL_Renderer* renderer)
+        {
+            if (m_textures.find(key) != m_textures.end())
+                return true;
+
+            SDL_Texture* tex = SDL_CreateTextureFromSurface(renderer, surface);
+            if (!tex)
+            {
+                ZLOG_ERROR("TextureManager: Failed to upload surface for key '%s': %s",
+                           key.c_str(),
+                           SDL_GetError());
                 return false;
             }
 
             m_textures[key] = tex;
-            SDL_Log("TextureManager: Loaded '%s' as key '%s'", path.c_str(), key.c_str());
             return true;
         }
 
@@ -68,7 +92,7 @@ namespace zelda::game
             SDL_Surface* surface = IMG_Load(path.c_str());
             if (!surface)
             {
-                SDL_Log("IMG_Load failed for %s: %s", path.c_str(), IMG_GetError());
+                ZLOG_ERROR("IMG_Load failed for %s: %s", path.c_str(), IMG_GetError());
                 return nullptr;
             }
 
@@ -77,9 +101,9 @@ namespace zelda::game
 
             if (!texture)
             {
-                SDL_Log("SDL_CreateTextureFromSurface failed for %s: %s",
-                        path.c_str(),
-                        SDL_GetError());
+                ZLOG_ERROR("SDL_CreateTextureFromSurface failed for %s: %s",
+                           path.c_str(),
+                           SDL_GetError());
             }
 
             return texture;
@@ -0,0 +1,111 @@
+#include "TileBlockPool.h"
+
+#include <cstring>
+
+namespace zelda::game
+{
+    TileBlockPool::~TileBlockPool()
+    {
+        // maps are supposed to be gone first; free whatever is left anyway
+        for (auto& entry : m_index)
+            delete entry.second;
+    }
+
+    std::uint64_t TileBlockPool::hashTiles(const TileId* tiles)
+    {
+        // 8 bytes at a time, multiply-xorshift mix per word
+        static_assert(sizeof(TileId) * TileBlock::COUNT % sizeof(std::uint64_t) == 0, "block is whole words");
+        constexpr std::size_t WORDS = sizeof(TileId) * TileBlock::COUNT / sizeof(std::uint64_t);
+
+        std::uint64_t h = 0x9E3779B97F4A7C15ull;
+        for (std::size_t i = 0; i < WORDS; ++i)
+        {
+            std::uint64_t w;
+            std::memcpy(&w, reinterpret_cast<const unsigned char*>(tiles) + i * sizeof(w), sizeof(w));
+            h ^= w * 0xFF51AFD7ED558CCDull;
+            h = (h << 27 | h >> 37) * 0xC4CEB9FE1A85EC53ull;
+        }
+        return h ^ (h >> 33);
+    }
+
+    TileBlock* TileBlockPool::create(TileId fill)
+    {
+        TileBlock* block = new TileBlock();
+        block->tiles.fill(fill);
+        block->refs = 1;
+        ++m_privateBlocks;
+        return block;
+    }
+
+    TileBlock* TileBlockPool::share(TileBlock* block)
+    {
+        if (!block || block->shared)
+            return block;
+
+        const std::uint64_t hash = hashTiles(block->tiles.data());
+        auto range = m_index.equal_range(hash);
+        for (auto it = range.first; it != range.second; ++it)
+        {
+            TileBlock* existing = it->second;
+            if (existing->tiles == block->tiles)
+            {
+                existing->refs += block->refs;
+                m_sharedRefs += block->refs;
+                --m_privateBlocks;
+                delete block;
+                return existing;
+            }
+        }
+
+        // first of its kind: this block becomes the shared one
+        block->hash = hash;
+        block->shared = true;
+        m_index.emplace(hash, block);
+        m_sharedRefs += block->refs;
+        --m_privateBlocks;
+        return block;
+    }
+
+    TileBlock* TileBlockPool::makeWritable(TileBlock* block)
+    {
+        if (!block->shared)
+            return block;
+
+        TileBlock* copy = new TileBlock();
+        copy->tiles = block->tiles;
+        copy->refs = 1;
+        ++m_privateBlocks;
+        ++m_copies;
+
+        release(block);
+        return copy;
+    }
+
+    void TileBlockPool::release(TileBlock* block)
+    {
+        if (!block)
+            return;
+
+        if (!block->shared)
+        {
+            --m_privateBlocks;
+            delete block;
+            return;
+        }
+
+        --m_sharedRefs;
+        if (--block->refs > 0)
+            return;
+
+        auto range = m_index.equal_range(block->hash);
+        for (auto it = range.first; it != range.second; ++it)
+        {
+            if (it->second == block)
+            {
+                m_index.erase(it);
+                break;
+            }
+        }
+        delete block;
+    }
+}
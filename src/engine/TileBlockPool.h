@@ -0,0 +1,79 @@
+#pragma once
+#include <array>
+#include <memory>
+#include <unordered_map>
+#include <cstdint>
+#include <cstddef>
+
+namespace zelda::game
+{
+    using TileId = std::int16_t;
+
+    // One chunk worth of tile ids (TileMap::CHUNK_TILES squared).
+    struct TileBlock
+    {
+        static constexpr int SIDE  = 32;
+        static constexpr int COUNT = SIDE * SIDE;
+
+        std::array<TileId, COUNT> tiles;
+
+        std::uint64_t hash = 0;  // content hash, valid while shared
+        std::uint32_t refs = 0;  // chunks pointing here
+        bool shared = false;     // in the pool's index: immutable, copy before writing
+    };
+
+    // Content-addressed store of tile blocks.
+    //
+    // Rooms built from the same template end up with identical chunks;
+    // share() hands out one refcounted block per distinct content instead
+    // of a copy per room. Shared blocks are immutable: a map that wants to
+    // write into one takes a private copy first (makeWritable()), so edits
+    // never leak into the other rooms.
+    //
+    // Not thread-safe. Rooms are installed on the main thread, and each
+    // World (RoomManager) has its own pool.
+    class TileBlockPool
+    {
+    public:
+        TileBlockPool() = default;
+        ~TileBlockPool();
+
+        TileBlockPool(const TileBlockPool&) = delete;
+        TileBlockPool& operator=(const TileBlockPool&) = delete;
+
+        // New private block with every tile = fill (refs = 1).
+        TileBlock* create(TileId fill);
+
+        // Trade a private block for the shared block with the same content.
+        // Either an existing one (the private block is freed) or `block`
+        // itself, which becomes shared. refs carry over.
+        TileBlock* share(TileBlock* block);
+
+        // Block the caller may write to: `block` itself if private, else a
+        // private copy (and the caller's reference to the shared one is dropped).
+        TileBlock* makeWritable(TileBlock* block);
+
+        // Drop one reference; the block is freed with the last one.
+        void release(TileBlock* block);
+
+        // --- stats ---
+        std::size_t sharedBlocks() const      { return m_index.size(); }
+        std::size_t privateBlocks() const     { return m_privateBlocks; }
+        std::uint64_t sharedRefs() const      { return m_sharedRefs; }  // chunks using a shared block
+        std::uint64_t copiesOnWrite() const   { return m_copies; }
+
+        // bytes of tile data actually held (shared + private blocks)
+        std::size_t bytes() const { return (m_index.size() + m_privateBlocks) * sizeof(TileBlock); }
+        // what unshared chunks would have needed on top of that
+        std::size_t bytesSaved() const { return (m_sharedRefs - m_index.size()) * sizeof(TileBlock); }
+
+        static std::uint64_t hashTiles(const TileId* tiles);
+
+    private:
+        // hash -> blocks with that hash (collisions just chain)
+        std::unordered_multimap<std::uint64_t, TileBlock*> m_index;
+        std::size_t m_privateBlocks = 0;
+        std::uint64_t m_sharedRefs = 0;
+        std::uint64_t m_copies = 0;
+    };
+}
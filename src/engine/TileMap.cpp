@@ -0,0 +1,749 @@
+#include "TileMap.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define ZELDA_COLLISION_SSE2 1
+#endif
+
+namespace zelda::game
+{
+    namespace
+    {
+        // wall stamps are unique across every map. Maps are only built and
+        // edited on their world's thread (installRoom runs on the main
+        // thread, the prefetcher just parses files), but batch runs step
+        // worlds on several threads at once.
+        std::atomic<std::uint64_t> g_wallStamps{0};
+
+        std::uint64_t nextWallStamp()
+        {
+            return g_wallStamps.fetch_add(1, std::memory_order_relaxed) + 1;
+        }
+
+        // bits from .. from + count - 1 of a packed line of `length` bits;
+        // past either end reads as set (solid)
+        std::uint64_t bitRun(const std::uint64_t* line, int length, int from, int count)
+        {
+            const std::uint64_t all = count >= 64 ? ~0ull : (1ull << count) - 1;
+            const int a = from > 0 ? from : 0;
+            const int b = from + count < length ? from + count : length;
+            if (a >= b)
+                return all;
+
+            // may straddle two words
+            const int word = a >> 6, shift = a & 63;
+            std::uint64_t bits = line[word] >> shift;
+            if (shift && b > (word + 1) * 64)
+                bits |= line[word + 1] << (64 - shift);
+            const std::uint64_t inside = b - a >= 64 ? ~0ull : (1ull << (b - a)) - 1;
+            return (all & ~(inside << (a - from))) | ((bits & inside) << (a - from));
+        }
+
+        void setBit(std::uint64_t* line, int bit, bool on)
+        {
+            std::uint64_t& word = line[bit >> 6];
+            word = (word & ~(1ull << (bit & 63))) | (static_cast<std::uint64_t>(on) << (bit & 63));
+        }
+    }
+
+    TileMap::TileMap()
+    : m_w(0)
+    , m_h(0)
+    , m_chunksX(0)
+    , m_chunksY(0)
+    {
+        m_layers[static_cast<int>(TileLayer::Floor)].fill      = 0;
+        m_layers[static_cast<int>(TileLayer::Decoration)].fill = EMPTY_TILE;
+        m_layers[static_cast<int>(TileLayer::Collision)].fill  = 0;
+        m_layers[static_cast<int>(TileLayer::Overlay)].fill    = EMPTY_TILE;
+    }
+
+    TileMap::TileMap(int w, int h, const std::vector<int>& tiles)
+    : TileMap()
+    {
+        load(w, h, tiles);
+    }
+
+    TileMap::TileMap(TileMap&& other) noexcept
+    : TileMap()
+    {
+        *this = std::move(other);
+    }
+
+    TileMap::~TileMap()
+    {
+        releaseRenderCache();
+    }
+
+    TileMap& TileMap::operator=(TileMap&& other) noexcept
+    {
+        if (this == &other)
+            return *this;
+
+        // release our textures and blocks while the pool they came from is still ours
+        releaseRenderCache();
+        for (auto& layer : m_layers)
+            layer.chunks.clear();
+
+        m_w = other.m_w;
+        m_h = other.m_h;
+        m_chunksX = other.m_chunksX;
+        m_chunksY = other.m_chunksY;
+        m_pool = other.m_pool;
+        m_ownPool = std::move(other.m_ownPool);
+        m_layers = std::move(other.m_layers);
+        for (auto& layer : other.m_layers)
+            layer.fillCache = nullptr; // ours now
+        m_arena = other.m_arena;
+        m_solid = std::move(other.m_solid);
+        m_solidStride = other.m_solidStride;
+        m_solidBits = std::move(other.m_solidBits);
+        m_solidBitsT = std::move(other.m_solidBitsT);
+        m_solidBitsStride = other.m_solidBitsStride;
+        m_solidBitsTStride = other.m_solidBitsTStride;
+        m_wallStamp = other.m_wallStamp;
+        m_neighbors = std::move(other.m_neighbors);
+        m_chunkRedraws = other.m_chunkRedraws;
+        return *this;
+    }
+
+    void TileMap::create(int w, int h)
+    {
+        // old textures would otherwise leak (they are sized per chunk, not per map)
+        releaseRenderCache();
+
+        m_w = std::max(0, w);
+        m_h = std::max(0, h);
+        m_chunksX = (m_w + CHUNK_TILES - 1) / CHUNK_TILES;
+        m_chunksY = (m_h + CHUNK_TILES - 1) / CHUNK_TILES;
+
+        for (auto& layer : m_layers)
+        {
+            layer.chunks = ArenaVector<ChunkPtr>(static_cast<std::size_t>(m_chunksX) * m_chunksY,
+                                                 ArenaAllocator<ChunkPtr>(m_arena));
+        }
+
+        // solid border, interior = collision fill
+        const std::uint8_t fillSolid = tileIsSolid(m_layers[static_cast<int>(TileLayer::Collision)].fill);
+        m_solidStride = m_w + 2;
+        m_solid = ArenaVector<std::uint8_t>(static_cast<std::size_t>(m_solidStride) * (m_h + 2), 1,
+                                            ArenaAllocator<std::uint8_t>(m_arena));
+        for (int ty = 0; ty < m_h; ++ty)
+            std::fill_n(m_solid.begin() + solidIndex(0, ty), m_w, fillSolid);
+
+        m_solidBitsStride = (m_w + 63) / 64;
+        m_solidBitsTStride = (m_h + 63) / 64;
+        m_solidBits = ArenaVector<std::uint64_t>(static_cast<std::size_t>(m_solidBitsStride) * m_h, 0,
+                                                 ArenaAllocator<std::uint64_t>(m_arena));
+        m_solidBitsT = ArenaVector<std::uint64_t>(static_cast<std::size_t>(m_solidBitsTStride) * m_w, 0,
+                                                  ArenaAllocator<std::uint64_t>(m_arena));
+        if (fillSolid)
+        {
+            for (int ty = 0; ty < m_h; ++ty)
+                for (int tx = 0; tx < m_w; ++tx)
+                {
+                    setBit(m_solidBits.data() + static_cast<std::size_t>(ty) * m_solidBitsStride, tx, true);
+                    setBit(m_solidBitsT.data() + static_cast<std::size_t>(tx) * m_solidBitsTStride, ty, true);
+                }
+        }
+        m_wallStamp = nextWallStamp();
+
+        m_neighbors = ArenaVector<std::uint8_t>(static_cast<std::size_t>(m_w) * m_h, 0,
+                                                ArenaAllocator<std::uint8_t>(m_arena));
+        computeNeighborRows(0, m_h);
+    }
+
+    void TileMap::computeNeighborRows(int ty0, int ty1)
+    {
+        // Whole rows at a time from the bordered solid grid (0 / 1 per tile,
+        // so every neighbour lands in its own bit without carries).
+        const int w = m_w;
+        for (int ty = ty0; ty < ty1; ++ty)
+        {
+            const std::uint8_t* up   = m_solid.data() + solidIndex(0, ty - 1);
+            const std::uint8_t* row  = m_solid.data() + solidIndex(0, ty);
+            const std::uint8_t* down = m_solid.data() + solidIndex(0, ty + 1);
+            std::uint8_t* out = m_neighbors.data() + static_cast<std::size_t>(ty) * w;
+
+            int tx = 0;
+#if defined(ZELDA_COLLISION_SSE2)
+            // 16 tiles per step; 16-bit shifts are fine, nothing crosses a byte
+            for (; tx + 16 <= w; tx += 16)
+            {
+                const __m128i n = _mm_loadu_si128(reinterpret_cast<const __m128i*>(up + tx));
+                const __m128i e = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + tx + 1));
+                const __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(down + tx));
+                const __m128i west = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + tx - 1));
+                const __m128i mask = _mm_or_si128(_mm_or_si128(n, _mm_slli_epi16(e, 1)),
+                                                  _mm_or_si128(_mm_slli_epi16(s, 2), _mm_slli_epi16(west, 3)));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out + tx), mask);
+            }
+#endif
+            for (; tx < w; ++tx)
+            {
+                out[tx] = static_cast<std::uint8_t>(up[tx] | (row[tx + 1] << 1) | (down[tx] << 2) |
+                                                    (row[tx - 1] << 3));
+            }
+        }
+    }
+
+    void TileMap::updateNeighborsOf(int tx, int ty)
+    {
+        const int dx[4] = {0, 1, 0, -1};
+        const int dy[4] = {-1, 0, 1, 0};
+        for (int d = 0; d < 4; ++d)
+        {
+            const int nx = tx + dx[d], ny = ty + dy[d];
+            if (nx < 0 || ny < 0 || nx >= m_w || ny >= m_h)
+                continue;
+            // the neighbour sees us from the opposite side
+            const std::uint8_t bit = static_cast<std::uint8_t>(1u << ((d + 2) & 3));
+            std::uint8_t& mask = m_neighbors[static_cast<std::size_t>(ny) * m_w + nx];
+            mask = static_cast<std::uint8_t>((mask & ~bit) | (m_solid[solidIndex(tx, ty)] ? bit : 0));
+            markDirtyAt(nx, ny);
+        }
+    }
+
+    void TileMap::markDirtyAt(int tx, int ty)
+    {
+        for (auto& layer : m_layers)
+            if (Chunk* c = layer.chunks[chunkIndex(tx, ty)].get())
+                c->dirty = true;
+    }
+
+    void TileMap::load(int w, int h, const std::vector<int>& tiles)
+    {
+        create(w, h);
+
+        // safety fallback if caller passed wrong size: missing tiles stay floor
+        const int count = std::min(static_cast<int>(tiles.size()), m_w * m_h);
+        m_loading = true;
+        for (int i = 0; i < count; ++i)
+        {
+            int tx = i % m_w;
+            int ty = i / m_w;
+            setTile(TileLayer::Floor, tx, ty, tiles[i]);
+            if (tileIsSolid(tiles[i]))
+                setTile(TileLayer::Collision, tx, ty, tiles[i]);
+        }
+        m_loading = false;
+        computeNeighborRows(0, m_h);
+
+        share();
+    }
+
+    void TileMap::solidRows(int tx, int ty, int width, int count, std::uint64_t* out) const
+    {
+        for (int i = 0; i < count; ++i)
+        {
+            const int y = ty + i;
+            out[i] = y >= 0 && y < m_h
+                         ? bitRun(m_solidBits.data() + static_cast<std::size_t>(y) * m_solidBitsStride, m_w, tx, width)
+                         : bitRun(nullptr, 0, tx, width);
+        }
+    }
+
+    void TileMap::solidColumns(int tx, int ty, int height, int count, std::uint64_t* out) const
+    {
+        for (int j = 0; j < count; ++j)
+        {
+            const int x = tx + j;
+            out[j] = x >= 0 && x < m_w
+                         ? bitRun(m_solidBitsT.data() + static_cast<std::size_t>(x) * m_solidBitsTStride, m_h, ty, height)
+                         : bitRun(nullptr, 0, ty, height);
+        }
+    }
+
+    TileBlockPool& TileMap::blockPool()
+    {
+        if (m_pool)
+            return *m_pool;
+        if (!m_ownPool)
+            m_ownPool = std::make_unique<TileBlockPool>();
+        return *m_ownPool;
+    }
+
+    void TileMap::share()
+    {
+        for (auto& layer : m_layers)
+        {
+            for (auto& c : layer.chunks)
+            {
+                if (c && !c->block->shared)
+                    c->block = c.get_deleter().pool->share(c->block);
+            }
+        }
+    }
+
+    void TileMap::setTile(TileLayer layer, int tx, int ty, int id)
+    {
+        if (tx < 0 || ty < 0 || tx >= m_w || ty >= m_h)
+            return;
+        // would wrap into some other tile id in the block
+        const bool fits = id >= std::numeric_limits<TileId>::min() && id <= std::numeric_limits<TileId>::max();
+        assert(fits && "tile id out of TileId range");
+        if (!fits)
+            return;
+
+        if (layer == TileLayer::Collision)
+        {
+            std::uint8_t& solid = m_solid[solidIndex(tx, ty)];
+            const std::uint8_t now = tileIsSolid(id);
+            if (solid != now)
+            {
+                solid = now;
+                setBit(m_solidBits.data() + static_cast<std::size_t>(ty) * m_solidBitsStride, tx, now);
+                setBit(m_solidBitsT.data() + static_cast<std::size_t>(tx) * m_solidBitsTStride, ty, now);
+                if (!m_loading)
+                {
+                    updateNeighborsOf(tx, ty);
+                    m_wallStamp = nextWallStamp();
+                }
+            }
+        }
+
+        Layer& l = m_layers[static_cast<int>(layer)];
+        ChunkPtr& slot = l.chunks[chunkIndex(tx, ty)];
+        if (!slot)
+        {
+            // writing the fill into an implicit chunk changes nothing
+            if (id == l.fill)
+                return;
+
+            TileBlockPool& pool = blockPool();
+            if (m_arena)
+                slot = ChunkPtr(m_arena->make<Chunk>(), ChunkDeleter{false, &pool});
+            else
+                slot = ChunkPtr(new Chunk(), ChunkDeleter{true, &pool});
+            slot->block = pool.create(static_cast<TileId>(l.fill));
+        }
+
+        const int local = localIndex(tx, ty);
+        if (slot->block->tiles[local] == static_cast<TileId>(id))
+            return;
+
+        // other rooms may be looking at this block: write to our own copy
+        slot->block = slot.get_deleter().pool->makeWritable(slot->block);
+        slot->block->tiles[local] = static_cast<TileId>(id);
+        slot->dirty = true;
+    }
+
+    const char* TileMap::collisionKernelName()
+    {
+#if defined(ZELDA_COLLISION_SSE2)
+        return "SSE2";
+#else
+        return "scalar";
+#endif
+    }
+
+    void TileMap::rectsCollideSolid(const SDL_Rect* rects, std::size_t count, std::uint64_t* hitMask) const
+    {
+        static_assert(TILE_SIZE == 16, "batch collision shifts by 4 to divide by TILE_SIZE");
+
+        std::fill_n(hitMask, (count + 63) / 64, std::uint64_t{0});
+        if (m_w == 0 || m_h == 0)
+        {
+            // empty map: everything is out of bounds, i.e. solid (unless the rect is empty)
+            for (std::size_t i = 0; i < count; ++i)
+                if (rects[i].w > 0 && rects[i].h > 0)
+                    hitMask[i / 64] |= std::uint64_t{1} << (i % 64);
+            return;
+        }
+
+        const std::uint8_t* solid = m_solid.data();
+
+        // Tile range per rect, 4 rects at a time: [x0, x1] x [y0, y1],
+        // clamped into the border so no lookup needs a bounds check.
+        // Empty ranges (x1 < x0) are flagged before clamping.
+        alignas(16) std::int32_t tx0[4], tx1[4], ty0[4], ty1[4], empty[4];
+
+        std::size_t i = 0;
+        while (i < count)
+        {
+            const std::size_t n = std::min<std::size_t>(4, count - i);
+#if defined(ZELDA_COLLISION_SSE2)
+            if (n == 4)
+            {
+                static_assert(sizeof(SDL_Rect) == 16, "SDL_Rect is 4 ints");
+                // AoS {x, y, w, h} x 4 -> SoA x / y / w / h
+                __m128i r0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rects + i));
+                __m128i r1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rects + i + 1));
+                __m128i r2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rects + i + 2));
+                __m128i r3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rects + i + 3));
+                __m128i t0 = _mm_unpacklo_epi32(r0, r1); // x0 x1 y0 y1
+                __m128i t1 = _mm_unpacklo_epi32(r2, r3); // x2 x3 y2 y3
+                __m128i t2 = _mm_unpackhi_epi32(r0, r1); // w0 w1 h0 h1
+                __m128i t3 = _mm_unpackhi_epi32(r2, r3); // w2 w3 h2 h3
+                __m128i x = _mm_unpacklo_epi64(t0, t1);
+                __m128i y = _mm_unpackhi_epi64(t0, t1);
+                __m128i w = _mm_unpacklo_epi64(t2, t3);
+                __m128i h = _mm_unpackhi_epi64(t2, t3);
+
+                const __m128i one = _mm_set1_epi32(1);
+                const __m128i fifteen = _mm_set1_epi32(TILE_SIZE - 1);
+
+                // v / 16 rounding toward zero, like the scalar `/`
+                auto tileOf = [&](__m128i v) {
+                    __m128i bias = _mm_and_si128(_mm_srai_epi32(v, 31), fifteen);
+                    return _mm_srai_epi32(_mm_add_epi32(v, bias), 4);
+                };
+                __m128i ax0 = tileOf(x);
+                __m128i ax1 = tileOf(_mm_sub_epi32(_mm_add_epi32(x, w), one));
+                __m128i ay0 = tileOf(y);
+                __m128i ay1 = tileOf(_mm_sub_epi32(_mm_add_epi32(y, h), one));
+
+                __m128i isEmpty = _mm_or_si128(_mm_cmplt_epi32(ax1, ax0), _mm_cmplt_epi32(ay1, ay0));
+
+                // clamp to [-1, size] (SSE2 has no min/max_epi32)
+                auto clamp = [](__m128i v, __m128i lo, __m128i hi) {
+                    __m128i below = _mm_cmplt_epi32(v, lo);
+                    v = _mm_or_si128(_mm_and_si128(below, lo), _mm_andnot_si128(below, v));
+                    __m128i above = _mm_cmpgt_epi32(v, hi);
+                    return _mm_or_si128(_mm_and_si128(above, hi), _mm_andnot_si128(above, v));
+                };
+                const __m128i lo = _mm_set1_epi32(-1);
+                const __m128i hiX = _mm_set1_epi32(m_w);
+                const __m128i hiY = _mm_set1_epi32(m_h);
+                _mm_store_si128(reinterpret_cast<__m128i*>(tx0), clamp(ax0, lo, hiX));
+                _mm_store_si128(reinterpret_cast<__m128i*>(tx1), clamp(ax1, lo, hiX));
+                _mm_store_si128(reinterpret_cast<__m128i*>(ty0), clamp(ay0, lo, hiY));
+                _mm_store_si128(reinterpret_cast<__m128i*>(ty1), clamp(ay1, lo, hiY));
+                _mm_store_si128(reinterpret_cast<__m128i*>(empty), isEmpty);
+            }
+            else
+#endif
+            {
+                for (std::size_t k = 0; k < n; ++k)
+                {
+                    const SDL_Rect& r = rects[i + k];
+                    const int x0 = r.x / TILE_SIZE;
+                    const int x1 = (r.x + r.w - 1) / TILE_SIZE;
+                    const int y0 = r.y / TILE_SIZE;
+                    const int y1 = (r.y + r.h - 1) / TILE_SIZE;
+                    empty[k] = (x1 < x0 || y1 < y0);
+                    tx0[k] = std::clamp(x0, -1, m_w);
+                    tx1[k] = std::clamp(x1, -1, m_w);
+                    ty0[k] = std::clamp(y0, -1, m_h);
+                    ty1[k] = std::clamp(y1, -1, m_h);
+                }
+            }
+
+            for (std::size_t k = 0; k < n; ++k)
+            {
+                if (empty[k])
+                    continue;
+
+                const int spanX = tx1[k] - tx0[k];
+                const int spanY = ty1[k] - ty0[k];
+                const std::uint8_t* row = solid + solidIndex(tx0[k], ty0[k]);
+                bool hit;
+                if (spanX <= 1 && spanY <= 1)
+                {
+                    // entity-sized: at most 2x2 tiles, four branch-free loads
+                    const int dy = spanY * m_solidStride;
+                    hit = (row[0] | row[spanX] | row[dy] | row[dy + spanX]) != 0;
+                }
+                else
+                {
+                    hit = false;
+                    for (int ty = 0; ty <= spanY && !hit; ++ty, row += m_solidStride)
+                        for (int tx = 0; tx <= spanX; ++tx)
+                            hit |= row[tx] != 0;
+                }
+
+                if (hit)
+                    hitMask[(i + k) / 64] |= std::uint64_t{1} << ((i + k) % 64);
+            }
+            i += n;
+        }
+    }
+
+    void TileMap::movesCollideSolid(const SDL_Rect* rects, const SDL_Point* deltas, std::size_t count,
+                                    std::uint64_t* hitMask) const
+    {
+        // build swept boxes 64 at a time on the stack, then run the rect kernel
+        SDL_Rect swept[64];
+        for (std::size_t base = 0; base < count; base += 64)
+        {
+            const std::size_t n = std::min<std::size_t>(64, count - base);
+            for (std::size_t k = 0; k < n; ++k)
+            {
+                const SDL_Rect& r = rects[base + k];
+                const SDL_Point& d = deltas[base + k];
+                swept[k] = SDL_Rect{
+                    d.x < 0 ? r.x + d.x : r.x,
+                    d.y < 0 ? r.y + d.y : r.y,
+                    r.w + (d.x < 0 ? -d.x : d.x),
+                    r.h + (d.y < 0 ? -d.y : d.y)};
+            }
+            // base is a multiple of 64, so this fills exactly one mask word
+            rectsCollideSolid(swept, n, hitMask + base / 64);
+        }
+    }
+
+    std::size_t TileMap::allocatedChunkCount() const
+    {
+        std::size_t count = 0;
+        for (const auto& layer : m_layers)
+            for (const auto& c : layer.chunks)
+                if (c)
+                    ++count;
+        return count;
+    }
+
+    std::size_t TileMap::sharedChunkCount() const
+    {
+        std::size_t count = 0;
+        for (const auto& layer : m_layers)
+            for (const auto& c : layer.chunks)
+                if (c && c->block->shared)
+                    ++count;
+        return count;
+    }
+
+    std::size_t TileMap::memoryBytes() const
+    {
+        std::size_t bytes = sizeof(*this);
+        for (const auto& layer : m_layers)
+        {
+            bytes += layer.chunks.capacity() * sizeof(ChunkPtr);
+            for (const auto& c : layer.chunks)
+            {
+                if (!c)
+                    continue;
+                bytes += sizeof(Chunk);
+                bytes += c->block->shared ? sizeof(TileBlock) / c->block->refs : sizeof(TileBlock);
+            }
+        }
+        bytes += m_solid.capacity();
+        bytes += (m_solidBits.capacity() + m_solidBitsT.capacity()) * sizeof(std::uint64_t);
+        bytes += m_neighbors.capacity();
+        return bytes;
+    }
+
+    void TileMap::releaseRenderCache()
+    {
+        for (auto& layer : m_layers)
+        {
+            for (auto& c : layer.chunks)
+            {
+                if (c && c->cache)
+                {
+                    SDL_DestroyTexture(c->cache);
+                    c->cache = nullptr;
+                    c->dirty = true;
+                }
+            }
+            if (layer.fillCache)
+            {
+                SDL_DestroyTexture(layer.fillCache);
+                layer.fillCache = nullptr;
+            }
+        }
+    }
+
+    SDL_Texture* TileMap::createChunkTexture(SDL_Renderer* renderer)
+    {
+        SDL_Texture* tex = SDL_CreateTexture(
+            renderer,
+            SDL_PIXELFORMAT_RGBA8888,
+            SDL_TEXTUREACCESS_TARGET,
+            CHUNK_PIXELS,
+            CHUNK_PIXELS);
+        if (tex)
+            SDL_SetTextureBlendMode(tex, SDL_BLENDMODE_BLEND);
+        return tex;
+    }
+
+    void TileMap::drawTile(SDL_Renderer* renderer, SDL_Texture* tilesTex, int tileId, std::uint8_t neighbors,
+                           const SDL_Rect& dst)
+    {
+        if (tileFlags(tileId) & TILE_NONE)
+            return;
+
+        if (!tilesTex)
+        {
+            // fallback debug colors if texture didn't load
+            const SDL_Color c = tileType(tileId).debugColor;
+            SDL_SetRenderDrawColor(renderer, c.r, c.g, c.b, c.a);
+            SDL_RenderFillRect(renderer, &dst);
+            return;
+        }
+
+        SDL_Rect src = atlasRectFor(tileId, neighbors);
+        SDL_RenderCopy(renderer, tilesTex, &src, &dst);
+    }
+
+    void TileMap::rasterizeChunk(SDL_Renderer* renderer,
+                                 SDL_Texture* tilesTex,
+                                 SDL_Texture* target,
+                                 const Chunk* chunk,
+                                 int fill,
+                                 int chunkX,
+                                 int chunkY) const
+    {
+        SDL_Texture* prevTarget = SDL_GetRenderTarget(renderer);
+        SDL_SetRenderTarget(renderer, target);
+        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0);
+        SDL_RenderClear(renderer);
+
+        // edge chunks: don't draw past the map border
+        // (the shared fill texture is always rasterised in full)
+        const bool sharedFill = !chunk;
+        const int tilesW = sharedFill ? CHUNK_TILES : std::min(CHUNK_TILES, m_w - chunkX * CHUNK_TILES);
+        const int tilesH = sharedFill ? CHUNK_TILES : std::min(CHUNK_TILES, m_h - chunkY * CHUNK_TILES);
+
+        // the shared fill texture stands for any chunk: draw it as interior
+        constexpr std::uint8_t interior = TILE_N | TILE_E | TILE_S | TILE_W;
+
+        for (int ly = 0; ly < tilesH; ++ly)
+        {
+            const std::uint8_t* neighbors =
+                sharedFill ? nullptr
+                           : m_neighbors.data() + static_cast<std::size_t>(chunkY * CHUNK_TILES + ly) * m_w +
+                                 chunkX * CHUNK_TILES;
+            for (int lx = 0; lx < tilesW; ++lx)
+            {
+                int tileId = chunk ? chunk->block->tiles[ly * CHUNK_TILES + lx] : fill;
+                SDL_Rect dst{lx * TILE_SIZE, ly * TILE_SIZE, TILE_SIZE, TILE_SIZE};
+                drawTile(renderer, tilesTex, tileId, neighbors ? neighbors[lx] : interior, dst);
+            }
+        }
+
+        SDL_SetRenderTarget(renderer, prevTarget);
+    }
+
+    void TileMap::queueChunkTiles(RenderQueue& queue,
+                                  DrawLayer drawLayer,
+                                  SDL_Texture* tilesTex,
+                                  const Chunk* chunk,
+                                  int fill,
+                                  int chunkX,
+                                  int chunkY,
+                                  int originX,
+                                  int originY) const
+    {
+        // renderer can't do render targets: every tile is its own command
+        const int tilesW = std::min(CHUNK_TILES, m_w - chunkX * CHUNK_TILES);
+        const int tilesH = std::min(CHUNK_TILES, m_h - chunkY * CHUNK_TILES);
+
+        for (int ly = 0; ly < tilesH; ++ly)
+        {
+            const std::uint8_t* neighbors =
+                m_neighbors.data() + static_cast<std::size_t>(chunkY * CHUNK_TILES + ly) * m_w + chunkX * CHUNK_TILES;
+            for (int lx = 0; lx < tilesW; ++lx)
+            {
+                int tileId = chunk ? chunk->block->tiles[ly * CHUNK_TILES + lx] : fill;
+                if (tileFlags(tileId) & TILE_NONE)
+                    continue;
+
+                SDL_Rect dst{
+                    originX + lx * TILE_SIZE,
+                    originY + ly * TILE_SIZE,
+                    TILE_SIZE,
+                    TILE_SIZE};
+                if (tilesTex)
+                {
+                    SDL_Rect src = atlasRectFor(tileId, neighbors[lx]);
+                    queue.copy(drawLayer, tilesTex, &src, dst);
+                }
+                else
+                {
+                    // fallback debug colors if texture didn't load
+                    queue.fillRect(drawLayer, dst, tileType(tileId).debugColor);
+                }
+            }
+        }
+    }
+
+    void TileMap::renderLayer(RenderQueue& queue,
+                              DrawLayer drawLayer,
+                              SDL_Texture* tilesTex,
+                              TileLayer layer,
+                              const SDL_Rect& view,
+                              int offsetX,
+                              int offsetY)
+    {
+        Layer& l = m_layers[static_cast<int>(layer)];
+        SDL_Renderer* renderer = queue.renderer();
+
+        if (m_chunksX == 0 || m_chunksY == 0)
+            return;
+
+        const int mapPxW = m_w * TILE_SIZE;
+        const int mapPxH = m_h * TILE_SIZE;
+
+        // visible chunk range (view is in map pixels)
+        int cx0 = std::max(0, view.x / CHUNK_PIXELS);
+        int cy0 = std::max(0, view.y / CHUNK_PIXELS);
+        int cx1 = std::min(m_chunksX - 1, (view.x + view.w - 1) / CHUNK_PIXELS);
+        int cy1 = std::min(m_chunksY - 1, (view.y + view.h - 1) / CHUNK_PIXELS);
+
+        for (int cy = cy0; cy <= cy1; ++cy)
+        {
+            for (int cx = cx0; cx <= cx1; ++cx)
+            {
+                const int chunkPxX = cx * CHUNK_PIXELS;
+                const int chunkPxY = cy * CHUNK_PIXELS;
+
+                // edge chunks hang over the map border; only blit the inside
+                SDL_Rect src{
+                    0,
+                    0,
+                    std::min(CHUNK_PIXELS, mapPxW - chunkPxX),
+                    std::min(CHUNK_PIXELS, mapPxH - chunkPxY)};
+                SDL_Rect dst{
+                    chunkPxX - view.x + offsetX,
+                    chunkPxY - view.y + offsetY,
+                    src.w,
+                    src.h};
+
+                Chunk* chunk = l.chunks[cy * m_chunksX + cx].get();
+                SDL_Texture* tex = nullptr;
+
+                if (!chunk)
+                {
+                    if (l.fill == EMPTY_TILE)
+                        continue;
+
+                    if (!l.fillCache)
+                    {
+                        l.fillCache = createChunkTexture(renderer);
+                        if (l.fillCache)
+                        {
+                            rasterizeChunk(renderer, tilesTex, l.fillCache, nullptr, l.fill, cx, cy);
+                            ++m_chunkRedraws;
+                        }
+                    }
+                    tex = l.fillCache;
+                }
+                else
+                {
+                    if (!chunk->cache)
+                    {
+                        chunk->cache = createChunkTexture(renderer);
+                        chunk->dirty = true;
+                    }
+                    if (chunk->cache && chunk->dirty)
+                    {
+                        rasterizeChunk(renderer, tilesTex, chunk->cache, chunk, l.fill, cx, cy);
+                        chunk->dirty = false;
+                        ++m_chunkRedraws;
+                    }
+                    tex = chunk->cache;
+                }
+
+                if (tex)
+                    queue.copy(drawLayer, tex, &src, dst);
+                else
+                    queueChunkTiles(queue, drawLayer, tilesTex, chunk, l.fill, cx, cy, dst.x, dst.y);
+            }
+        }
+    }
+}
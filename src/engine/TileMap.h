@@ -1,45 +1,172 @@
 #pragma once
 #include <vector>
+#include <array>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
 #include <SDL2/SDL.h>
 
+#include "Arena.h"
+#include "RenderQueue.h"
+#include "TileBlockPool.h"
+#include "TileTypes.h"
+
 namespace zelda::game
 {
+    // Every room is made of a few stacked layers.
+    // Floor + Decoration are drawn under entities, Overlay is drawn on top,
+    // Collision is never drawn (it only says what blocks movement).
+    enum class TileLayer : int
+    {
+        Floor = 0,
+        Decoration,
+        Collision,
+        Overlay,
+        Count
+    };
+
+    // Chunked multi-layer tile storage.
+    //
+    // Each layer is split into CHUNK_TILES x CHUNK_TILES chunks.
+    // A chunk is only allocated once something different from the layer's
+    // fill value is written into it, so a mostly-empty 512x512 room costs
+    // a handful of chunks instead of 256 of them per layer.
+    //
+    // Every chunk also keeps its own render texture and dirty flag:
+    // editing a tile only re-rasterises that one chunk next frame.
+    //
+    // With an arena set (setArena), chunks and chunk tables come out of it
+    // instead of the heap and are freed when the arena resets; without one
+    // the map owns its chunks as before.
+    //
+    // The tile ids themselves live in refcounted TileBlocks from a
+    // TileBlockPool (setBlockPool, else a pool of the map's own). load()
+    // shares every chunk by content, so rooms stamped from one template
+    // point at the same blocks; setTile() copies a shared block before the
+    // first write to it (copy-on-write).
+    //
+    // Autotiling: next to the solid grid the map keeps one neighbour mask
+    // byte per tile (TILE_N | TILE_E | TILE_S | TILE_W, from the solid
+    // grid). load() fills it a row at a time; setTile() on the collision
+    // layer redoes the four neighbours and marks their chunks dirty.
+    // Drawing picks the atlas variant from it, no neighbour lookups.
+    //
+    // NOTE: chunk textures belong to the renderer. Call releaseRenderCache()
+    // before the renderer is destroyed (same rule as TextureManager::clear()).
     class TileMap
     {
     public:
-        static constexpr int TILE_SIZE = 16;
+        static constexpr int TILE_SIZE    = 16;
+        static constexpr int CHUNK_TILES  = TileBlock::SIDE;
+        static constexpr int CHUNK_PIXELS = CHUNK_TILES * TILE_SIZE;
+        static constexpr int LAYER_COUNT  = static_cast<int>(TileLayer::Count);
+
+        // "nothing here" (used as fill for decoration / overlay)
+        static constexpr int EMPTY_TILE = -1;
+
+        TileMap();
+        TileMap(int w, int h, const std::vector<int>& tiles);
+
+        TileMap(const TileMap&) = delete;
+        TileMap& operator=(const TileMap&) = delete;
+        TileMap(TileMap&& other) noexcept;
+        TileMap& operator=(TileMap&& other) noexcept; // our chunks + textures go first
+        ~TileMap();
+
+        // Where the next create() / load() allocates from (nullptr = heap).
+        // The arena must not be reset while this map still uses its chunks.
+        void setArena(Arena* arena) { m_arena = arena; }
+        Arena* arena() const { return m_arena; }
+
+        // Where tile blocks come from and get shared (nullptr = a pool of
+        // our own). Set it before create() / load(); it must outlive the map.
+        void setBlockPool(TileBlockPool* pool) { m_pool = pool; }
+        TileBlockPool& blockPool();
 
-        TileMap() : m_w(0), m_h(0) {}
-        TileMap(int w, int h, const std::vector<int>& tiles)
+        // Reset to an empty w x h map (every layer at its fill value).
+        void create(int w, int h);
+
+        // Classic single-layer load: ids go to the floor layer, solid ones
+        // (TileTypes.h) also go to the collision layer. Chunks are shared
+        // through the block pool afterwards.
+        void load(int w, int h, const std::vector<int>& tiles);
+
+        // Swap every private chunk for the pool's shared block with the
+        // same content (after edits, or after building a map by hand).
+        void share();
+
+        int width() const  { return m_w; }
+        int height() const { return m_h; }
+
+        // Return the numeric tile type at (tx, ty) on the floor layer
+        // (meaning: tileType(id), TileTypes.h). Out of bounds counts as wall.
+        int getTileId(int tx, int ty) const
         {
-            load(w, h, tiles);
+            if (tx < 0 || ty < 0 || tx >= m_w || ty >= m_h)
+                return TILE_WALL;
+            return getTile(TileLayer::Floor, tx, ty);
         }
 
-        void load(int w, int h, const std::vector<int>& tiles)
+        // Which neighbours of (tx, ty) are solid (TILE_N | TILE_E | ...).
+        std::uint8_t neighborMask(int tx, int ty) const
         {
-            m_w = w;
-            m_h = h;
-            m_tiles = tiles;
-            if ((int)m_tiles.size() != w * h)
-            {
-                // safety fallback if caller passed wrong size
-                m_tiles.resize(w * h, 0);
-            }
+            if (tx < 0 || ty < 0 || tx >= m_w || ty >= m_h)
+                return TILE_N | TILE_E | TILE_S | TILE_W;
+            return m_neighbors[static_cast<std::size_t>(ty) * m_w + tx];
         }
 
-        int width() const  { return m_w; }
-        int height() const { return m_h; }
+        // TILE_* flags of the floor tile at (tx, ty).
+        std::uint8_t tileFlagsAt(int tx, int ty) const { return tileFlags(getTileId(tx, ty)); }
 
-        // Return the numeric tile type at (tx, ty).
-        // 0 = floor/walkable, 1 = wall/blocked.
-        // Out of bounds counts as wall.
-        int getTileId(int tx, int ty) const
+        // Raw layer access. Out of bounds returns the layer fill.
+        int getTile(TileLayer layer, int tx, int ty) const
         {
+            const Layer& l = m_layers[static_cast<int>(layer)];
             if (tx < 0 || ty < 0 || tx >= m_w || ty >= m_h)
-                return 1;
-            return m_tiles[ty * m_w + tx];
+                return l.fill;
+
+            const Chunk* c = l.chunks[chunkIndex(tx, ty)].get();
+            if (!c)
+                return l.fill;
+            return c->block->tiles[localIndex(tx, ty)];
         }
 
+        // Write a tile, allocating the chunk on first non-fill write and
+        // un-sharing its block on the first write that changes something.
+        // Ids that don't fit a TileId are rejected (asserts in debug), not wrapped.
+        void setTile(TileLayer layer, int tx, int ty, int id);
+
+        // Layer fill (value of every tile in a chunk that was never allocated).
+        int layerFill(TileLayer layer) const { return m_layers[static_cast<int>(layer)].fill; }
+
+        bool isSolidAtTile(int tx, int ty) const
+        {
+            if (tx < 0 || ty < 0 || tx >= m_w || ty >= m_h)
+                return true;
+            return m_solid[solidIndex(tx, ty)] != 0;
+        }
+
+        // Same answer from the packed solid bitset (see m_solidBits); for
+        // scans that touch a lot of tiles and want to stay in cache.
+        bool solidBit(int tx, int ty) const
+        {
+            if (tx < 0 || ty < 0 || tx >= m_w || ty >= m_h)
+                return true;
+            const std::uint64_t word = m_solidBits[static_cast<std::size_t>(ty) * m_solidBitsStride + (tx >> 6)];
+            return (word >> (tx & 63)) & 1;
+        }
+
+        // solidBit() a word at a time: `count` rows of `width` (<= 64)
+        // tiles from (tx, ty), out[i] bit j = tile (tx + j, ty + i) ...
+        void solidRows(int tx, int ty, int width, int count, std::uint64_t* out) const;
+        // ... or `count` columns of `height` tiles, out[j] bit i = the same tile.
+        void solidColumns(int tx, int ty, int height, int count, std::uint64_t* out) const;
+
+        // New value whenever a tile's solidity changes (create / load /
+        // setTile on the collision layer), never the same for two maps.
+        // Caches built from the walls keep it to tell when they are stale.
+        std::uint64_t wallStamp() const { return m_wallStamp; }
+
         // Axis-aligned rectangle vs. solid tiles.
         bool rectCollidesSolid(const SDL_Rect& r) const
         {
@@ -53,16 +180,166 @@ namespace zelda::game
             {
                 for (int tx = leftTile; tx <= rightTile; ++tx)
                 {
-                    if (getTileId(tx, ty) == 1) // solid wall
+                    if (isSolidAtTile(tx, ty)) // solid wall
                         return true;
                 }
             }
             return false;
         }
 
+        // Batch version of rectCollidesSolid, same answers.
+        // Bit i of hitMask (word i / 64) is set if rects[i] touches a solid
+        // tile; hitMask needs (count + 63) / 64 words.
+        void rectsCollideSolid(const SDL_Rect* rects, std::size_t count, std::uint64_t* hitMask) const;
+
+        // Swept version: tests the box covering rects[i] and rects[i]
+        // moved by deltas[i] (conservative for moves up to a tile or so).
+        void movesCollideSolid(const SDL_Rect* rects, const SDL_Point* deltas, std::size_t count,
+                               std::uint64_t* hitMask) const;
+
+        static const char* collisionKernelName();
+
+        // Queue the visible chunks of one layer on `drawLayer`.
+        // view is in map pixels, offset is added to every destination.
+        // Dirty chunks that are on screen get re-rasterised first
+        // (right away, through queue.renderer()).
+        void renderLayer(RenderQueue& queue,
+                         DrawLayer drawLayer,
+                         SDL_Texture* tilesTex,
+                         TileLayer layer,
+                         const SDL_Rect& view,
+                         int offsetX,
+                         int offsetY);
+
+        // Destroy every cached chunk texture (they will be rebuilt on demand).
+        void releaseRenderCache();
+
+        // Debug / stats
+        int chunksX() const { return m_chunksX; }
+        int chunksY() const { return m_chunksY; }
+        std::size_t allocatedChunkCount() const;
+        std::size_t sharedChunkCount() const;
+        // Shared blocks count as their size / number of users, so summing
+        // this over every map that uses a pool gives the real total.
+        std::size_t memoryBytes() const;
+        std::uint64_t chunkRedrawCount() const { return m_chunkRedraws; } // total re-rasterised chunks
+
+        // Atlas cell for a tile id on tiles.png (from the tile type table).
+        // Chunks are cached as textures, so the map draws frame 0 of
+        // animated tiles.
+        static SDL_Rect atlasRectFor(int tileId, std::uint8_t neighbors = 0)
+        {
+            return tileAtlasRect(tileId, 0, TILE_SIZE, neighbors);
+        }
+
     private:
+        struct Chunk
+        {
+            TileBlock* block = nullptr;   // never null; read-only while block->shared
+            bool dirty = true;
+            SDL_Texture* cache = nullptr; // rendered chunk, CHUNK_PIXELS square
+        };
+
+        // The block always goes back to its pool and the texture is
+        // destroyed. Arena chunks are then just dropped (the arena frees
+        // them), heap ones deleted.
+        struct ChunkDeleter
+        {
+            bool heap = true;
+            TileBlockPool* pool = nullptr;
+            void operator()(Chunk* c) const
+            {
+                if (c->cache)
+                    SDL_DestroyTexture(c->cache);
+                pool->release(c->block);
+                if (heap)
+                    delete c;
+            }
+        };
+        using ChunkPtr = std::unique_ptr<Chunk, ChunkDeleter>;
+
+        struct Layer
+        {
+            int fill = 0;
+            ArenaVector<ChunkPtr> chunks; // m_chunksX * m_chunksY, null = all fill
+
+            // Shared texture for chunks that were never allocated.
+            // Only used when fill != EMPTY_TILE. Owned by the map (moves
+            // null it in the source, releaseRenderCache() destroys it).
+            SDL_Texture* fillCache = nullptr;
+        };
+
+        // m_solid has a one tile solid border, so -1 and m_w / m_h are valid
+        int solidIndex(int tx, int ty) const
+        {
+            return (ty + 1) * m_solidStride + (tx + 1);
+        }
+
+        int chunkIndex(int tx, int ty) const
+        {
+            return (ty / CHUNK_TILES) * m_chunksX + (tx / CHUNK_TILES);
+        }
+        static int localIndex(int tx, int ty)
+        {
+            return (ty % CHUNK_TILES) * CHUNK_TILES + (tx % CHUNK_TILES);
+        }
+
+        // neighbour masks for rows [ty0, ty1) from the solid grid
+        void computeNeighborRows(int ty0, int ty1);
+        // after (tx, ty) changed solidity: its 4 neighbours' masks + chunks
+        void updateNeighborsOf(int tx, int ty);
+        void markDirtyAt(int tx, int ty);
+
+        void rasterizeChunk(SDL_Renderer* renderer,
+                            SDL_Texture* tilesTex,
+                            SDL_Texture* target,
+                            const Chunk* chunk,
+                            int fill,
+                            int chunkX,
+                            int chunkY) const;
+        void queueChunkTiles(RenderQueue& queue,
+                             DrawLayer drawLayer,
+                             SDL_Texture* tilesTex,
+                             const Chunk* chunk,
+                             int fill,
+                             int chunkX,
+                             int chunkY,
+                             int originX,
+                             int originY) const;
+        static void drawTile(SDL_Renderer* renderer, SDL_Texture* tilesTex, int tileId, std::uint8_t neighbors,
+                             const SDL_Rect& dst);
+        static SDL_Texture* createChunkTexture(SDL_Renderer* renderer);
+
         int m_w;
         int m_h;
-        std::vector<int> m_tiles;
+        int m_chunksX;
+        int m_chunksY;
+
+        // before m_layers: chunks hand their blocks back on destruction
+        TileBlockPool* m_pool = nullptr;
+        std::unique_ptr<TileBlockPool> m_ownPool;
+
+        std::array<Layer, LAYER_COUNT> m_layers;
+        Arena* m_arena = nullptr;
+
+        // Flat copy of the collision layer (1 = tile type is solid), one
+        // byte per tile plus a solid border. Kept in sync by setTile(); this is what collision reads.
+        ArenaVector<std::uint8_t> m_solid;
+        int m_solidStride = 0;
+
+        // The same grid one bit per tile (bit tx % 64 of word tx / 64 in
+        // row ty), no border, and its transpose (column tx, bit ty) so
+        // vertical runs are word reads too. Kept in sync by setTile().
+        ArenaVector<std::uint64_t> m_solidBits;
+        ArenaVector<std::uint64_t> m_solidBitsT;
+        int m_solidBitsStride = 0;  // words per row
+        int m_solidBitsTStride = 0; // words per column
+        std::uint64_t m_wallStamp = 0;
+
+        // Autotile neighbour masks, m_w x m_h (see neighborMask()).
+        ArenaVector<std::uint8_t> m_neighbors;
+        bool m_loading = false; // load(): masks are done in one pass at the end
+
+        std::uint64_t m_chunkRedraws = 0;
     };
 }
@@ -0,0 +1,125 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <cstddef>
+#include <SDL2/SDL.h>
+
+#include "TileBlockPool.h"
+
+namespace zelda::game
+{
+    // What a tile id means, looked up instead of compared against.
+    //
+    // Every tile id indexes one entry of TILE_TYPES, a table built at
+    // compile time from TILE_DEFS below: flags for gameplay queries, the
+    // atlas cell it's drawn from, its animation, its autotile variants and
+    // a fallback colour for when tiles.png didn't load. Queries are one load plus a mask test, so
+    // adding tile types costs table space only (TILE_TYPE_CAPACITY entries
+    // of 12 bytes), never another branch.
+    //
+    // Ids without a definition are plain floor drawn from atlas cell `id`
+    // (what every id meant before the table). Anything outside
+    // [0, TILE_TYPE_CAPACITY), i.e. TileMap::EMPTY_TILE, maps to the last
+    // entry, which has TILE_NONE set and is never drawn.
+
+    enum TileFlag : std::uint8_t
+    {
+        TILE_SOLID   = 1u << 0, // blocks movement
+        TILE_HAZARD  = 1u << 1, // hurts whoever stands on it
+        TILE_WATER   = 1u << 2, // swimmable / blocks without the right item
+        TILE_TRIGGER = 1u << 3, // stepping on it raises an event
+        TILE_NONE    = 1u << 7  // no tile (EMPTY_TILE / out of range): not drawn
+    };
+
+    struct TileType
+    {
+        std::uint8_t flags = 0;
+        std::uint8_t frames = 1;      // animation frames, laid out to the right of the atlas cell
+        std::uint8_t frameTicks = 1;  // ticks per frame (any value for 1 frame)
+        std::uint8_t atlasRow = 0;
+        std::uint16_t atlasCol = 0;   // atlas cell, in TILE_SIZE units
+        SDL_Color debugColor{40, 60, 80, 255};
+
+        // Autotiling: the 4-bit neighbour mask (TILE_N | TILE_E | ...) is
+        // and-ed with this and added to atlasCol, so 0x0F = 16 variants in
+        // a row, 0 = one look whatever the neighbours.
+        std::uint8_t autotileMask = 0;
+    };
+
+    constexpr int TILE_TYPE_CAPACITY = 512;
+
+    // Well-known ids (the ones the loaders and the generator write).
+    enum : TileId
+    {
+        TILE_FLOOR = 0,
+        TILE_WALL  = 1,
+    };
+
+    // Neighbour mask bits: which of the 4 neighbours is solid.
+    enum TileNeighbor : std::uint8_t
+    {
+        TILE_N = 1u << 0,
+        TILE_E = 1u << 1,
+        TILE_S = 1u << 2,
+        TILE_W = 1u << 3
+    };
+
+    struct TileDef
+    {
+        TileId id;
+        TileType type;
+    };
+
+    // The registry. Add tile types here; ids may be sparse.
+    inline constexpr TileDef TILE_DEFS[] = {
+        //  id           flags       frames ticks row col  fallback colour     autotile
+        {TILE_FLOOR, {0,          1,     1,    0,  0,   {40, 60, 80, 255},  0}},
+        {TILE_WALL,  {TILE_SOLID, 1,     1,    1,  0,   {80, 40, 40, 255},  0x0F}},
+    };
+
+    namespace detail
+    {
+        constexpr std::array<TileType, TILE_TYPE_CAPACITY + 1> buildTileTypes()
+        {
+            std::array<TileType, TILE_TYPE_CAPACITY + 1> table{};
+            for (int id = 0; id < TILE_TYPE_CAPACITY; ++id)
+                table[id].atlasCol = static_cast<std::uint16_t>(id);
+            table[TILE_TYPE_CAPACITY].flags = TILE_NONE;
+
+            for (const TileDef& def : TILE_DEFS)
+            {
+                // a bad id fails the build (not a constant expression)
+                if (def.id < 0 || def.id >= TILE_TYPE_CAPACITY || def.type.frames == 0 || def.type.frameTicks == 0)
+                    throw "bad tile definition";
+                table[def.id] = def.type;
+            }
+            return table;
+        }
+    }
+
+    inline constexpr std::array<TileType, TILE_TYPE_CAPACITY + 1> TILE_TYPES = detail::buildTileTypes();
+
+    constexpr const TileType& tileType(int id)
+    {
+        // one unsigned compare folds negative ids in too (select, no branch)
+        const unsigned index = static_cast<unsigned>(id);
+        return TILE_TYPES[index < TILE_TYPE_CAPACITY ? index : TILE_TYPE_CAPACITY];
+    }
+
+    constexpr std::uint8_t tileFlags(int id) { return tileType(id).flags; }
+    constexpr bool tileIsSolid(int id)       { return (tileFlags(id) & TILE_SOLID) != 0; }
+
+    // Atlas cell for `id` at game tick `tick` with neighbour mask
+    // `neighbors` (animated tiles step through their frames, static ones
+    // have frames == 1; tiles without autotiling ignore the mask).
+    constexpr SDL_Rect tileAtlasRect(int id, std::uint64_t tick, int tileSize, std::uint8_t neighbors = 0)
+    {
+        const TileType& t = tileType(id);
+        const int frame = static_cast<int>((tick / t.frameTicks) % t.frames);
+        const int variant = neighbors & t.autotileMask;
+        return SDL_Rect{(t.atlasCol + frame + variant) * tileSize, t.atlasRow * tileSize, tileSize, tileSize};
+    }
+
+    static_assert(tileIsSolid(TILE_WALL) && !tileIsSolid(TILE_FLOOR), "wall / floor traits");
+    static_assert(tileFlags(-1) == TILE_NONE, "EMPTY_TILE maps to the 'no tile' entry");
+}
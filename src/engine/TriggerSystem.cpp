@@ -0,0 +1,173 @@
+#include "TriggerSystem.h"
+#include "TileMap.h"
+
+#include <algorithm>
+
+namespace zelda::game
+{
+    namespace
+    {
+        // floor division, so -8px lands in cell -1 (then clamped to 0)
+        int floorDiv(int a, int b)
+        {
+            int q = a / b;
+            if ((a % b != 0) && ((a < 0) != (b < 0)))
+                --q;
+            return q;
+        }
+    }
+
+    void TriggerTable::clear()
+    {
+        m_defs.clear();
+        m_w = 0;
+        m_h = 0;
+        m_cellStart.clear();
+        m_cellTriggers.clear();
+    }
+
+    void TriggerTable::build(const std::vector<TriggerDef>& defs, int mapTilesW, int mapTilesH, Arena* arena)
+    {
+        clear();
+        m_w = std::max(1, mapTilesW);
+        m_h = std::max(1, mapTilesH);
+
+        // fresh (possibly arena backed) storage, each array sized exactly once
+        const std::size_t cells = static_cast<std::size_t>(m_w) * m_h;
+        m_defs = ArenaVector<TriggerDef>(defs.begin(), defs.end(), ArenaAllocator<TriggerDef>(arena));
+        m_cellStart = ArenaVector<int>(cells + 1, 0, ArenaAllocator<int>(arena));
+
+        // pass 1: count triggers per cell
+        for (const auto& def : m_defs)
+        {
+            int tx0, ty0, tx1, ty1;
+            if (!cellRange(def.rect, tx0, ty0, tx1, ty1))
+                continue;
+            for (int ty = ty0; ty <= ty1; ++ty)
+                for (int tx = tx0; tx <= tx1; ++tx)
+                    m_cellStart[ty * m_w + tx + 1]++;
+        }
+
+        // prefix sum -> offsets
+        for (std::size_t i = 1; i <= cells; ++i)
+            m_cellStart[i] += m_cellStart[i - 1];
+
+        // pass 2: fill
+        m_cellTriggers = ArenaVector<int>(static_cast<std::size_t>(m_cellStart[cells]), 0, ArenaAllocator<int>(arena));
+        std::vector<int> cursor(m_cellStart.begin(), m_cellStart.end() - 1);
+        for (int id = 0; id < (int)m_defs.size(); ++id)
+        {
+            int tx0, ty0, tx1, ty1;
+            if (!cellRange(m_defs[id].rect, tx0, ty0, tx1, ty1))
+                continue;
+            for (int ty = ty0; ty <= ty1; ++ty)
+                for (int tx = tx0; tx <= tx1; ++tx)
+                    m_cellTriggers[cursor[ty * m_w + tx]++] = id;
+        }
+    }
+
+    bool TriggerTable::cellRange(const SDL_Rect& r, int& tx0, int& ty0, int& tx1, int& ty1) const
+    {
+        if (m_w == 0 || m_h == 0 || r.w <= 0 || r.h <= 0)
+            return false;
+
+        const int tileSize = TileMap::TILE_SIZE;
+        tx0 = std::clamp(floorDiv(r.x, tileSize), 0, m_w - 1);
+        ty0 = std::clamp(floorDiv(r.y, tileSize), 0, m_h - 1);
+        tx1 = std::clamp(floorDiv(r.x + r.w - 1, tileSize), 0, m_w - 1);
+        ty1 = std::clamp(floorDiv(r.y + r.h - 1, tileSize), 0, m_h - 1);
+        return true;
+    }
+
+    void TriggerSystem::reset()
+    {
+        m_prev.clear();
+        m_curr.clear();
+        m_events.clear();
+    }
+
+    void TriggerSystem::reserve(std::size_t actors, std::size_t triggers)
+    {
+        const std::size_t pairs = actors * 4;
+        m_prev.reserve(pairs);
+        m_curr.reserve(pairs);
+        m_events.reserve(pairs * 2); // every pair can enter and exit
+        if (m_stamp.size() < triggers)
+            m_stamp.resize(triggers, 0);
+    }
+
+    const std::vector<TriggerEvent>& TriggerSystem::update(const TriggerTable& table,
+                                                           const TriggerActor* actors,
+                                                           std::size_t actorCount)
+    {
+        m_events.clear();
+        m_curr.clear();
+        m_lastCandidates = 0;
+
+        const auto& defs = table.triggers();
+        if (m_stamp.size() < defs.size())
+            m_stamp.resize(defs.size(), 0);
+
+        // 1) who overlaps what right now (only triggers listed in covered cells)
+        for (std::size_t a = 0; a < actorCount; ++a)
+        {
+            const TriggerActor& actor = actors[a];
+
+            int tx0, ty0, tx1, ty1;
+            if (!table.cellRange(actor.rect, tx0, ty0, tx1, ty1))
+                continue;
+
+            // new stamp per actor so a trigger spanning several cells is tested once
+            if (++m_stampGen == 0)
+            {
+                std::fill(m_stamp.begin(), m_stamp.end(), 0);
+                m_stampGen = 1;
+            }
+
+            for (int ty = ty0; ty <= ty1; ++ty)
+            {
+                for (int tx = tx0; tx <= tx1; ++tx)
+                {
+                    for (const int* it = table.cellBegin(tx, ty); it != table.cellEnd(tx, ty); ++it)
+                    {
+                        const int id = *it;
+                        if (m_stamp[id] == m_stampGen)
+                            continue;
+                        m_stamp[id] = m_stampGen;
+
+                        ++m_lastCandidates;
+                        if (SDL_HasIntersection(&actor.rect, &defs[id].rect))
+                            m_curr.push_back(key(actor.id, id));
+                    }
+                }
+            }
+        }
+
+        std::sort(m_curr.begin(), m_curr.end());
+
+        // 2) diff against last tick (both sorted): enter / stay / exit
+        std::size_t i = 0, j = 0;
+        while (i < m_prev.size() || j < m_curr.size())
+        {
+            if (j == m_curr.size() || (i < m_prev.size() && m_prev[i] < m_curr[j]))
+            {
+                std::uint64_t k = m_prev[i++];
+                m_events.push_back(TriggerEvent{TriggerEvent::Kind::Exit, (int)(k & 0xFFFFFFFFu), (int)(k >> 32)});
+            }
+            else if (i == m_prev.size() || m_curr[j] < m_prev[i])
+            {
+                std::uint64_t k = m_curr[j++];
+                m_events.push_back(TriggerEvent{TriggerEvent::Kind::Enter, (int)(k & 0xFFFFFFFFu), (int)(k >> 32)});
+            }
+            else
+            {
+                std::uint64_t k = m_curr[j++];
+                ++i;
+                m_events.push_back(TriggerEvent{TriggerEvent::Kind::Stay, (int)(k & 0xFFFFFFFFu), (int)(k >> 32)});
+            }
+        }
+
+        m_prev.swap(m_curr);
+        return m_events;
+    }
+}
@@ -0,0 +1,121 @@
+#pragma once
+#include <SDL2/SDL.h>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+#include "Arena.h"
+
+namespace zelda::game
+{
+    // What happens when something walks into a trigger.
+    enum class TriggerType : int
+    {
+        Door = 0,      // param = RoomDir to travel
+        Trap,
+        PressurePlate,
+        Cutscene
+    };
+
+    // One trigger volume, as stored in the room data.
+    struct TriggerDef
+    {
+        TriggerType type = TriggerType::Door;
+        SDL_Rect rect{0, 0, 0, 0}; // map pixels, may poke outside the map (doors do)
+        int param = 0;             // meaning depends on type
+    };
+
+    // Per-room trigger list + a tile-grid index over it.
+    //
+    // Each tile cell lists the triggers overlapping it (stored CSR style:
+    // one offsets array + one flat id array, built once when the room loads).
+    // Triggers that stick out of the map are clamped into the border cells.
+    // Pass the level arena to build() and the table lives in it.
+    class TriggerTable
+    {
+    public:
+        void build(const std::vector<TriggerDef>& defs, int mapTilesW, int mapTilesH, Arena* arena = nullptr);
+        void clear();
+
+        const ArenaVector<TriggerDef>& triggers() const { return m_defs; }
+        std::size_t size() const { return m_defs.size(); }
+
+        // Cell range a pixel rect touches (clamped to the grid).
+        // Returns false if the table is empty.
+        bool cellRange(const SDL_Rect& r, int& tx0, int& ty0, int& tx1, int& ty1) const;
+
+        // Trigger ids overlapping one cell.
+        const int* cellBegin(int tx, int ty) const { return m_cellTriggers.data() + m_cellStart[ty * m_w + tx]; }
+        const int* cellEnd(int tx, int ty) const   { return m_cellTriggers.data() + m_cellStart[ty * m_w + tx + 1]; }
+
+    private:
+        ArenaVector<TriggerDef> m_defs;
+        int m_w = 0;
+        int m_h = 0;
+        ArenaVector<int> m_cellStart;    // m_w * m_h + 1
+        ArenaVector<int> m_cellTriggers; // trigger ids, grouped by cell
+    };
+
+    // Something that can stand in a trigger (player, enemy, ...).
+    struct TriggerActor
+    {
+        int id;        // caller-defined, reported back in events
+        SDL_Rect rect; // map pixels
+    };
+
+    struct TriggerEvent
+    {
+        enum class Kind : int
+        {
+            Enter = 0,
+            Stay,
+            Exit
+        };
+
+        Kind kind;
+        int trigger; // index into TriggerTable::triggers()
+        int actor;   // TriggerActor::id
+    };
+
+    // Tracks which actor is inside which trigger from tick to tick.
+    //
+    // update() only looks at the cells each actor covers, so cost scales
+    // with actors, not with how many triggers the room has.
+    // Buffers are reused; once warmed up a tick doesn't allocate.
+    class TriggerSystem
+    {
+    public:
+        // Forget every overlap (no Exit events). Use on room change.
+        void reset();
+
+        // Size the buffers up front so update() doesn't grow them mid-game.
+        // Assumes an actor rarely stands in more than a few triggers at once.
+        void reserve(std::size_t actors, std::size_t triggers);
+
+        const std::vector<TriggerEvent>& update(const TriggerTable& table,
+                                                const TriggerActor* actors,
+                                                std::size_t actorCount);
+
+        const std::vector<TriggerEvent>& events() const { return m_events; }
+
+        // triggers rect-tested during the last update (debug / tuning)
+        std::size_t lastCandidateCount() const { return m_lastCandidates; }
+
+    private:
+        static std::uint64_t key(int actor, int trigger)
+        {
+            return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(actor)) << 32)
+                 | static_cast<std::uint32_t>(trigger);
+        }
+
+        std::vector<std::uint64_t> m_prev; // sorted (actor, trigger) pairs
+        std::vector<std::uint64_t> m_curr;
+        std::vector<TriggerEvent>  m_events;
+
+        // "already tested for this actor" marks, one per trigger
+        std::vector<std::uint32_t> m_stamp;
+        std::uint32_t m_stampGen = 0;
+
+        std::size_t m_lastCandidates = 0;
+    };
+}
@@ -0,0 +1,270 @@
+#include "Visibility.h"
+
+#include <algorithm>
+#include <bit>
+
+#include "Log.h"
+
+namespace zelda::game
+{
+    namespace
+    {
+        // A slope num / den (den > 0, |num| <= den) and where it is on the
+        // row being scanned: depth * num / den = whole + rem / den with
+        // 0 <= rem < den. One row deeper is an add, never a division.
+        struct Slope
+        {
+            int num;
+            int den;
+            int whole;
+            int rem;
+
+            Slope deeper() const
+            {
+                Slope s = *this;
+                s.rem += num;
+                if (s.rem >= den)
+                {
+                    s.rem -= den;
+                    ++s.whole;
+                }
+                else if (s.rem < 0)
+                {
+                    s.rem += den;
+                    --s.whole;
+                }
+                return s;
+            }
+        };
+
+        // through the left edge of column col on row depth: (2 col - 1) / (2 depth),
+        // which is col - 1/2 on that row
+        Slope edgeSlope(int depth, int col)
+        {
+            return Slope{2 * col - 1, 2 * depth, col - 1, depth};
+        }
+
+        // columns lo .. hi of a row span first .. last (bit 0 = first, < 64 wide)
+        std::uint64_t columnMask(int lo, int hi, int first, int last)
+        {
+            lo = lo > first ? lo : first;
+            hi = hi < last ? hi : last;
+            return lo > hi ? 0 : (2ull << (hi - first)) - (1ull << (lo - first));
+        }
+
+        // One quadrant: rows ("depth") go away from the viewer, columns
+        // across them. Walls block the slopes behind them; a floor tile is
+        // only revealed if its centre is inside the unblocked sector, which
+        // is what makes the result symmetric.
+        //
+        // A row is one word of the viewer's window (bit radius + col), so
+        // it's handled a run of walls / floors at a time, not per tile.
+        class QuadrantCaster
+        {
+        public:
+            // lines: the window's walls by row (north / south) or by column
+            // (east / west), dir: which way depth goes through them.
+            // Revealed bits go to out, laid out like lines.
+            QuadrantCaster(const std::uint64_t* lines, int dir, int radius, const int* colLimit, std::uint64_t* out)
+            : m_lines(lines)
+            , m_out(out)
+            , m_colLimit(colLimit)
+            , m_dir(dir)
+            , m_radius(radius)
+            {
+            }
+
+            void scan(int depth, Slope start, Slope end)
+            {
+                if (depth > m_radius)
+                    return;
+
+                // columns round_ties_up(depth * start) .. round_ties_down(depth * end)
+                const int minCol = start.whole + (2 * start.rem >= start.den);
+                const int maxCol = end.whole + (2 * end.rem > end.den);
+                const int len = maxCol - minCol + 1;
+                if (len <= 0)
+                    return;
+                m_scanned += static_cast<std::uint64_t>(len);
+
+                const int line = m_radius + m_dir * depth;
+                const int base = m_radius + minCol; // bit of minCol in a line
+                const std::uint64_t span = (1ull << len) - 1; // len <= 2 * depth + 1 < 64
+                const std::uint64_t walls = (m_lines[line] >> base) & span;
+
+                // walls always, floors if their centre is in the sector
+                // (ceil(depth * start) .. floor(depth * end)); all within the circle
+                const int limit = m_colLimit[depth];
+                const int ceilStart = start.whole + (start.rem > 0);
+                const int sectorLo = ceilStart > -limit ? ceilStart : -limit;
+                const int sectorHi = end.whole < limit ? end.whole : limit;
+                const std::uint64_t floors = columnMask(sectorLo, sectorHi, minCol, maxCol);
+                const std::uint64_t circle = columnMask(-limit, limit, minCol, maxCol);
+                m_out[line] |= ((walls & circle) | (~walls & floors)) << base;
+
+                // wall -> floor narrows the sector from the left, floor ->
+                // wall ends a sub-sector that continues on the next row
+                int k = 0;
+                bool wall = walls & 1;
+                for (;;)
+                {
+                    const std::uint64_t other = (wall ? ~walls : walls) & span & ~((1ull << k) - 1);
+                    if (!other)
+                        break;
+                    k = std::countr_zero(other);
+
+                    const Slope edge = edgeSlope(depth, minCol + k);
+                    if (wall)
+                        start = edge;
+                    else
+                        scan(depth + 1, start.deeper(), edge.deeper());
+                    wall = !wall;
+                }
+                if (!wall)
+                    scan(depth + 1, start.deeper(), end.deeper());
+            }
+
+            std::uint64_t scanned() const { return m_scanned; }
+
+        private:
+            const std::uint64_t* m_lines;
+            std::uint64_t* m_out;
+            const int* m_colLimit;
+            int m_dir;
+            int m_radius;
+            std::uint64_t m_scanned = 0;
+        };
+    }
+
+    void Visibility::clear()
+    {
+        m_viewers.clear();
+        m_stats = VisibilityStats{};
+    }
+
+    Visibility::ViewerId Visibility::addViewer(int radiusTiles)
+    {
+        Viewer viewer;
+        viewer.field.radius = std::clamp(radiusTiles, 1, VisibilityField::MAX_RADIUS);
+        m_viewers.push_back(viewer);
+        return static_cast<ViewerId>(m_viewers.size() - 1);
+    }
+
+    void Visibility::moveViewer(ViewerId viewer, const TileMap& map, int tx, int ty)
+    {
+        Viewer& v = m_viewers[viewer];
+        v.map = &map;
+        v.tileX = tx;
+        v.tileY = ty;
+    }
+
+    const VisibilityField& Visibility::field(ViewerId viewer)
+    {
+        ++m_stats.lookups;
+        Viewer& v = m_viewers[viewer];
+        cast(v, 0xF);
+        return v.field;
+    }
+
+    bool Visibility::canSee(ViewerId viewer, int tx, int ty)
+    {
+        ++m_stats.lookups;
+        Viewer& v = m_viewers[viewer];
+        const int dx = tx - v.tileX, adx = dx < 0 ? -dx : dx;
+        const int dy = ty - v.tileY, ady = dy < 0 ? -dy : dy;
+        const int r = v.field.radius;
+        if (adx > r || ady > r)
+            return false;
+
+        // the quadrant(s) (tx, ty) is in; none for the origin
+        unsigned mask = 0;
+        if (ady >= adx)
+            mask |= dy < 0 ? 1u : dy > 0 ? 2u : 0u;
+        if (adx >= ady)
+            mask |= dx > 0 ? 4u : dx < 0 ? 8u : 0u;
+        cast(v, mask);
+        return v.field.canSee(tx, ty);
+    }
+
+    void Visibility::cast(Viewer& v, unsigned mask)
+    {
+        if (!v.map)
+            return;
+
+        VisibilityField& field = v.field;
+        const int r = field.radius;
+        const int side = 2 * r + 1;
+        if (field.originX != v.tileX || field.originY != v.tileY || field.wallStamp != v.map->wallStamp())
+        {
+            field.originX = v.tileX;
+            field.originY = v.tileY;
+            field.wallStamp = v.map->wallStamp();
+            field.quadrants = 0;
+            for (int i = 0; i < side; ++i)
+            {
+                field.rows[i] = 0;
+                field.cols[i] = 0;
+            }
+            field.rows[r] = 1ull << r; // where we stand
+        }
+
+        mask &= ~field.quadrants;
+        if (!mask)
+            return;
+        field.quadrants |= mask;
+
+        // half-width of the sight circle per row
+        int colLimit[VisibilityField::MAX_RADIUS + 1];
+        const int radius2 = r * r + r; // slightly rounder than r^2
+        for (int depth = 0, col = r; depth <= r; ++depth)
+        {
+            while (col > 0 && depth * depth + col * col > radius2)
+                --col;
+            colLimit[depth] = col;
+        }
+
+        // N, S, E, W: north / south scan rows of the window, east / west
+        // columns; only the half of the window on the quadrant's side is
+        // fetched (line radius + dir * depth, depth 1 .. radius)
+        struct Quadrant
+        {
+            bool byRow;
+            int dir;
+        };
+        static constexpr Quadrant QUADRANTS[4] = {{true, -1}, {true, 1}, {false, 1}, {false, -1}};
+
+        std::uint64_t walls[2 * VisibilityField::MAX_RADIUS + 1];
+        for (int q = 0; q < 4; ++q)
+        {
+            if (!(mask & (1u << q)))
+                continue;
+
+            const Quadrant& quadrant = QUADRANTS[q];
+            const int first = quadrant.dir < 0 ? 0 : r + 1; // first line fetched
+            const int offset = quadrant.dir < 0 ? -r : 1;    // ... and its distance from the viewer
+            if (quadrant.byRow)
+                v.map->solidRows(v.tileX - r, v.tileY + offset, side, r, walls + first);
+            else
+                v.map->solidColumns(v.tileX + offset, v.tileY - r, side, r, walls + first);
+
+            QuadrantCaster caster(walls, quadrant.dir, r, colLimit,
+                                  quadrant.byRow ? field.rows.data() : field.cols.data());
+            caster.scan(1, Slope{-1, 1, -1, 0}, Slope{1, 1, 1, 0});
+            m_stats.tilesScanned += caster.scanned();
+            ++m_stats.quadrants;
+        }
+    }
+
+    void Visibility::logSummary() const
+    {
+        if (m_stats.lookups == 0)
+            return;
+
+        ZLOG_INFO("Visibility: %llu lookups, %llu quadrants cast (%.3f / lookup), %.0f tiles scanned / quadrant",
+                  static_cast<unsigned long long>(m_stats.lookups),
+                  static_cast<unsigned long long>(m_stats.quadrants),
+                  static_cast<double>(m_stats.quadrants) / static_cast<double>(m_stats.lookups),
+                  m_stats.quadrants ? static_cast<double>(m_stats.tilesScanned) / static_cast<double>(m_stats.quadrants)
+                                    : 0.0);
+    }
+}
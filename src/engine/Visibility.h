@@ -0,0 +1,118 @@
+#pragma once
+#include <array>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <cmath>
+
+#include "TileMap.h"
+
+namespace zelda::game
+{
+    // What one viewer sees: the (2 * radius + 1) square of tiles around
+    // the tile it stands on, one bit per tile. The north / south quadrants
+    // (and the origin) are kept by row (rows[dy + radius] bit dx + radius),
+    // east / west by column (cols[dx + radius] bit dy + radius), the way
+    // each was scanned. Tiles outside the square or the sight circle, or
+    // in a quadrant that hasn't been cast, are unseen.
+    struct VisibilityField
+    {
+        static constexpr int MAX_RADIUS = 31; // a row of the square is one 64-bit word
+
+        int radius = 0;
+        int originX = 0;
+        int originY = 0;
+        std::uint64_t wallStamp = 0; // TileMap::wallStamp() it was cast against
+        unsigned quadrants = 0;      // cast so far, bit per quadrant (N, S, E, W)
+        std::array<std::uint64_t, 2 * MAX_RADIUS + 1> rows{};
+        std::array<std::uint64_t, 2 * MAX_RADIUS + 1> cols{};
+
+        // O(1): two bit tests in the cached field
+        bool canSee(int tx, int ty) const
+        {
+            const int dx = tx - originX + radius;
+            const int dy = ty - originY + radius;
+            if (dx < 0 || dy < 0 || dx > 2 * radius || dy > 2 * radius)
+                return false;
+            return ((rows[dy] >> dx) | (cols[dx] >> dy)) & 1;
+        }
+
+        // same for a point in map pixels
+        bool canSeePoint(float x, float y) const { return canSee(tileOf(x), tileOf(y)); }
+
+        static int tileOf(float px)
+        {
+            return static_cast<int>(std::floor(px / static_cast<float>(TileMap::TILE_SIZE)));
+        }
+    };
+
+    struct VisibilityStats
+    {
+        std::uint64_t lookups = 0;   // canSee() / field() calls
+        std::uint64_t quadrants = 0; // quadrants they had to cast (moved tile / walls changed)
+        std::uint64_t tilesScanned = 0;
+    };
+
+    // Line of sight against TileMap walls, cached per viewer.
+    //
+    // Each viewer's field comes from symmetric shadowcasting (four
+    // quadrants, row by row, slopes kept as exact fractions) over the
+    // map's packed solid bitsets: a row of a quadrant is one word, so
+    // it's handled a run of walls / floors at a time. Moving a viewer
+    // only records where it is; the field is recast when somebody next
+    // asks for it, and only if the viewer is on another tile or the map's
+    // wall stamp changed (a wall was edited, or it's a different map).
+    // Otherwise the field from last time stands and "can A see B" is a
+    // bit test in A's field. Quadrants don't depend on each other, so
+    // canSee() only casts the one B is in (two on a diagonal); field()
+    // casts whatever is missing.
+    //
+    // Symmetric means a floor tile A sees floor tile B exactly when B
+    // sees A, so one field around the player answers "which enemies can
+    // see the player" for all of them at once.
+    class Visibility
+    {
+    public:
+        using ViewerId = std::uint32_t;
+
+        // Forget every viewer (new world).
+        void clear();
+
+        // A viewer that sees radiusTiles far (1 .. MAX_RADIUS). Ids stay
+        // valid until clear().
+        ViewerId addViewer(int radiusTiles);
+
+        // The viewer now stands on (tx, ty) of `map` (which must stay alive
+        // while the viewer is looked up). Cheap, nothing is cast here.
+        void moveViewer(ViewerId viewer, const TileMap& map, int tx, int ty);
+
+        // The viewer's whole field, (re)cast first where it's stale.
+        const VisibilityField& field(ViewerId viewer);
+
+        bool canSee(ViewerId viewer, int tx, int ty);
+        bool canSeePoint(ViewerId viewer, float x, float y)
+        {
+            return canSee(viewer, VisibilityField::tileOf(x), VisibilityField::tileOf(y));
+        }
+
+        const VisibilityStats& stats() const { return m_stats; }
+
+        // Totals to the log.
+        void logSummary() const;
+
+    private:
+        struct Viewer
+        {
+            VisibilityField field;
+            const TileMap* map = nullptr; // where it stands now
+            int tileX = 0;
+            int tileY = 0;
+        };
+
+        // make sure the quadrants in `mask` are cast for where v stands now
+        void cast(Viewer& v, unsigned mask);
+
+        std::vector<Viewer> m_viewers;
+        VisibilityStats m_stats;
+    };
+}
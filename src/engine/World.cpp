@@ -0,0 +1,719 @@
+#include "World.h"
+#include "AllocTracker.h"
+
+#include <cmath>
+#include <cstring>
+
+namespace zelda::game
+{
+    void World::init(const WorldConfig &config)
+    {
+        shutdown();
+
+        m_input = WorldInput{};
+        m_events.clear();
+        m_tick = 0;
+
+        m_ai.configure(config.ai);
+        m_ai.reset();
+        m_visibility.clear();
+        m_playerSight = m_visibility.addViewer(
+            static_cast<int>(std::ceil(config.ai.sightRadiusPx / TileMap::TILE_SIZE)));
+        m_behaviors.stopAll();
+        m_anims.resize(1 + MAX_ENEMIES);
+
+        // camera is the size of the viewport
+        m_camera.width = config.viewWidth;
+        m_camera.height = config.viewHeight;
+
+        // player spawn
+        m_player = Player{};
+        m_player.x = 64.0f;
+        m_player.y = 64.0f;
+
+        // Reserved up front so snapshots can restore without allocating.
+        m_enemies.reserve(MAX_ENEMIES);
+        m_attacks.reserve(MAX_ATTACKS);
+        m_attacks.clear();
+        m_events.reserve(MAX_ENEMIES);
+
+        // enemy placeholder
+        m_enemies.clear();
+        {
+            Enemy enemy;
+            enemy.x = 128.0f;
+            enemy.y = 96.0f;
+            enemy.hp = 3;
+            m_enemies.push_back(enemy);
+        }
+
+        if (config.dungeonSeed != 0)
+        {
+            DungeonConfig dungeon;
+            dungeon.seed = config.dungeonSeed;
+            dungeon.gridW = config.dungeonW;
+            dungeon.gridH = config.dungeonH;
+            dungeon.roomTilesW = config.roomTilesW;
+            dungeon.roomTilesH = config.roomTilesH;
+            m_dungeon = std::make_shared<DungeonGenerator>(dungeon);
+            if (config.pregenerateDungeon)
+                m_dungeon->pregenerate();
+
+            m_rooms.init(dungeon.gridW, dungeon.gridH, DungeonGenerator::loader(m_dungeon),
+                         m_dungeon->startX(), m_dungeon->startY(), config.backgroundLoading);
+            applyRoomSpawns();
+        }
+        else
+        {
+            // create our 2x2 grid of rooms
+            m_dungeon.reset();
+            m_rooms.debugInitRooms(config.roomTilesW, config.roomTilesH, config.backgroundLoading);
+        }
+        resetTriggers();
+
+        // sync camera to current room so camera math is valid
+        followCamera();
+    }
+
+    void World::shutdown()
+    {
+        // stop background room loading
+        m_rooms.shutdown();
+    }
+
+    void World::step(const WorldInput &input)
+    {
+        m_input = input;
+        m_events.clear();
+        m_frameArena.reset();
+        ++m_tick;
+
+        // what's on screen now, to tell if this tick changed any of it
+        const float playerPxX = std::floor(m_player.x), playerPxY = std::floor(m_player.y);
+        const SDL_Rect viewBefore = m_camera.getViewRect();
+        const std::uint64_t animChangesBefore = m_anims.frameChanges();
+        const bool hadAttacks = !m_attacks.empty();
+
+        if (input.attack && m_player.attackCooldown <= 0.0f)
+        {
+            m_player.attacking = true;
+            m_player.attackCooldown = 0.3f;
+            spawnPlayerAttack();
+            m_anims.restart(PLAYER_ANIM_SLOT, AnimClipId::PlayerAttack);
+        }
+
+        // input -> player intent
+        m_player.moveUp = input.up;
+        m_player.moveDown = input.down;
+        m_player.moveLeft = input.left;
+        m_player.moveRight = input.right;
+
+        // movement + collision
+        movePlayerWithCollision(TICK_SEC);
+
+        // load the rooms we're walking towards before we reach the door
+        updatePrefetch();
+
+        // room-to-room transitions
+        handleRoomTransition();
+
+        // attack cooldown
+        if (m_player.attackCooldown > 0.0f)
+        {
+            m_player.attackCooldown -= TICK_SEC;
+            if (m_player.attackCooldown <= 0.0f)
+                m_player.attacking = false;
+        }
+
+        // camera follow & clamp to room
+        followCamera();
+
+        // animations (their ends wake behaviours), then whichever behaviours are due
+        updateAnimations();
+        m_behaviors.tick();
+
+        // the player's view: cast when an enemy first asks, kept while the
+        // player stays on this tile and the walls don't change
+        const TileMap& map = m_rooms.currentMap();
+        m_visibility.moveViewer(m_playerSight, map,
+                                VisibilityField::tileOf(m_player.x + Player::WIDTH * 0.5f),
+                                VisibilityField::tileOf(m_player.y + Player::HEIGHT * 0.5f));
+
+        // enemy brains (budgeted) + steering
+        m_ai.update(m_enemies, map, m_visibility, m_playerSight, m_player.x, m_player.y, m_tick, TICK_SEC,
+                    m_frameArena);
+
+        // attacks + combat
+        updateAttacks(TICK_SEC);
+        handleCombat();
+
+        // sprites draw at whole pixels, so sub-pixel drift doesn't count
+        const SDL_Rect view = m_camera.getViewRect();
+        m_visualChanged = !m_events.empty() || hadAttacks || !m_attacks.empty() ||
+                          std::floor(m_player.x) != playerPxX || std::floor(m_player.y) != playerPxY ||
+                          view.x != viewBefore.x || view.y != viewBefore.y ||
+                          m_anims.frameChanges() != animChangesBefore ||
+                          m_ai.lastTick().pixelSteps > 0;
+    }
+
+    bool World::spawnEnemy(float x, float y, int hp)
+    {
+        return addEnemy(x, y, hp) >= 0;
+    }
+
+    int World::addEnemy(float x, float y, int hp)
+    {
+        Enemy enemy;
+        enemy.x = x;
+        enemy.y = y;
+        enemy.hp = hp;
+
+        for (std::size_t i = 0; i < m_enemies.size(); ++i)
+        {
+            if (m_enemies[i].hp <= 0)
+            {
+                m_enemies[i] = enemy;
+                m_anims.restart(enemyAnimSlot(i), AnimClipId::EnemyIdle);
+                return static_cast<int>(i);
+            }
+        }
+        if (m_enemies.size() >= MAX_ENEMIES)
+            return -1;
+
+        m_enemies.push_back(enemy);
+        m_anims.restart(enemyAnimSlot(m_enemies.size() - 1), AnimClipId::EnemyIdle);
+        return static_cast<int>(m_enemies.size() - 1);
+    }
+
+    Behavior World::ambush(std::uint32_t index)
+    {
+        // m_enemies never reallocates (reserved to MAX_ENEMIES), so the
+        // enemy's position can be watched in place.
+        Enemy &enemy = m_enemies[index];
+
+        // lie in wait: costs nothing until the player could be close
+        co_await m_behaviors.waitInRange(enemy.x, enemy.y, m_player.x, m_player.y, AMBUSH_RANGE_PX,
+                                         m_player.speed * TICK_SEC);
+        if (enemy.hp <= 0 || !enemy.dormant)
+            co_return; // killed in its sleep / slot reused
+
+        // wake up, give the player a moment, then hand over to the AI
+        m_anims.restart(enemyAnimSlot(index), AnimClipId::EnemyWake);
+        co_await m_behaviors.waitSignal(animationEndSignal(index));
+        co_await m_behaviors.waitTicks(WAKE_PAUSE_TICKS);
+        if (enemy.hp <= 0 || !enemy.dormant)
+            co_return;
+
+        enemy.dormant = false;
+        enemy.brain = EnemyBrain{};
+    }
+
+    void World::updateAnimations()
+    {
+        // clip choice from state; play() keeps the phase of a running clip
+        const bool moving = m_player.moveUp || m_player.moveDown || m_player.moveLeft || m_player.moveRight;
+        if (m_anims.clip(PLAYER_ANIM_SLOT) != AnimClipId::PlayerAttack || m_anims.done(PLAYER_ANIM_SLOT))
+            m_anims.play(PLAYER_ANIM_SLOT, moving ? AnimClipId::PlayerWalk : AnimClipId::PlayerIdle);
+
+        for (std::size_t i = 0; i < m_enemies.size(); ++i)
+        {
+            const Enemy &enemy = m_enemies[i];
+            const std::uint32_t slot = enemyAnimSlot(i);
+            if (enemy.dormant)
+            {
+                // the ambush behaviour plays the wake-up itself
+                if (m_anims.clip(slot) != AnimClipId::EnemyWake)
+                    m_anims.play(slot, AnimClipId::EnemyDormant);
+                continue;
+            }
+            m_anims.play(slot, enemy.brain.mode == EnemyMode::Idle ? AnimClipId::EnemyIdle : AnimClipId::EnemyWalk);
+        }
+
+        // everyone moves on a tick in one pass (slots past the last enemy are idle)
+        m_anims.advance(1 + m_enemies.size());
+        for (std::uint32_t slot : m_anims.finished())
+            if (slot != PLAYER_ANIM_SLOT)
+                m_behaviors.signal(animationEndSignal(slot - 1));
+    }
+
+    void World::followCamera()
+    {
+        TileMap &map = m_rooms.currentMap();
+        int mapWidthPx = map.width() * TileMap::TILE_SIZE;
+        int mapHeightPx = map.height() * TileMap::TILE_SIZE;
+        m_camera.follow(m_player.x, m_player.y, mapWidthPx, mapHeightPx);
+    }
+
+    void World::movePlayerWithCollision(float dtSec)
+    {
+        TileMap &map = m_rooms.currentMap();
+
+        SDL_FPoint vel = m_player.computeVelocity();
+        float dx = vel.x * dtSec;
+        float dy = vel.y * dtSec;
+
+        if (dx != 0.0f)
+        {
+            float newX = m_player.x + dx;
+            SDL_Rect rectX{
+                static_cast<int>(newX),
+                static_cast<int>(m_player.y),
+                Player::WIDTH,
+                Player::HEIGHT};
+            if (!map.rectCollidesSolid(rectX))
+                m_player.x = newX;
+        }
+
+        if (dy != 0.0f)
+        {
+            float newY = m_player.y + dy;
+            SDL_Rect rectY{
+                static_cast<int>(m_player.x),
+                static_cast<int>(newY),
+                Player::WIDTH,
+                Player::HEIGHT};
+            if (!map.rectCollidesSolid(rectY))
+                m_player.y = newY;
+        }
+    }
+
+    void World::handleRoomTransition()
+    {
+        // Everyone who can stand in a trigger this tick.
+        // Player is actor 0, enemies are 1..N.
+        ArenaVector<TriggerActor> actors{ArenaAllocator<TriggerActor>(&m_frameArena)};
+        actors.reserve(1 + m_enemies.size());
+        actors.push_back(TriggerActor{
+            PLAYER_ACTOR_ID,
+            SDL_Rect{
+                static_cast<int>(m_player.x),
+                static_cast<int>(m_player.y),
+                Player::WIDTH,
+                Player::HEIGHT}});
+        for (std::size_t i = 0; i < m_enemies.size(); ++i)
+        {
+            if (m_enemies[i].hp > 0)
+                actors.push_back(TriggerActor{static_cast<int>(i) + 1, m_enemies[i].getBounds()});
+        }
+
+        const TriggerTable &table = m_rooms.currentTriggers();
+        const auto &events = m_triggers.update(table, actors.data(), actors.size());
+
+        for (const TriggerEvent &ev : events)
+        {
+            const TriggerDef &def = table.triggers()[ev.trigger];
+
+            // Only doors do something so far; traps / plates / cutscenes
+            // get their events here once they have gameplay.
+            if (def.type == TriggerType::Door &&
+                ev.kind == TriggerEvent::Kind::Enter &&
+                ev.actor == PLAYER_ACTOR_ID)
+            {
+                if (enterRoomThroughDoor(static_cast<RoomDir>(def.param)))
+                    return; // events belong to the room we just left
+            }
+        }
+    }
+
+    bool World::enterRoomThroughDoor(RoomDir dir)
+    {
+        const int tileSize = TileMap::TILE_SIZE;
+
+        int beforeX = m_rooms.roomX();
+        int beforeY = m_rooms.roomY();
+        switch (dir)
+        {
+            case RoomDir::North: m_rooms.goNorth(); break;
+            case RoomDir::South: m_rooms.goSouth(); break;
+            case RoomDir::West:  m_rooms.goWest();  break;
+            case RoomDir::East:  m_rooms.goEast();  break;
+        }
+        if (m_rooms.roomX() == beforeX && m_rooms.roomY() == beforeY)
+            return false; // edge of the dungeon
+
+        TileMap &newMap = m_rooms.currentMap();
+        int newMapWidthPx = newMap.width() * tileSize;
+        int newMapHeightPx = newMap.height() * tileSize;
+
+        // We come in through the door on the opposite wall. Line up with its
+        // gap (doors move around in generated rooms); without one, fall back
+        // to the debug rooms' doorways.
+        RoomDir entry = RoomDir::South;
+        switch (dir)
+        {
+            case RoomDir::North: entry = RoomDir::South; break;
+            case RoomDir::South: entry = RoomDir::North; break;
+            case RoomDir::West:  entry = RoomDir::East;  break;
+            case RoomDir::East:  entry = RoomDir::West;  break;
+        }
+        float doorwayCenterX = 7 * tileSize + 4.0f;
+        float midY = 3 * tileSize + 4.0f;
+        for (const TriggerDef &def : m_rooms.currentTriggers().triggers())
+        {
+            if (def.type == TriggerType::Door && def.param == static_cast<int>(entry))
+            {
+                doorwayCenterX = def.rect.x + (def.rect.w - Player::WIDTH) * 0.5f;
+                midY = def.rect.y + (def.rect.h - Player::HEIGHT) * 0.5f;
+                break;
+            }
+        }
+
+        // Spawn points after walking through a door.
+        const float topEntranceY = tileSize * 2.0f;
+        const float leftEntranceX = tileSize * 2.0f;
+
+        switch (dir)
+        {
+            case RoomDir::North: // enter from south
+                m_player.x = doorwayCenterX;
+                m_player.y = newMapHeightPx - tileSize * 2.0f;
+                break;
+            case RoomDir::South: // enter from north
+                m_player.x = doorwayCenterX;
+                m_player.y = topEntranceY;
+                break;
+            case RoomDir::West: // enter from east
+                m_player.x = newMapWidthPx - tileSize * 2.0f;
+                m_player.y = midY;
+                break;
+            case RoomDir::East: // enter from west
+                m_player.x = leftEntranceX;
+                m_player.y = midY;
+                break;
+        }
+
+        applyRoomSpawns();
+        m_camera.follow(m_player.x, m_player.y, newMapWidthPx, newMapHeightPx);
+
+        // new room, new trigger table: nobody is "inside" anything yet
+        resetTriggers();
+
+        m_events.push_back(WorldEvent{
+            WorldEvent::Type::RoomEntered,
+            static_cast<float>(m_rooms.roomX()),
+            static_cast<float>(m_rooms.roomY())});
+        return true;
+    }
+
+    void World::applyRoomSpawns()
+    {
+        // Generated rooms own their enemies: entering one replaces the enemy
+        // list with its spawns (so they're back on re-entry). The debug rooms
+        // leave the list alone.
+        if (!m_dungeon)
+            return;
+        const ArenaVector<SpawnPoint> &spawns = m_rooms.currentSpawns();
+
+        // the old room's behaviours go with its enemies; starting the new
+        // ones allocates coroutine frames (until the frame pool is warm)
+        AllocAllowScope loading;
+        m_behaviors.stopAll();
+
+        const int tileSize = TileMap::TILE_SIZE;
+        m_enemies.clear();
+        for (const SpawnPoint &spawn : spawns)
+        {
+            const float x = spawn.tx * tileSize + (tileSize - Player::WIDTH) * 0.5f;
+            const float y = spawn.ty * tileSize + (tileSize - Player::HEIGHT) * 0.5f;
+            if (spawn.type == SpawnType::Player)
+            {
+                m_player.x = x;
+                m_player.y = y;
+            }
+            else
+            {
+                const int index = addEnemy(x, y, 3);
+                if (index >= 0 && spawn.type == SpawnType::Ambusher)
+                {
+                    m_enemies[index].dormant = true;
+                    m_behaviors.start(ambush(static_cast<std::uint32_t>(index)));
+                }
+            }
+        }
+    }
+
+    void World::updatePrefetch()
+    {
+        // Install whatever the worker finished since last tick.
+        m_rooms.collectPrefetched();
+
+        SDL_FPoint vel = m_player.computeVelocity();
+        float px = m_player.x + Player::WIDTH * 0.5f;
+        float py = m_player.y + Player::HEIGHT * 0.5f;
+
+        for (const TriggerDef &door : m_rooms.currentTriggers().triggers())
+        {
+            if (door.type != TriggerType::Door)
+                continue;
+
+            int nx, ny;
+            if (!m_rooms.neighbor(static_cast<RoomDir>(door.param), nx, ny) || m_rooms.isLoaded(nx, ny))
+                continue;
+
+            float dx = door.rect.x + door.rect.w * 0.5f - px;
+            float dy = door.rect.y + door.rect.h * 0.5f - py;
+            float dist = SDL_sqrtf(dx * dx + dy * dy);
+
+            // close enough that we could turn around and be there quickly
+            bool nearDoor = dist < PREFETCH_RADIUS_PX;
+
+            // or moving towards it and will arrive soon
+            bool arrivingSoon = false;
+            if (dist > 0.0f)
+            {
+                float approachSpeed = (vel.x * dx + vel.y * dy) / dist; // px/sec towards the door
+                arrivingSoon = approachSpeed > 0.0f && dist / approachSpeed < PREFETCH_LOOKAHEAD_SEC;
+            }
+
+            if (nearDoor || arrivingSoon)
+                m_rooms.prefetch(nx, ny);
+        }
+    }
+
+    std::size_t World::snapshotCapacityBytes() const
+    {
+        const std::size_t roomBits = static_cast<std::size_t>(m_rooms.roomCount());
+        return sizeof(SnapshotHeader)
+             + sizeof(PlayerRecord)
+             + sizeof(CameraRecord)
+             + sizeof(RoomRecord)
+             + (roomBits + 7) / 8
+             + sizeof(std::uint32_t) + MAX_ENEMIES * sizeof(EnemyRecord)
+             + sizeof(std::uint32_t) + MAX_ATTACKS * sizeof(AttackRecord);
+    }
+
+    bool World::saveState(SaveState &out) const
+    {
+        out.beginWrite();
+
+        std::uint32_t flags = 0;
+        if (m_player.moveUp)    flags |= PLAYER_MOVE_UP;
+        if (m_player.moveDown)  flags |= PLAYER_MOVE_DOWN;
+        if (m_player.moveLeft)  flags |= PLAYER_MOVE_LEFT;
+        if (m_player.moveRight) flags |= PLAYER_MOVE_RIGHT;
+        if (m_player.attacking) flags |= PLAYER_ATTACKING;
+        out.write(PlayerRecord{m_player.x, m_player.y, m_player.attackCooldown, flags,
+                               m_anims.packSlot(PLAYER_ANIM_SLOT)});
+
+        out.write(CameraRecord{m_camera.x, m_camera.y, m_camera.width, m_camera.height});
+
+        out.write(RoomRecord{
+            m_rooms.roomX(),
+            m_rooms.roomY(),
+            m_rooms.gridWidth(),
+            m_rooms.gridHeight()});
+
+        // visited bits, 8 rooms per byte
+        const int roomCount = m_rooms.roomCount();
+        for (int base = 0; base < roomCount; base += 8)
+        {
+            std::uint8_t bits = 0;
+            for (int b = 0; b < 8 && base + b < roomCount; ++b)
+                if (m_rooms.isVisited(base + b))
+                    bits |= static_cast<std::uint8_t>(1u << b);
+            out.write(bits);
+        }
+
+        out.write(static_cast<std::uint32_t>(m_enemies.size()));
+        for (std::size_t i = 0; i < m_enemies.size(); ++i)
+        {
+            const Enemy &e = m_enemies[i];
+            out.write(EnemyRecord{e.x, e.y, e.hp,
+                                  static_cast<std::int32_t>(e.brain.mode), e.brain.dirX, e.brain.dirY,
+                                  e.brain.targetX, e.brain.targetY, e.brain.credit, e.brain.modeTicks,
+                                  e.dormant ? ENEMY_DORMANT : 0u, m_anims.packSlot(enemyAnimSlot(i))});
+        }
+
+        out.write(static_cast<std::uint32_t>(m_attacks.size()));
+        for (const auto &a : m_attacks)
+            out.write(AttackRecord{a.rect.x, a.rect.y, a.rect.w, a.rect.h, a.lifetime});
+
+        return out.endWrite();
+    }
+
+    bool World::loadState(const SaveState &in)
+    {
+        // only events raised by this load should be seen afterwards
+        m_events.clear();
+
+        // Validate everything before touching live state, so a bad blob
+        // leaves the game as it was.
+        SaveState::Reader r(in);
+        PlayerRecord player;
+        CameraRecord camera;
+        RoomRecord room;
+        if (!r.readHeader() || !r.read(player) || !r.read(camera) || !r.read(room))
+            return false;
+        if (room.gridW != m_rooms.gridWidth() || room.gridH != m_rooms.gridHeight())
+            return false; // snapshot from a different world
+
+        const int roomCount = m_rooms.roomCount();
+        const std::uint8_t *visited = r.view(static_cast<std::size_t>(roomCount + 7) / 8);
+
+        std::uint32_t enemyCount = 0;
+        if (!visited || !r.read(enemyCount) || enemyCount > m_enemies.capacity())
+            return false;
+        const std::uint8_t *enemyBytes = r.view(enemyCount * sizeof(EnemyRecord));
+
+        std::uint32_t attackCount = 0;
+        if (!enemyBytes || !r.read(attackCount) || attackCount > m_attacks.capacity())
+            return false;
+        const std::uint8_t *attackBytes = r.view(attackCount * sizeof(AttackRecord));
+        if (!attackBytes)
+            return false;
+
+        // --- apply ---
+        if (room.roomX != m_rooms.roomX() || room.roomY != m_rooms.roomY())
+        {
+            if (!m_rooms.restoreRoom(room.roomX, room.roomY))
+                return false;
+            m_events.push_back(WorldEvent{
+                WorldEvent::Type::RoomEntered,
+                static_cast<float>(room.roomX),
+                static_cast<float>(room.roomY)});
+        }
+        for (int i = 0; i < roomCount; ++i)
+            m_rooms.setVisited(i, (visited[i / 8] >> (i % 8)) & 1u);
+
+        m_player.x = player.x;
+        m_player.y = player.y;
+        m_player.attackCooldown = player.attackCooldown;
+        m_player.moveUp    = (player.flags & PLAYER_MOVE_UP) != 0;
+        m_player.moveDown  = (player.flags & PLAYER_MOVE_DOWN) != 0;
+        m_player.moveLeft  = (player.flags & PLAYER_MOVE_LEFT) != 0;
+        m_player.moveRight = (player.flags & PLAYER_MOVE_RIGHT) != 0;
+        m_player.attacking = (player.flags & PLAYER_ATTACKING) != 0;
+        m_anims.unpackSlot(PLAYER_ANIM_SLOT, player.anim);
+
+        m_camera.x = camera.x;
+        m_camera.y = camera.y;
+        m_camera.width = camera.width;
+        m_camera.height = camera.height;
+
+        // capacity was checked above: these resizes don't allocate
+        m_enemies.resize(enemyCount);
+        for (std::uint32_t i = 0; i < enemyCount; ++i)
+        {
+            EnemyRecord rec;
+            std::memcpy(&rec, enemyBytes + i * sizeof(rec), sizeof(rec));
+            m_enemies[i].x = rec.x;
+            m_enemies[i].y = rec.y;
+            m_enemies[i].hp = rec.hp;
+            m_enemies[i].brain = EnemyBrain{
+                static_cast<EnemyMode>(rec.mode), rec.dirX, rec.dirY,
+                rec.targetX, rec.targetY, rec.credit, rec.modeTicks};
+            m_enemies[i].dormant = (rec.flags & ENEMY_DORMANT) != 0;
+            m_anims.unpackSlot(enemyAnimSlot(i), rec.anim);
+        }
+
+        // Coroutine state isn't in the snapshot: dormant enemies restart
+        // their ambush from the top (a half-played wake-up plays again).
+        // Frames come from the behaviour frame pool, so rewinding every
+        // tick doesn't allocate once it's warm.
+        m_behaviors.stopAll();
+        {
+            AllocAllowScope restarting;
+            for (std::uint32_t i = 0; i < enemyCount; ++i)
+                if (m_enemies[i].dormant && m_enemies[i].hp > 0)
+                    m_behaviors.start(ambush(i));
+        }
+
+        m_attacks.clear();
+        for (std::uint32_t i = 0; i < attackCount; ++i)
+        {
+            AttackRecord rec;
+            std::memcpy(&rec, attackBytes + i * sizeof(rec), sizeof(rec));
+            m_attacks.emplace_back(rec.x, rec.y, rec.w, rec.h);
+            m_attacks.back().lifetime = rec.lifetime;
+        }
+
+        // trigger overlaps are re-derived next tick
+        resetTriggers();
+        m_visualChanged = true;
+        return true;
+    }
+
+    void World::resetTriggers()
+    {
+        m_triggers.reset();
+
+        // room change is a load: sizing for the new table may allocate
+        AllocAllowScope loading;
+        m_triggers.reserve(1 + MAX_ENEMIES, m_rooms.currentTriggers().size());
+    }
+
+    void World::spawnPlayerAttack()
+    {
+        const int range = 18;
+        int ax = static_cast<int>(m_player.x);
+        int ay = static_cast<int>(m_player.y);
+        int w = 12, h = 12;
+
+        if (m_input.up)
+            ay -= range;
+        else if (m_input.down)
+            ay += Player::HEIGHT;
+        else if (m_input.left)
+            ax -= range;
+        else if (m_input.right)
+            ax += Player::WIDTH;
+        else
+            ay += Player::HEIGHT;
+
+        // hitboxes only live 0.15s, so the cap is never hit in normal play
+        if (m_attacks.size() < MAX_ATTACKS)
+            m_attacks.emplace_back(ax, ay, w, h);
+
+        m_events.push_back(WorldEvent{
+            WorldEvent::Type::PlayerAttack,
+            static_cast<float>(ax + w / 2),
+            static_cast<float>(ay + h / 2)});
+    }
+
+    void World::updateAttacks(float dtSec)
+    {
+        for (auto &atk : m_attacks)
+            atk.lifetime -= dtSec;
+
+        m_attacks.erase(
+            std::remove_if(
+                m_attacks.begin(),
+                m_attacks.end(),
+                [](const PlayerAttack &a)
+                {
+                    return a.isExpired();
+                }),
+            m_attacks.end());
+    }
+
+    void World::handleCombat()
+    {
+        for (auto &enemy : m_enemies)
+        {
+            if (enemy.hp <= 0)
+                continue;
+
+            for (auto &atk : m_attacks)
+            {
+                SDL_Rect eRect = enemy.getBounds();
+                if (SDL_HasIntersection(&atk.rect, &eRect))
+                {
+                    float cx = enemy.x + Enemy::WIDTH * 0.5f;
+                    float cy = enemy.y + Enemy::HEIGHT * 0.5f;
+
+                    enemy.hp--;
+
+                    m_events.push_back(WorldEvent{WorldEvent::Type::EnemyHit, cx, cy});
+
+                    if (enemy.hp <= 0)
+                    {
+                        m_events.push_back(WorldEvent{WorldEvent::Type::EnemyKilled, cx, cy});
+                        enemy.x = -1000.0f;
+                        enemy.y = -1000.0f;
+                    }
+                    break;
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,289 @@
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+
+#include "RoomManager.h"
+#include "DungeonGenerator.h"
+#include "AiScheduler.h"
+#include "BehaviorScheduler.h"
+#include "SpriteAnimation.h"
+#include "TileMap.h"
+#include "Camera.h"
+#include "TriggerSystem.h"
+#include "Visibility.h"
+#include "SaveState.h"
+#include "Arena.h"
+
+namespace zelda::game {
+
+    struct PlayerAttack {
+        SDL_Rect rect;
+        float lifetime;
+        PlayerAttack(int x,int y,int w,int h)
+        {
+            rect = {x,y,w,h};
+            lifetime = 0.15f;
+        }
+        bool isExpired() const { return lifetime <= 0.0f; }
+    };
+
+    struct Player {
+        static constexpr int WIDTH  = 14;
+        static constexpr int HEIGHT = 14;
+
+        float x = 0.f;
+        float y = 0.f;
+
+        bool moveUp = false;
+        bool moveDown = false;
+        bool moveLeft = false;
+        bool moveRight = false;
+
+        bool attacking = false;
+        float attackCooldown = 0.0f;
+
+        float speed = 80.0f; // px/sec
+
+        SDL_FPoint computeVelocity() const
+        {
+            float vx = 0.f;
+            float vy = 0.f;
+            if (moveUp)    vy -= 1.f;
+            if (moveDown)  vy += 1.f;
+            if (moveLeft)  vx -= 1.f;
+            if (moveRight) vx += 1.f;
+
+            float mag2 = vx*vx + vy*vy;
+            if (mag2 > 1.0f)
+            {
+                float invMag = 1.0f / SDL_sqrtf(mag2);
+                vx *= invMag;
+                vy *= invMag;
+            }
+
+            vx *= speed;
+            vy *= speed;
+
+            SDL_FPoint out{vx, vy};
+            return out;
+        }
+    };
+
+    enum class EnemyMode : std::int32_t {
+        Idle = 0,
+        Patrol, // walking a short leg in brain.dirX / dirY
+        Chase,  // sees the player
+        Search  // lost sight, heading for where the player was last seen
+    };
+
+    // Decided by AiScheduler's think(), followed by its per-tick steering.
+    struct EnemyBrain {
+        EnemyMode mode = EnemyMode::Idle;
+        float dirX = 0.f;            // patrol heading
+        float dirY = 0.f;
+        float targetX = 0.f;         // last place the player was seen
+        float targetY = 0.f;
+        float credit = 1.0f;         // thinks once this reaches 1 (new enemies think right away)
+        std::int32_t modeTicks = 0;  // idle / patrol ticks left
+    };
+
+    struct Enemy {
+        static constexpr int WIDTH  = 14;
+        static constexpr int HEIGHT = 14;
+
+        static constexpr float WALK_SPEED  = 40.0f; // px/sec
+        static constexpr float CHASE_SPEED = 55.0f;
+
+        float x = 0.f;
+        float y = 0.f;
+        int hp = 3;
+
+        EnemyBrain brain;
+
+        // Driven by a behaviour (see World::ambush) instead of the AI
+        // scheduler: no thinking, no steering.
+        bool dormant = false;
+
+        SDL_Rect getBounds() const
+        {
+            return SDL_Rect{
+                static_cast<int>(x),
+                static_cast<int>(y),
+                WIDTH,
+                HEIGHT
+            };
+        }
+    };
+
+    // One tick worth of player intent (keyboard, AI agent, fuzzer, ...).
+    struct WorldInput {
+        bool up     = false;
+        bool down   = false;
+        bool left   = false;
+        bool right  = false;
+        bool attack = false;
+    };
+
+    // Things that happened during a step which the presentation side
+    // (particles, sound, texture loading) wants to react to.
+    struct WorldEvent {
+        enum class Type : int {
+            PlayerAttack = 0,
+            EnemyHit,
+            EnemyKilled,
+            RoomEntered
+        };
+
+        Type type;
+        float x; // map pixels (room coords for RoomEntered)
+        float y;
+    };
+
+    struct WorldConfig {
+        int roomTilesW = 10;
+        int roomTilesH = 8;
+
+        // camera viewport in pixels
+        int viewWidth  = 640;
+        int viewHeight = 480;
+
+        // Run the neighbour-room prefetch thread. Batch runs turn this off:
+        // hundreds of worlds shouldn't mean hundreds of loader threads.
+        bool backgroundLoading = true;
+
+        // Procedural dungeon (DungeonGenerator) of dungeonW x dungeonH rooms.
+        // Seed 0 keeps the 2x2 debug rooms. Rooms are generated as the
+        // player gets near them, or all up front (on every core) with
+        // pregenerateDungeon.
+        std::uint64_t dungeonSeed = 0;
+        int dungeonW = 100;
+        int dungeonH = 100;
+        bool pregenerateDungeon = false;
+
+        // enemy think budget (AiScheduler)
+        AiConfig ai;
+    };
+
+    // The whole game simulation.
+    //
+    // No window, no renderer, no SDL_Init and no globals: everything a
+    // game instance needs lives in here, so any number of worlds can be
+    // stepped side by side (see BatchRunner). Engine owns one and draws it.
+    class World
+    {
+    public:
+        static constexpr float TICK_SEC = 1.0f / 60.0f;
+
+        static constexpr std::size_t MAX_ENEMIES = 1024;
+        static constexpr std::size_t MAX_ATTACKS = 32;
+
+        World() = default;
+        ~World() { shutdown(); }
+
+        World(const World&) = delete;
+        World& operator=(const World&) = delete;
+
+        void init(const WorldConfig& config);
+        void shutdown();
+
+        // Advance one fixed tick.
+        void step(const WorldInput& input);
+
+        // Put another enemy in (scenarios / tools). Reuses dead slots;
+        // false once MAX_ENEMIES are alive.
+        bool spawnEnemy(float x, float y, int hp = 3);
+
+        // read access for rendering / tools
+        const Player& player() const                      { return m_player; }
+        const std::vector<Enemy>& enemies() const         { return m_enemies; }
+        const std::vector<PlayerAttack>& attacks() const  { return m_attacks; }
+        const Camera& camera() const                      { return m_camera; }
+        RoomManager& rooms()                              { return m_rooms; }
+        const DungeonGenerator* dungeon() const           { return m_dungeon.get(); }
+        const AiScheduler& ai() const                     { return m_ai; }
+        const Visibility& visibility() const              { return m_visibility; }
+        const BehaviorScheduler& behaviors() const        { return m_behaviors; }
+
+        // current animation frames (SpriteAnimation.h)
+        const AnimFrame& playerFrame() const              { return m_anims.frame(PLAYER_ANIM_SLOT); }
+        const AnimFrame& enemyFrame(std::size_t i) const  { return m_anims.frame(enemyAnimSlot(i)); }
+        const RoomManager& rooms() const                  { return m_rooms; }
+
+        // events raised by the last step() / loadState()
+        const std::vector<WorldEvent>& events() const { return m_events; }
+
+        std::uint64_t tick() const { return m_tick; }
+
+        // Did the last step() / loadState() change anything that gets drawn
+        // (whole-pixel moves, camera, animation frames, attacks, events)?
+        // A renderer can skip frames while this stays false.
+        bool visualChanged() const { return m_visualChanged; }
+
+        // allocator stats (level arena is rooms().levelArena())
+        const Arena& frameArena() const { return m_frameArena; }
+
+        // whole-game snapshot (quicksave, room retry, rewind)
+        bool saveState(SaveState &out) const;
+        bool loadState(const SaveState &in);
+        std::size_t snapshotCapacityBytes() const;
+
+    private:
+        void movePlayerWithCollision(float dtSec);
+        void handleRoomTransition();
+        bool enterRoomThroughDoor(RoomDir dir);
+        void updatePrefetch();
+        void spawnPlayerAttack();
+        void updateAttacks(float dtSec);
+        void handleCombat();
+        void followCamera();
+        void resetTriggers();
+        void applyRoomSpawns();
+        int addEnemy(float x, float y, int hp);
+
+        // coroutine behaviours (BehaviorScheduler)
+        Behavior ambush(std::uint32_t enemy);
+        static std::uint64_t animationEndSignal(std::uint32_t enemy) { return (1ull << 32) | enemy; }
+
+        static constexpr float AMBUSH_RANGE_PX = 3.0f * TileMap::TILE_SIZE;
+        static constexpr int WAKE_PAUSE_TICKS = 12;
+
+        // sprite animation: pick clips from state, advance all, fire
+        // animationEndSignal for enemies whose one-shot clip ended
+        void updateAnimations();
+        static constexpr std::uint32_t PLAYER_ANIM_SLOT = 0;
+        static std::uint32_t enemyAnimSlot(std::size_t i) { return static_cast<std::uint32_t>(i + 1); }
+
+        // neighbour-room prefetch tuning
+        static constexpr float PREFETCH_RADIUS_PX     = 5.0f * TileMap::TILE_SIZE;
+        static constexpr float PREFETCH_LOOKAHEAD_SEC = 1.0f;
+
+        static constexpr int PLAYER_ACTOR_ID = 0;
+
+        WorldInput m_input; // this tick's input
+
+        Player m_player;
+        std::vector<Enemy> m_enemies;
+        Camera m_camera;
+        std::vector<PlayerAttack> m_attacks;
+
+        RoomManager   m_rooms;
+        std::shared_ptr<DungeonGenerator> m_dungeon; // null for the debug rooms
+        TriggerSystem m_triggers;
+        AiScheduler   m_ai;
+        Visibility    m_visibility;
+        Visibility::ViewerId m_playerSight = 0; // what the player sees (aggro, fog of war)
+        BehaviorScheduler m_behaviors;
+        SpriteAnimator m_anims; // slot 0 = player, 1 + i = enemy i
+
+        // scratch for one step(), reset at the start of every tick
+        Arena m_frameArena{"frame", 16 * 1024};
+
+        std::vector<WorldEvent> m_events;
+        std::uint64_t m_tick = 0;
+        bool m_visualChanged = true;
+    };
+}
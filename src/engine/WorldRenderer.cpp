@@ -0,0 +1,78 @@
+#include "WorldRenderer.h"
+
+#include <cmath>
+
+namespace zelda::game
+{
+    void recordWorld(RenderQueue& queue, SpriteBatch& sprites, World& world, ParticleSystem* particles,
+                     SDL_Texture* tilesTex, SDL_Texture* spritesTex)
+    {
+        const Camera &camera = world.camera();
+        const Player &player = world.player();
+
+        TileMap &map = world.rooms().currentMap();
+        SDL_Rect view = camera.getViewRect();
+
+        const int tileSize = TileMap::TILE_SIZE;
+        int mapPxW = map.width() * tileSize;
+        int mapPxH = map.height() * tileSize;
+
+        // Center the map in the view if it's smaller
+        int offsetX = (mapPxW < camera.width) ? (camera.width - mapPxW) / 2 : 0;
+        int offsetY = (mapPxH < camera.height) ? (camera.height - mapPxH) / 2 : 0;
+
+        // draw tilemap (floor + decoration under entities)
+        // Tilesheet assumptions: one 16px cell per tile id
+        // [0,0]-[15,15]   = floor (id 0)
+        // [16,0]-[31,15]  = wall  (id 1)
+        map.renderLayer(queue, DrawLayer::Floor, tilesTex, TileLayer::Floor, view, offsetX, offsetY);
+        map.renderLayer(queue, DrawLayer::Decoration, tilesTex, TileLayer::Decoration, view, offsetX, offsetY);
+
+        // enemies + player go through the sprite batch: one geometry call
+        // per layer (and texture) however many there are
+        sprites.begin();
+        const SDL_Color white{255, 255, 255, 255};
+        auto addSprite = [&](DrawLayer layer, float x, float y, int w, int h, const AnimFrame &frame)
+        {
+            // 16px cell centred on the collision box
+            const SDL_FRect dst{
+                x - static_cast<float>(view.x + (frame.src.w - w) / 2 - offsetX),
+                y - static_cast<float>(view.y + (frame.src.h - h) / 2 - offsetY),
+                static_cast<float>(frame.src.w),
+                static_cast<float>(frame.src.h)};
+            sprites.add(layer, spritesTex, frame.src, dst, spritesTex ? white : frame.fallback);
+        };
+
+        const std::vector<Enemy> &enemies = world.enemies();
+        for (std::size_t i = 0; i < enemies.size(); ++i)
+        {
+            if (enemies[i].hp <= 0)
+                continue;
+            addSprite(DrawLayer::Enemies, std::floor(enemies[i].x), std::floor(enemies[i].y),
+                      Enemy::WIDTH, Enemy::HEIGHT, world.enemyFrame(i));
+        }
+
+        // draw attack hitboxes (translucent yellow boxes)
+        for (const auto &atk : world.attacks())
+        {
+            SDL_Rect r{
+                atk.rect.x - view.x + offsetX,
+                atk.rect.y - view.y + offsetY,
+                atk.rect.w,
+                atk.rect.h};
+
+            queue.fillRect(DrawLayer::Attacks, r, SDL_Color{255, 255, 0, 180}, SDL_BLENDMODE_BLEND);
+        }
+
+        // draw particles (one batched geometry call)
+        if (particles)
+            particles->render(queue, DrawLayer::Particles, offsetX - view.x, offsetY - view.y);
+
+        addSprite(DrawLayer::Player, std::floor(player.x), std::floor(player.y),
+                  Player::WIDTH, Player::HEIGHT, world.playerFrame());
+        sprites.submit(queue);
+
+        // overlay layer goes on top of everything in the room
+        map.renderLayer(queue, DrawLayer::Overlay, tilesTex, TileLayer::Overlay, view, offsetX, offsetY);
+    }
+}
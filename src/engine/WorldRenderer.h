@@ -0,0 +1,24 @@
+#pragma once
+#include <SDL2/SDL.h>
+
+#include "World.h"
+#include "ParticleSystem.h"
+#include "RenderQueue.h"
+#include "SpriteBatch.h"
+
+namespace zelda::game
+{
+    // Record one frame of the world into `queue`: tile layers, enemies,
+    // attack boxes, particles (optional) and the player, in view space
+    // with the room centred when it's smaller than the camera.
+    //
+    // Enemies and the player are animated sprites from spritesTex (flat
+    // colours without it), batched through `sprites`; its vertices must
+    // stay alive until the queue is flushed.
+    //
+    // The queue must have been begin()-ed; flushing is up to the caller.
+    // The game and the headless perf harness both draw through this, so
+    // what gets measured is what gets shown.
+    void recordWorld(RenderQueue& queue, SpriteBatch& sprites, World& world, ParticleSystem* particles,
+                     SDL_Texture* tilesTex, SDL_Texture* spritesTex);
+}
@@ -1,12 +1,17 @@
 #include <SDL2/SDL.h>
+#include <cstdlib>
 #include "engine/Engine.h"
+#include "engine/Log.h"
 
-int main(int, char**)
+// zelda_like [seed]: a seed plays a generated 100x100 room dungeon
+int main(int argc, char** argv)
 {
     zelda::engine::Engine engine;
+    if (argc > 1)
+        engine.setDungeonSeed(std::strtoull(argv[1], nullptr, 10));
     if (!engine.init("Milestone 8", 640, 480, false))
     {
-        SDL_Log("Engine.init() failed");
+        ZLOG_ERROR("Engine.init() failed");
         return 1;
     }
 